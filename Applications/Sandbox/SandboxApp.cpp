@@ -1,5 +1,6 @@
 #include "SandboxApp.hpp"
 
+#include <Core/JobSystem.hpp>
 #include <Core/Timer.hpp>
 
 #include <Debug/Log.hpp>
@@ -10,14 +11,20 @@
 
 #include <Platform/Window.hpp>
 
+#include <Vendor/glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+
 Sandbox::Sandbox()
 {
+    Engine::Core::JobSystem::Init();
     Engine::Platform::Window::Init({ .Title = "Sandbox", .Width = 1920, .Height = 1080 });
 }
 
 Sandbox::~Sandbox()
 {
     Engine::Platform::Window::Shutdown();
+    Engine::Core::JobSystem::Shutdown();
 }
 
 void Sandbox::Run()
@@ -28,17 +35,38 @@ void Sandbox::Run()
     // Initialize renderer
     Engine::Graphics::VulkanRenderer vkRenderer;
 
-    // Load shader
-    const Engine::u32 vertexID =
-        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eVertex, "Applications/Sandbox/Shaders/Vert.spv");
-    const Engine::u32 fragmentID =
-        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eFragment, "Applications/Sandbox/Shaders/Frag.spv");
-
-    // Create pipeline
-    const Engine::u32 pipelineID = vkRenderer.CreatePipeline(vertexID, fragmentID);
-
-    // Load mesh
-    const Engine::Graphics::Mesh cowMesh = Engine::Graphics::ObjLoader::LoadMeshFromFile(
+    // Load shader (compiled on first use, edits get picked up while running)
+    const Engine::Graphics::ShaderHandle vertexShader =
+        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eVertex, "Applications/Sandbox/Shaders/Vert.glsl");
+    const Engine::Graphics::ShaderHandle fragmentShader =
+        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eFragment, "Applications/Sandbox/Shaders/Frag.glsl");
+    const Engine::Graphics::ShaderHandle depthShader = vkRenderer.LoadShader(
+        vk::ShaderStageFlagBits::eVertex, "Applications/Sandbox/Shaders/Vert.glsl", { "DEPTH_PREPASS" });
+    const Engine::Graphics::ShaderHandle cullShader =
+        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eCompute, "Applications/Sandbox/Shaders/Cull.glsl");
+    const Engine::Graphics::ShaderHandle pyramidShader =
+        vkRenderer.LoadShader(vk::ShaderStageFlagBits::eCompute, "Applications/Sandbox/Shaders/DepthPyramid.glsl");
+
+    // Cull and draw the scene on the GPU, occlusion culled once the depth pre-pass runs (the compute pipelines keep
+    // no reference to their shaders)
+    vkRenderer.EnableGpuCulling(cullShader, pyramidShader);
+    vkRenderer.DestroyShader(cullShader);
+    vkRenderer.DestroyShader(pyramidShader);
+
+    // Lay down depth first so the main pass only shades visible fragments
+    vkRenderer.EnableDepthPrepass(depthShader);
+
+    // Create pipeline (16 byte vertices with quantized positions), it compiles while the meshes load
+    const Engine::Graphics::VertexFormat   vertexFormat = Engine::Graphics::VertexFormat::eCompact;
+    const Engine::Graphics::PipelineHandle pipeline     = vkRenderer.CreatePipeline(
+        vertexShader,
+        fragmentShader,
+        vertexFormat,
+        [&timer](Engine::Graphics::PipelineHandle)
+        { LOG_PERF("Scene pipeline was ready after {} ...", timer.GetEngineTotalRuntimeString()); });
+
+    // Load mesh (binary cache gets written on first load and mapped afterwards)
+    const Engine::Graphics::MappedMesh cowMesh = Engine::Graphics::ObjLoader::LoadCachedMesh(
         "Applications/Sandbox/Models/cow.obj", Engine::Graphics::Color::RANDOMIZE);
 
     // Create 'hello_world_triangle' mesh
@@ -55,12 +83,21 @@ void Sandbox::Run()
     };
 
     // Create models from meshes
-    const Engine::u32 cowModel      = vkRenderer.CreateModel(&cowMesh);
-    const Engine::u32 triangleModel = vkRenderer.CreateModel(&triangleMesh);
+    const Engine::Graphics::ModelHandle cowModel      = vkRenderer.CreateModel(cowMesh.GetView(), vertexFormat);
+    const Engine::Graphics::ModelHandle triangleModel = vkRenderer.CreateModel(triangleMesh.GetView(), vertexFormat);
 
     // Assign models to pipeline
-    vkRenderer.AssignModelToPipeline(cowModel, pipelineID);
-    vkRenderer.AssignModelToPipeline(triangleModel, pipelineID);
+    vkRenderer.AssignModelToPipeline(cowModel, pipeline);
+    vkRenderer.AssignModelToPipeline(triangleModel, pipeline);
+
+    // Herd of cows on a grid reaching past the view frustum, the transforms get rebuilt every frame
+    constexpr Engine::i32  herdSize  = 16;
+    constexpr Engine::f32  cowScale  = 0.25f;
+    constexpr Engine::f32  cowSpread = 3.0f;
+    std::vector<glm::mat4> cowTransforms(herdSize * herdSize);
+
+    // Single object, its transform only ever lives in push constants
+    const glm::mat4 triangleTransform = glm::mat4(1.0f);
 
     // Log startup time
     LOG_PERF("Engine startup time was {} ...", timer.GetEngineTotalRuntimeString());
@@ -77,7 +114,7 @@ void Sandbox::Run()
             continue;
         }
 
-        auto frame = vkRenderer.BeginFrame(pipelineID);
+        auto frame = vkRenderer.BeginFrame(pipeline);
 
         // Check if frame can't be rendered
         if (!frame.IsValid())
@@ -88,6 +125,24 @@ void Sandbox::Run()
 
         // If frame is valid, tick timer and draw it
         timer.Tick();
+
+        // Spin every cow around the up axis, all of them get culled and drawn without a draw call per cow
+        const Engine::f32 angle = (Engine::f32)timer.GetFrameTiming().TotalSeconds * glm::radians(90.0f);
+        for (Engine::i32 y = 0; y < herdSize; y++)
+        {
+            for (Engine::i32 x = 0; x < herdSize; x++)
+            {
+                const glm::vec3 position(
+                    (Engine::f32)(x - (herdSize / 2)) * cowSpread, (Engine::f32)(y - (herdSize / 2)) * cowSpread, 0.0f);
+                const glm::mat4 translation = glm::translate(glm::mat4(1.0f), position);
+                const glm::mat4 rotation    = glm::rotate(translation, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+
+                cowTransforms[(y * herdSize) + x] = glm::scale(rotation, glm::vec3(cowScale));
+            }
+        }
+
+        vkRenderer.DrawInstances(cowModel, cowTransforms);
+        vkRenderer.DrawModel(triangleModel, triangleTransform);
         vkRenderer.DrawFrame(frame, timer.GetFrameTiming());
     }
 
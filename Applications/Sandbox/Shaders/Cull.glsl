@@ -0,0 +1,199 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Has to match GPU_CULLING_WORKGROUP_SIZE, GPU_CULLING_MAX_LODS and GPU_CULLING_DRAW_GROUPS
+layout(local_size_x = 64) in;
+
+#define MAX_LODS 4
+#define DRAW_GROUPS 2
+
+// Passes of the culling dispatch, the late one tests against the depth pyramid of the early draws
+#define PASS_FRUSTUM 0
+#define PASS_EARLY 1
+#define PASS_LATE 2
+
+// Draw counts of both phases, followed by the number of occluded objects
+#define OCCLUDED_COUNT (2 * DRAW_GROUPS)
+
+struct Lod {
+    uint indexOffset;
+    uint indexCount;
+    float error;
+    uint padding;
+};
+
+// Mirrors GpuObject
+struct Object {
+    vec4 sphere; // World space center and radius
+    uint firstIndex;
+    int vertexOffset;
+    uint instance;
+    uint lodCount;
+    uint drawGroup;
+    uint commandOffset;
+    uint padding0;
+    uint padding1;
+    Lod lods[MAX_LODS];
+};
+
+// Mirrors vk::DrawIndexedIndirectCommand
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(set = 0, binding = 0) readonly buffer Objects {
+    Object objects[];
+};
+
+layout(set = 0, binding = 1) writeonly buffer DrawCommands {
+    DrawCommand commands[];
+};
+
+layout(set = 0, binding = 2) buffer DrawCounts {
+    uint counts[];
+};
+
+layout(set = 0, binding = 3) uniform GlobalUniformData {
+    mat4 view;
+    mat4 proj;
+} globals;
+
+// Whether an object passed the last occlusion test, indexed like the objects
+layout(set = 0, binding = 4) buffer Visibility {
+    uint visibility[];
+};
+
+// Farthest depth per texel, level 0 spans the whole screen
+layout(set = 0, binding = 5) uniform sampler2D depthPyramid;
+
+// Mirrors GpuCullingParameters
+layout(push_constant) uniform Parameters {
+    vec4 frustumPlanes[6];
+    vec4 cameraPosition; // xyz: position, w: pixels per world unit at distance 1
+    uint objectCount;
+    float cameraNear;
+    float lodErrorThreshold;
+    uint pass;
+} params;
+
+bool IsInsideFrustum(vec4 sphere)
+{
+    for (uint i = 0; i < 6; i++) {
+        vec4 plane = params.frustumPlanes[i];
+        if (dot(plane.xyz, sphere.xyz) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Projects the box around the sphere onto the screen and compares its nearest depth with the farthest depth of the
+// pyramid texels it covers. Boxes reaching in front of the near plane always count as visible.
+bool IsOccluded(vec4 sphere)
+{
+    mat4 viewProjection = globals.proj * globals.view;
+
+    vec2 minUv = vec2(1.0);
+    vec2 maxUv = vec2(0.0);
+    float nearest = 1.0;
+    for (uint i = 0; i < 8; i++) {
+        vec3 corner = vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProjection * vec4(sphere.xyz + corner * sphere.w, 1.0);
+        if (clip.w <= params.cameraNear) {
+            return false;
+        }
+
+        vec3 ndc = clip.xyz / clip.w;
+        minUv = min(minUv, ndc.xy * 0.5 + 0.5);
+        maxUv = max(maxUv, ndc.xy * 0.5 + 0.5);
+        nearest = min(nearest, ndc.z);
+    }
+
+    minUv = clamp(minUv, 0.0, 1.0);
+    maxUv = clamp(maxUv, 0.0, 1.0);
+
+    // The level where the rectangle covers at most 2x2 texels
+    vec2 pixels = (maxUv - minUv) * vec2(textureSize(depthPyramid, 0));
+    int level = int(ceil(log2(max(max(pixels.x, pixels.y), 1.0))));
+    level = min(level, textureQueryLevels(depthPyramid) - 1);
+
+    ivec2 levelSize = textureSize(depthPyramid, level);
+    ivec2 first = clamp(ivec2(minUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+    ivec2 last = clamp(ivec2(maxUv * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+    float farthest = 0.0;
+    for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+            farthest = max(farthest, texelFetch(depthPyramid, ivec2(x, y), level).r);
+        }
+    }
+
+    return nearest > farthest;
+}
+
+void Emit(Object object, uint phase)
+{
+    // Coarsest level whose error stays below the threshold once projected onto the screen
+    float distance = max(length(object.sphere.xyz - params.cameraPosition.xyz) - object.sphere.w, params.cameraNear);
+    uint lod = 0;
+    for (uint i = object.lodCount - 1; i > 0; i--) {
+        if (object.lods[i].error * params.cameraPosition.w / distance <= params.lodErrorThreshold) {
+            lod = i;
+            break;
+        }
+    }
+
+    // Compact the survivors of every draw group into its command range, every phase has ranges for all objects
+    uint slot = atomicAdd(counts[phase * DRAW_GROUPS + object.drawGroup], 1);
+    uint command = phase * params.objectCount + object.commandOffset + slot;
+    commands[command] = DrawCommand(object.lods[lod].indexCount,
+                                    1,
+                                    object.firstIndex + object.lods[lod].indexOffset,
+                                    object.vertexOffset,
+                                    object.instance);
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= params.objectCount) {
+        return;
+    }
+
+    Object object = objects[index];
+    bool inside = IsInsideFrustum(object.sphere);
+
+    // Without a depth pyramid every object inside the frustum gets drawn, the next early pass starts from them
+    if (params.pass == PASS_FRUSTUM) {
+        visibility[index] = inside ? 1 : 0;
+        if (inside) {
+            Emit(object, 0);
+        }
+        return;
+    }
+
+    // Objects visible last frame get drawn right away, their depth makes up the pyramid
+    if (params.pass == PASS_EARLY) {
+        if (inside && visibility[index] != 0) {
+            Emit(object, 0);
+        }
+        return;
+    }
+
+    // Everything gets tested again, only objects which weren't drawn by the early pass yet get drawn now
+    bool occluded = inside && IsOccluded(object.sphere);
+    bool drawn = visibility[index] != 0;
+    visibility[index] = inside && !occluded ? 1 : 0;
+
+    if (occluded && !drawn) {
+        atomicAdd(counts[OCCLUDED_COUNT], 1);
+    }
+    if (inside && !occluded && !drawn) {
+        Emit(object, 1);
+    }
+}
@@ -0,0 +1,34 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Has to match DEPTH_PYRAMID_WORKGROUP_SIZE
+layout(local_size_x = 8, local_size_y = 8) in;
+
+// Level above (the depth image for level 0) and the level being written
+layout(set = 0, binding = 0) uniform sampler2D source;
+layout(set = 0, binding = 1, r32f) uniform writeonly image2D destination;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destinationSize = imageSize(destination);
+    if (any(greaterThanEqual(texel, destinationSize))) {
+        return;
+    }
+
+    // Every source texel the destination texel overlaps, 2x2 between power of two levels and up to 3x3 when level 0
+    // shrinks the depth image
+    ivec2 sourceSize = textureSize(source, 0);
+    ivec2 first = texel * sourceSize / destinationSize;
+    ivec2 last = min(((texel + 1) * sourceSize + destinationSize - 1) / destinationSize, sourceSize);
+
+    // Keep the farthest depth, anything behind it is hidden for the whole area
+    float depth = 0.0;
+    for (int y = first.y; y < last.y; y++) {
+        for (int x = first.x; x < last.x; x++) {
+            depth = max(depth, texelFetch(source, ivec2(x, y), 0).r);
+        }
+    }
+
+    imageStore(destination, texel, vec4(depth));
+}
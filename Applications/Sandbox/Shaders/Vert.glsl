@@ -2,19 +2,36 @@
 #pragma shader_stage(vertex)
 
 layout(set = 0, binding = 0) uniform GlobalUniformData {
-    mat4 model;
     mat4 view;
     mat4 proj;
 } ubo;
 
+// Mirrors DrawPushConstants, identity for instanced draws
+layout(push_constant) uniform DrawConstants {
+    mat4 model;
+} draw;
+
 layout(location = 0) in vec3 inPosition;
+#ifndef DEPTH_PREPASS
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
+#endif
 
+// Per-instance model matrix (occupies locations 3 to 6), also maps compressed positions back into model space
+layout(location = 3) in mat4 inModel;
+
+#ifndef DEPTH_PREPASS
 layout(location = 0) out vec3 fragColor;
+#endif
+
+// The depth pre-pass compiles this shader with DEPTH_PREPASS defined, both variants have to produce the exact same
+// depth for the main pass to pass its equal test
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * draw.model * inModel * vec4(inPosition, 1.0);
+#ifndef DEPTH_PREPASS
     fragColor = inColor;
+#endif
 }
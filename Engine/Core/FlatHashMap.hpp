@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Core/Hash.hpp"
+#include "Core/Types.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <vector>
+
+namespace Engine::Core
+{
+    // Insert-only hash map with open addressing and linear probing. Keys and values live in one flat array, so
+    // there is no allocation per entry. A control byte per slot stores 7 bits of the hash, which rejects most
+    // mismatching slots without touching the key. Keys get hashed and compared by their bits by default, which keeps
+    // both consistent for floating point members (+0.0f and -0.0f are different keys).
+    template <typename Key, typename Value, typename Hasher = BitwiseHash<Key>, typename KeyEqual = BitwiseEqual<Key>>
+    class FlatHashMap
+    {
+    public:
+        struct Slot
+        {
+            Key   First;
+            Value Second;
+        };
+
+        struct InsertResult
+        {
+            Value& Entry;
+            b8     Inserted;
+        };
+
+        FlatHashMap() = default;
+
+        // Pre-sizes the table, so that 'expectedCount' entries fit without rehashing
+        explicit FlatHashMap(u64 expectedCount) { Reserve(expectedCount); }
+
+        void Reserve(u64 expectedCount)
+        {
+            // Keep the load factor at or below 3/4
+            const u64 capacity = std::bit_ceil(std::max<u64>(MIN_CAPACITY, expectedCount + (expectedCount / 3) + 1));
+            if (capacity > m_Control.size())
+            {
+                Rehash(capacity);
+            }
+        }
+
+        // Single probe sequence for lookup and insertion. Returns the stored value and whether it was just inserted.
+        InsertResult FindOrInsert(const Key& key, const Value& value)
+        {
+            if ((m_Size + 1) * 4 > m_Control.size() * 3)
+            {
+                Rehash(std::max<u64>(MIN_CAPACITY, m_Control.size() * 2));
+            }
+
+            const u64 hash    = m_Hasher(key);
+            const u8  control = GetControl(hash);
+            const u64 mask    = m_Control.size() - 1;
+
+            for (u64 index = hash & mask;; index = (index + 1) & mask)
+            {
+                if (m_Control[index] == EMPTY)
+                {
+                    m_Control[index] = control;
+                    m_Slots[index]   = { key, value };
+                    m_Size++;
+                    return { m_Slots[index].Second, true };
+                }
+
+                if (m_Control[index] == control && m_Equal(m_Slots[index].First, key))
+                {
+                    return { m_Slots[index].Second, false };
+                }
+            }
+        }
+
+        [[nodiscard]] const Value* Find(const Key& key) const
+        {
+            if (m_Size == 0)
+            {
+                return nullptr;
+            }
+
+            const u64 hash    = m_Hasher(key);
+            const u8  control = GetControl(hash);
+            const u64 mask    = m_Control.size() - 1;
+
+            for (u64 index = hash & mask; m_Control[index] != EMPTY; index = (index + 1) & mask)
+            {
+                if (m_Control[index] == control && m_Equal(m_Slots[index].First, key))
+                {
+                    return &m_Slots[index].Second;
+                }
+            }
+
+            return nullptr;
+        }
+
+        [[nodiscard]] b8 Contains(const Key& key) const { return Find(key) != nullptr; }
+
+        void Clear()
+        {
+            std::fill(m_Control.begin(), m_Control.end(), EMPTY);
+            m_Size = 0;
+        }
+
+        [[nodiscard]] u64 GetSize() const { return m_Size; }
+        [[nodiscard]] u64 GetCapacity() const { return m_Control.size(); }
+
+    private:
+        static constexpr u64 MIN_CAPACITY = 16;
+        static constexpr u8  EMPTY        = 0;
+
+        // Top 7 bits of the hash with the highest bit set, so a control byte never equals EMPTY.
+        // The low bits already select the slot.
+        static u8 GetControl(u64 hash) { return (u8)(0x80u | (hash >> 57)); }
+
+        void Rehash(u64 capacity)
+        {
+            ASSERT(std::has_single_bit(capacity), "FlatHashMap capacity needs to be a power of two!");
+
+            std::vector<u8>   oldControl = std::move(m_Control);
+            std::vector<Slot> oldSlots   = std::move(m_Slots);
+
+            m_Control.assign(capacity, EMPTY);
+            m_Slots.resize(capacity);
+
+            const u64 mask = capacity - 1;
+
+            for (u64 i = 0; i < oldControl.size(); i++)
+            {
+                if (oldControl[i] == EMPTY)
+                {
+                    continue;
+                }
+
+                u64 index = m_Hasher(oldSlots[i].First) & mask;
+                while (m_Control[index] != EMPTY)
+                {
+                    index = (index + 1) & mask;
+                }
+
+                m_Control[index] = oldControl[i];
+                m_Slots[index]   = std::move(oldSlots[i]);
+            }
+        }
+
+        std::vector<u8>   m_Control;
+        std::vector<Slot> m_Slots;
+        u64               m_Size = 0;
+
+        [[no_unique_address]] Hasher   m_Hasher;
+        [[no_unique_address]] KeyEqual m_Equal;
+    };
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace Engine::Core
+{
+    namespace Detail
+    {
+        // wyhash constants
+        inline constexpr u64 HASH_SECRET_0 = 0xa0761d6478bd642full;
+        inline constexpr u64 HASH_SECRET_1 = 0xe7037ed1a0b428dbull;
+        inline constexpr u64 HASH_SECRET_2 = 0x8ebc6af09c88c6e3ull;
+
+        // 64x64 -> 128 bit multiplication, folded back to 64 bits
+        inline u64 MultiplyMix(u64 a, u64 b)
+        {
+#ifdef _MSC_VER
+            u64 high;
+            const u64 low = _umul128(a, b, &high);
+            return low ^ high;
+#else
+            __extension__ using u128 = unsigned __int128; // Silences -Wpedantic
+            const u128 product        = (u128)a * b;
+            return (u64)product ^ (u64)(product >> 64);
+#endif
+        }
+
+        inline u64 Read64(const u8* data)
+        {
+            u64 value;
+            std::memcpy(&value, data, sizeof(u64));
+            return value;
+        }
+
+        inline u64 Read32(const u8* data)
+        {
+            u32 value;
+            std::memcpy(&value, data, sizeof(u32));
+            return value;
+        }
+    }
+
+    // wyhash-style hash over raw bytes. Every input bit affects all output bits, which open addressing relies on.
+    inline u64 HashBytes(const void* data, u64 size, u64 seed = 0)
+    {
+        const auto* bytes = (const u8*)data;
+
+        seed ^= Detail::MultiplyMix(seed ^ Detail::HASH_SECRET_0, Detail::HASH_SECRET_1);
+
+        u64 a = 0;
+        u64 b = 0;
+
+        if (size <= 16)
+        {
+            if (size >= 4)
+            {
+                // Two (possibly overlapping) reads from each end cover 4 to 16 bytes
+                const u64 offset = (size >> 3) << 2;
+                a = (Detail::Read32(bytes) << 32) | Detail::Read32(bytes + offset);
+                b = (Detail::Read32(bytes + size - 4) << 32) | Detail::Read32(bytes + size - 4 - offset);
+            }
+            else if (size > 0)
+            {
+                a = ((u64)bytes[0] << 16) | ((u64)bytes[size >> 1] << 8) | bytes[size - 1];
+            }
+        }
+        else
+        {
+            u64 remaining = size;
+
+            for (; remaining > 16; remaining -= 16, bytes += 16)
+            {
+                seed = Detail::MultiplyMix(Detail::Read64(bytes) ^ Detail::HASH_SECRET_1,
+                                           Detail::Read64(bytes + 8) ^ seed);
+            }
+
+            // Last 16 bytes (may overlap with the previous block)
+            a = Detail::Read64(bytes + remaining - 16);
+            b = Detail::Read64(bytes + remaining - 8);
+        }
+
+        a ^= Detail::HASH_SECRET_1;
+        b ^= seed;
+
+        return Detail::MultiplyMix(Detail::HASH_SECRET_0 ^ size, Detail::MultiplyMix(a, b) ^ Detail::HASH_SECRET_2);
+    }
+
+    // Hashes the object representation. Only suited for types without padding bytes.
+    template <typename T>
+    struct BitwiseHash
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "BitwiseHash requires a trivially copyable type!");
+
+        u64 operator()(const T& value) const { return HashBytes(&value, sizeof(T)); }
+    };
+
+    // Compares the object representation, so that equality stays consistent with BitwiseHash
+    // (e.g. +0.0f and -0.0f are different keys)
+    template <typename T>
+    struct BitwiseEqual
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "BitwiseEqual requires a trivially copyable type!");
+
+        bool operator()(const T& lhs, const T& rhs) const { return std::memcmp(&lhs, &rhs, sizeof(T)) == 0; }
+    };
+}
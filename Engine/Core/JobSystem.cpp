@@ -0,0 +1,385 @@
+#include "JobSystem.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // ----- Internal -----
+
+    struct JobEntry
+    {
+        Engine::Core::Job               Function;
+        Engine::Core::JobCounter*       Counter    = nullptr;
+        const Engine::Core::JobCounter* Dependency = nullptr;
+    };
+
+    // The owning worker pushes and pops at the back, thieves take from the front
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex           Mutex;
+        std::deque<JobEntry> Jobs;
+    };
+
+    std::vector<std::thread> s_Threads;
+    std::deque<WorkerQueue>  s_Queues;
+    std::mutex               s_WaitingMutex;
+    std::vector<JobEntry>    s_WaitingJobs; // Dependency not done yet, not part of the pending jobs
+    std::thread              s_BackgroundThread;
+    std::mutex               s_BackgroundMutex;
+    std::condition_variable  s_BackgroundCondition;
+    std::deque<JobEntry>     s_BackgroundJobs;
+    std::mutex               s_SleepMutex;
+    std::condition_variable  s_SleepCondition;
+    std::atomic<Engine::u32> s_PendingJobs = 0;
+    std::atomic<bool>        s_Running     = false;
+    thread_local Engine::u32 s_WorkerIndex = 0;
+    thread_local Engine::u32 s_RandomState = 0x9E3779B9u;
+
+    Engine::u32 NextRandom()
+    {
+        // xorshift32
+        s_RandomState ^= s_RandomState << 13;
+        s_RandomState ^= s_RandomState >> 17;
+        s_RandomState ^= s_RandomState << 5;
+        return s_RandomState;
+    }
+
+    void PushJob(Engine::u32 queueIndex, JobEntry&& entry)
+    {
+        s_PendingJobs.fetch_add(1, std::memory_order_release);
+
+        {
+            WorkerQueue&          queue = s_Queues[queueIndex];
+            const std::lock_guard lock(queue.Mutex);
+            queue.Jobs.push_back(std::move(entry));
+        }
+
+        // Briefly take the sleep mutex, so a worker can't miss the notification between its check and its wait
+        {
+            const std::lock_guard lock(s_SleepMutex);
+        }
+        s_SleepCondition.notify_one();
+    }
+
+    // Queues the job right away if its dependency is done, otherwise it waits until the dependency's last job finished
+    void SubmitJob(Engine::u32 queueIndex, JobEntry&& entry)
+    {
+        if (entry.Dependency != nullptr)
+        {
+            // Checked under the lock, so the dependency can't finish between the check and the job getting parked
+            const std::lock_guard lock(s_WaitingMutex);
+            if (!entry.Dependency->IsDone())
+            {
+                s_WaitingJobs.push_back(std::move(entry));
+                return;
+            }
+        }
+
+        PushJob(queueIndex, std::move(entry));
+    }
+
+    // Called after the counter dropped to zero, queues every job waiting on it
+    void ReleaseWaitingJobs(const Engine::Core::JobCounter* counter)
+    {
+        std::vector<JobEntry> released;
+
+        {
+            const std::lock_guard lock(s_WaitingMutex);
+
+            // A new counter may live at the address of a finished one, so only release jobs whose dependency is done
+            const auto waiting = std::ranges::partition(s_WaitingJobs,
+                                                        [counter](const JobEntry& entry)
+                                                        {
+                                                            return entry.Dependency != counter
+                                                                   || !entry.Dependency->IsDone();
+                                                        });
+
+            released.assign(std::make_move_iterator(waiting.begin()), std::make_move_iterator(waiting.end()));
+            s_WaitingJobs.erase(waiting.begin(), waiting.end());
+        }
+
+        for (JobEntry& entry : released)
+        {
+            PushJob(s_WorkerIndex, std::move(entry));
+        }
+    }
+
+    void FinishJob(const JobEntry& entry)
+    {
+        // The last job of a counter hands the jobs depending on it to the workers
+        if (entry.Counter != nullptr && entry.Counter->Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            ReleaseWaitingJobs(entry.Counter);
+        }
+    }
+
+    bool PopJob(JobEntry& entry)
+    {
+        // Own queue first (LIFO keeps the caches warm)
+        {
+            WorkerQueue&          queue = s_Queues[s_WorkerIndex];
+            const std::lock_guard lock(queue.Mutex);
+            if (!queue.Jobs.empty())
+            {
+                entry = std::move(queue.Jobs.back());
+                queue.Jobs.pop_back();
+                return true;
+            }
+        }
+
+        // Steal from a random victim and walk through all others from there (FIFO takes the oldest, largest work)
+        const auto        queueCount = (Engine::u32)s_Queues.size();
+        const Engine::u32 start      = NextRandom() % queueCount;
+
+        for (Engine::u32 i = 0; i < queueCount; i++)
+        {
+            const Engine::u32 victim = (start + i) % queueCount;
+            if (victim == s_WorkerIndex)
+            {
+                continue;
+            }
+
+            WorkerQueue&          queue = s_Queues[victim];
+            const std::lock_guard lock(queue.Mutex);
+            if (!queue.Jobs.empty())
+            {
+                entry = std::move(queue.Jobs.front());
+                queue.Jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool RunPendingJob()
+    {
+        JobEntry entry;
+        if (!PopJob(entry))
+        {
+            return false;
+        }
+
+        s_PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+        entry.Function();
+        FinishJob(entry);
+
+        return true;
+    }
+
+    // Released dependents go to the queue of worker 0 (the thread's default index), where any worker can steal them
+    void BackgroundLoop()
+    {
+        while (true)
+        {
+            JobEntry entry;
+
+            {
+                std::unique_lock lock(s_BackgroundMutex);
+                s_BackgroundCondition.wait(lock,
+                                           []
+                                           {
+                                               return !s_BackgroundJobs.empty()
+                                                      || !s_Running.load(std::memory_order_acquire);
+                                           });
+
+                if (s_BackgroundJobs.empty())
+                {
+                    return;
+                }
+
+                entry = std::move(s_BackgroundJobs.front());
+                s_BackgroundJobs.pop_front();
+            }
+
+            entry.Function();
+            FinishJob(entry);
+        }
+    }
+
+    void WorkerLoop(Engine::u32 workerIndex)
+    {
+        s_WorkerIndex = workerIndex;
+        s_RandomState = 0x9E3779B9u * (workerIndex + 1);
+
+        while (s_Running.load(std::memory_order_acquire))
+        {
+            if (RunPendingJob())
+            {
+                continue;
+            }
+
+            // Nothing to do: Sleep until new jobs arrive or the system shuts down
+            std::unique_lock lock(s_SleepMutex);
+            s_SleepCondition.wait(lock,
+                                  []
+                                  {
+                                      return s_PendingJobs.load(std::memory_order_acquire) > 0
+                                             || !s_Running.load(std::memory_order_acquire);
+                                  });
+        }
+    }
+}
+
+namespace Engine::Core
+{
+    // ----- Public -----
+
+    void JobSystem::Init(u32 workerCount)
+    {
+        ASSERT(!IsInitialized(), "JobSystem was already initialized!");
+
+        if (workerCount == 0)
+        {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // One queue per worker, index 0 belongs to the calling thread
+        s_Queues.resize(workerCount);
+        s_WorkerIndex = 0;
+        s_Running.store(true, std::memory_order_release);
+
+        for (u32 i = 1; i < workerCount; i++)
+        {
+            s_Threads.emplace_back(&WorkerLoop, i);
+        }
+
+        s_BackgroundThread = std::thread(&BackgroundLoop);
+
+        LOG_INFO("Initialized job system ... (Workers: {}, Threads: {})", workerCount, s_Threads.size());
+    }
+
+    void JobSystem::Shutdown()
+    {
+        ASSERT(IsInitialized(), "JobSystem wasn't initialized!");
+        ASSERT(s_PendingJobs.load(std::memory_order_acquire) == 0 && s_WaitingJobs.empty(),
+               "JobSystem got shut down with pending jobs!");
+
+        {
+            const std::lock_guard lock(s_SleepMutex);
+            const std::lock_guard backgroundLock(s_BackgroundMutex);
+            ASSERT(s_BackgroundJobs.empty(), "JobSystem got shut down with pending background jobs!");
+            s_Running.store(false, std::memory_order_release);
+        }
+        s_SleepCondition.notify_all();
+        s_BackgroundCondition.notify_all();
+
+        for (auto& thread : s_Threads)
+        {
+            thread.join();
+        }
+        s_BackgroundThread.join();
+
+        s_Threads.clear();
+        s_Queues.clear();
+
+        LOG_INFO("Shut down job system ...");
+    }
+
+    void JobSystem::Execute(Job job, JobCounter* counter, const JobCounter* dependency)
+    {
+        if (!IsInitialized())
+        {
+            ASSERT(dependency == nullptr || dependency->IsDone(), "Dependency can't be fulfilled without workers!");
+            job();
+            return;
+        }
+
+        // Without another worker only a Wait would ever pick the job up
+        if (GetWorkerCount() == 1 && (dependency == nullptr || dependency->IsDone()))
+        {
+            job();
+            return;
+        }
+
+        if (counter != nullptr)
+        {
+            counter->Value.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        SubmitJob(s_WorkerIndex, { .Function = std::move(job), .Counter = counter, .Dependency = dependency });
+    }
+
+    void JobSystem::ExecuteBackground(Job job, JobCounter* counter)
+    {
+        if (!IsInitialized())
+        {
+            job();
+            return;
+        }
+
+        if (counter != nullptr)
+        {
+            counter->Value.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        {
+            const std::lock_guard lock(s_BackgroundMutex);
+            s_BackgroundJobs.push_back({ .Function = std::move(job), .Counter = counter });
+        }
+        s_BackgroundCondition.notify_one();
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!IsInitialized() || !RunPendingJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(u64 begin, u64 end, u64 grain, const std::function<void(u64, u64)>& fn)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        grain = std::max<u64>(grain, 1);
+
+        // Not worth the overhead or no workers available
+        if (!IsInitialized() || GetWorkerCount() == 1 || end - begin <= grain)
+        {
+            fn(begin, end);
+            return;
+        }
+
+        JobCounter counter;
+
+        // Submit all ranges except the first one, which gets processed by the calling thread
+        for (u64 rangeBegin = begin + grain; rangeBegin < end; rangeBegin += grain)
+        {
+            const u64 rangeEnd = std::min(rangeBegin + grain, end);
+            Execute([&fn, rangeBegin, rangeEnd] { fn(rangeBegin, rangeEnd); }, &counter);
+        }
+
+        fn(begin, std::min(begin + grain, end));
+        Wait(counter);
+    }
+
+    [[nodiscard]] b8 JobSystem::IsInitialized()
+    {
+        return s_Running.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] u32 JobSystem::GetWorkerCount()
+    {
+        return IsInitialized() ? (u32)s_Queues.size() : 1;
+    }
+
+    [[nodiscard]] u32 JobSystem::GetWorkerIndex()
+    {
+        return s_WorkerIndex;
+    }
+}
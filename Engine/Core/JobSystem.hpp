@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <atomic>
+#include <functional>
+
+namespace Engine::Core
+{
+    using Job = std::function<void()>;
+
+    // Counts outstanding jobs. Gets incremented on submission and decremented once a job has finished.
+    // Can be waited on and used as a dependency for other jobs.
+    struct JobCounter
+    {
+        std::atomic<u32> Value = 0;
+
+        [[nodiscard]] b8 IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+    };
+
+    class JobSystem
+    {
+    public:
+        JobSystem() = delete;
+
+        // Spawns the worker threads and the background thread. A worker count of 0 uses one worker per remaining
+        // hardware thread. The calling thread becomes worker 0 and helps out while waiting.
+        static void Init(u32 workerCount = 0);
+
+        // Joins all worker threads. All submitted jobs need to be finished at this point.
+        static void Shutdown();
+
+        // Pushes a job onto the queue of the calling worker. Idle workers steal from the other end of the queue.
+        // With a dependency the job only gets queued once the last job of the dependency finished.
+        // Runs the job inline if the job system wasn't initialized or has no other worker to hand it to.
+        static void Execute(Job job, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr);
+
+        // Queues long running work (e.g. pipeline compilations) for the background thread, which runs it in
+        // submission order. Waiting never picks these jobs up, so they can't stall a frame that waits for its own
+        // jobs. Runs the job inline if the job system wasn't initialized.
+        static void ExecuteBackground(Job job, JobCounter* counter = nullptr);
+
+        // Blocks until the counter reached zero and executes pending jobs in the meantime
+        static void Wait(const JobCounter& counter);
+
+        // Splits [begin, end) into ranges of at most 'grain' elements and calls fn(rangeBegin, rangeEnd) for each
+        // of them across all workers. Returns after all ranges have been processed.
+        static void ParallelFor(u64 begin, u64 end, u64 grain, const std::function<void(u64, u64)>& fn);
+
+        [[nodiscard]] static b8  IsInitialized();
+        [[nodiscard]] static u32 GetWorkerCount();
+        [[nodiscard]] static u32 GetWorkerIndex();
+    };
+}
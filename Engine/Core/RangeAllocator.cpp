@@ -0,0 +1,118 @@
+#include "RangeAllocator.hpp"
+
+#include "Debug/Log.hpp"
+
+namespace Engine::Core
+{
+    // ----- Public -----
+
+    RangeAllocator::RangeAllocator(u64 capacity) : m_Capacity(capacity)
+    {
+        if (capacity > 0)
+        {
+            InsertFreeRange(0, capacity);
+        }
+    }
+
+    RangeAllocation RangeAllocator::Allocate(u64 size, u64 alignment)
+    {
+        ASSERT(size > 0, "Can't allocate an empty range!");
+        ASSERT(alignment > 0, "Alignment has to be at least 1!");
+
+        const auto alignUp = [alignment](u64 offset) { return ((offset + alignment - 1) / alignment) * alignment; };
+
+        // Best fit if its start can be aligned without running out of space, otherwise the smallest range which fits
+        // any alignment of its start, so at most two lookups are needed
+        auto range = m_FreeBySize.lower_bound({ size, 0 });
+        if (range != m_FreeBySize.end() && alignUp(range->second) - range->second + size > range->first)
+        {
+            range = m_FreeBySize.lower_bound({ size + alignment - 1, 0 });
+        }
+
+        if (range == m_FreeBySize.end())
+        {
+            return {};
+        }
+
+        const auto [rangeSize, rangeOffset] = *range;
+
+        const u64 offset  = alignUp(rangeOffset);
+        const u64 padding = offset - rangeOffset;
+
+        EraseFreeRange(m_FreeByOffset.find(rangeOffset));
+
+        // Keep the alignment gap in front and the remainder behind the allocation
+        if (padding > 0)
+        {
+            InsertFreeRange(rangeOffset, padding);
+        }
+
+        if (padding + size < rangeSize)
+        {
+            InsertFreeRange(offset + size, rangeSize - padding - size);
+        }
+
+        m_UsedSize += size;
+        return { .Offset = offset, .Size = size };
+    }
+
+    void RangeAllocator::Free(const RangeAllocation& allocation)
+    {
+        if (!allocation.IsValid())
+        {
+            return;
+        }
+
+        ASSERT(allocation.Offset + allocation.Size <= m_Capacity, "Range doesn't belong to this allocator!");
+
+        u64 offset = allocation.Offset;
+        u64 size   = allocation.Size;
+
+        // Merge with the free range behind
+        auto next = m_FreeByOffset.lower_bound(offset);
+        ASSERT(next == m_FreeByOffset.end() || next->first >= offset + size, "Range got freed twice!");
+
+        if (next != m_FreeByOffset.end() && next->first == offset + size)
+        {
+            size += next->second;
+            EraseFreeRange(next);
+        }
+
+        // Merge with the free range in front
+        auto previous = m_FreeByOffset.lower_bound(offset);
+        if (previous != m_FreeByOffset.begin())
+        {
+            --previous;
+            ASSERT(previous->first + previous->second <= offset, "Range got freed twice!");
+
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                size += previous->second;
+                EraseFreeRange(previous);
+            }
+        }
+
+        InsertFreeRange(offset, size);
+        m_UsedSize -= allocation.Size;
+    }
+
+    u64 RangeAllocator::GetLargestFreeRange() const
+    {
+        return m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first;
+    }
+
+    // ----- Private -----
+
+    void RangeAllocator::InsertFreeRange(u64 offset, u64 size)
+    {
+        m_FreeByOffset.emplace(offset, size);
+        m_FreeBySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::EraseFreeRange(std::map<u64, u64>::iterator range)
+    {
+        m_FreeBySize.erase({ range->second, range->first });
+        m_FreeByOffset.erase(range);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <map>
+#include <set>
+#include <utility>
+
+namespace Engine::Core
+{
+    struct RangeAllocation
+    {
+        static constexpr u64 INVALID_OFFSET = UINT64_MAX;
+
+        u64 Offset = INVALID_OFFSET;
+        u64 Size   = 0;
+
+        [[nodiscard]] b8 IsValid() const { return Offset != INVALID_OFFSET; }
+    };
+
+    // Hands out ranges of an externally owned resource (e.g. a large GPU buffer). Free ranges are kept in a
+    // best-fit free list, neighboring free ranges get merged on release. All operations are O(log n), so an aligned
+    // allocation may skip a smaller range whose aligned start would still have fit.
+    class RangeAllocator
+    {
+    public:
+        explicit RangeAllocator(u64 capacity);
+
+        // Offset is a multiple of the alignment (which doesn't need to be a power of two).
+        // Returns an invalid allocation if no free range is large enough.
+        [[nodiscard]] RangeAllocation Allocate(u64 size, u64 alignment = 1);
+        void                          Free(const RangeAllocation& allocation);
+
+        [[nodiscard]] u64 GetCapacity() const { return m_Capacity; }
+        [[nodiscard]] u64 GetUsedSize() const { return m_UsedSize; }
+        [[nodiscard]] u64 GetFreeRangeCount() const { return m_FreeByOffset.size(); }
+        [[nodiscard]] u64 GetLargestFreeRange() const;
+
+    private:
+        void InsertFreeRange(u64 offset, u64 size);
+        void EraseFreeRange(std::map<u64, u64>::iterator range);
+
+        std::map<u64, u64>            m_FreeByOffset; // Offset -> size, for merging neighbors
+        std::set<std::pair<u64, u64>> m_FreeBySize;   // (Size, offset), for best-fit lookups
+
+        u64 m_Capacity = 0;
+        u64 m_UsedSize = 0;
+    };
+}
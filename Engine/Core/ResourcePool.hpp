@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace Engine::Core
+{
+    // Typed reference into a ResourcePool. The generation tells a handle to a destroyed resource apart from one to
+    // a newer resource which reuses the same slot.
+    template <typename T>
+    struct Handle
+    {
+        static constexpr u32 INVALID_INDEX = UINT32_MAX;
+
+        u32 Index      = INVALID_INDEX;
+        u32 Generation = 0;
+
+        [[nodiscard]] b8 IsValid() const { return Index != INVALID_INDEX; }
+
+        friend b8 operator==(const Handle&, const Handle&) = default;
+    };
+
+    // Generational slot map. Resources live densely packed in one array (removal moves the last one into the gap),
+    // handles point to a slot which knows the current dense position. Create, remove and lookup are O(1), freed
+    // slots get reused and stale handles are detected instead of silently aliasing a newer resource.
+    // The tag types the handles, e.g. a pool of Scope<Foo> can hand out Handle<Foo>.
+    template <typename T, typename Tag = T>
+    class ResourcePool
+    {
+    public:
+        using HandleType = Handle<Tag>;
+
+        ResourcePool() = default;
+
+        // Pre-sizes the storage, so that 'expectedCount' resources fit without reallocating
+        explicit ResourcePool(u32 expectedCount) { Reserve(expectedCount); }
+
+        void Reserve(u32 expectedCount)
+        {
+            m_Dense.reserve(expectedCount);
+            m_DenseToSlot.reserve(expectedCount);
+            m_Slots.reserve(expectedCount);
+        }
+
+        template <typename... Args>
+        [[nodiscard]] HandleType Create(Args&&... args)
+        {
+            u32 slotIndex = m_FreeSlot;
+
+            if (slotIndex == HandleType::INVALID_INDEX)
+            {
+                // No free slot left, the generation of a new slot starts at 1 so default handles never match
+                slotIndex = (u32)m_Slots.size();
+                m_Slots.push_back({ .DenseIndex = 0, .Generation = 1 });
+            }
+            else
+            {
+                // Free slots link to the next free one through their dense index
+                m_FreeSlot = m_Slots[slotIndex].DenseIndex;
+            }
+
+            m_Slots[slotIndex].DenseIndex = (u32)m_Dense.size();
+            m_Dense.emplace_back(std::forward<Args>(args)...);
+            m_DenseToSlot.push_back(slotIndex);
+
+            return { .Index = slotIndex, .Generation = m_Slots[slotIndex].Generation };
+        }
+
+        // Moves the resource out of the pool, so the caller decides when it actually gets destroyed
+        [[nodiscard]] T Remove(HandleType handle)
+        {
+            ASSERT(Contains(handle), "Tried to remove a stale or invalid handle (Index: {})!", handle.Index);
+
+            Slot&     slot       = m_Slots[handle.Index];
+            const u32 denseIndex = slot.DenseIndex;
+            T         removed    = std::move(m_Dense[denseIndex]);
+
+            // Fill the gap with the last resource
+            const u32 lastIndex = (u32)m_Dense.size() - 1;
+            if (denseIndex != lastIndex)
+            {
+                m_Dense[denseIndex]                           = std::move(m_Dense[lastIndex]);
+                m_DenseToSlot[denseIndex]                     = m_DenseToSlot[lastIndex];
+                m_Slots[m_DenseToSlot[denseIndex]].DenseIndex = denseIndex;
+            }
+
+            m_Dense.pop_back();
+            m_DenseToSlot.pop_back();
+
+            // Invalidate all handles to this slot and put it on the free list
+            slot.Generation++;
+            slot.DenseIndex = m_FreeSlot;
+            m_FreeSlot      = handle.Index;
+
+            return removed;
+        }
+
+        [[nodiscard]] b8 Contains(HandleType handle) const
+        {
+            return handle.Index < m_Slots.size() && m_Slots[handle.Index].Generation == handle.Generation;
+        }
+
+        // Returns nullptr for stale or invalid handles
+        [[nodiscard]] T* Get(HandleType handle)
+        {
+            return Contains(handle) ? &m_Dense[m_Slots[handle.Index].DenseIndex] : nullptr;
+        }
+
+        [[nodiscard]] const T* Get(HandleType handle) const
+        {
+            return Contains(handle) ? &m_Dense[m_Slots[handle.Index].DenseIndex] : nullptr;
+        }
+
+        // Handle of the resource at a dense position, e.g. while iterating over all resources
+        [[nodiscard]] HandleType GetHandle(u32 denseIndex) const
+        {
+            const u32 slotIndex = m_DenseToSlot[denseIndex];
+            return { .Index = slotIndex, .Generation = m_Slots[slotIndex].Generation };
+        }
+
+        [[nodiscard]] u32 GetSize() const { return (u32)m_Dense.size(); }
+        [[nodiscard]] u32 GetSlotCount() const { return (u32)m_Slots.size(); }
+        [[nodiscard]] b8  IsEmpty() const { return m_Dense.empty(); }
+
+        // Iterates densely over all resources, order changes when resources get removed
+        [[nodiscard]] auto begin() { return m_Dense.begin(); }
+        [[nodiscard]] auto end() { return m_Dense.end(); }
+        [[nodiscard]] auto begin() const { return m_Dense.begin(); }
+        [[nodiscard]] auto end() const { return m_Dense.end(); }
+
+    private:
+        struct Slot
+        {
+            u32 DenseIndex = 0; // Position in the dense array while alive, next free slot while free
+            u32 Generation = 0;
+        };
+
+        std::vector<T>    m_Dense;
+        std::vector<u32>  m_DenseToSlot;
+        std::vector<Slot> m_Slots;
+
+        u32 m_FreeSlot = HandleType::INVALID_INDEX;
+    };
+}
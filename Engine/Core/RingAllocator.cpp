@@ -0,0 +1,82 @@
+#include "RingAllocator.hpp"
+
+#include "Debug/Log.hpp"
+
+namespace Engine::Core
+{
+    // ----- Public -----
+
+    RingAllocator::RingAllocator(u64 capacity) : m_Capacity(capacity)
+    {
+    }
+
+    RangeAllocation RingAllocator::Allocate(u64 size, u64 alignment)
+    {
+        ASSERT(size > 0, "Can't allocate an empty range!");
+        ASSERT(alignment > 0, "Alignment has to be at least 1!");
+
+        if (size > m_Capacity || m_UsedSize == m_Capacity)
+        {
+            return {};
+        }
+
+        // Start over at the beginning once nothing is in use anymore
+        if (m_UsedSize == 0)
+        {
+            m_Head = 0;
+            m_Tail = 0;
+        }
+
+        u64 offset = ((m_Head + alignment - 1) / alignment) * alignment;
+        u64 end    = m_Capacity;
+
+        if (m_Head < m_Tail)
+        {
+            // Already wrapped, the free space ends at the tail
+            end = m_Tail;
+        }
+        else if (offset + size > m_Capacity)
+        {
+            // Not enough space left in front of the end, skip it and continue at the beginning
+            offset = 0;
+            end    = m_Tail;
+        }
+
+        if (offset + size > end)
+        {
+            return {};
+        }
+
+        // Padding is either the alignment gap or the skipped tail of the ring
+        const u64 padding = offset >= m_Head ? offset - m_Head : m_Capacity - m_Head;
+
+        m_UsedSize += padding + size;
+        m_OpenSize += padding + size;
+        m_Head = offset + size;
+
+        return { .Offset = offset, .Size = size };
+    }
+
+    void RingAllocator::Close(u64 fence)
+    {
+        if (m_OpenSize == 0)
+        {
+            return;
+        }
+
+        ASSERT(m_Regions.empty() || m_Regions.back().Fence <= fence, "Fence values have to increase monotonically!");
+
+        m_Regions.push_back({ .End = m_Head, .Size = m_OpenSize, .Fence = fence });
+        m_OpenSize = 0;
+    }
+
+    void RingAllocator::Release(u64 completedFence)
+    {
+        while (!m_Regions.empty() && m_Regions.front().Fence <= completedFence)
+        {
+            m_Tail = m_Regions.front().End;
+            m_UsedSize -= m_Regions.front().Size;
+            m_Regions.pop_front();
+        }
+    }
+}
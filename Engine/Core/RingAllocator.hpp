@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Core/RangeAllocator.hpp"
+#include "Core/Types.hpp"
+
+#include <deque>
+
+namespace Engine::Core
+{
+    // Hands out ranges of an externally owned circular resource (e.g. a persistently mapped staging buffer).
+    // Allocations are grouped into regions which get closed with a fence value (e.g. a timeline semaphore value)
+    // and become reusable in submission order once that value has been reached.
+    class RingAllocator
+    {
+    public:
+        explicit RingAllocator(u64 capacity);
+
+        // Ranges never wrap around the end of the ring, the skipped tail counts as used until the region is released.
+        // Returns an invalid allocation if the ring doesn't have enough contiguous space left.
+        [[nodiscard]] RangeAllocation Allocate(u64 size, u64 alignment = 1);
+
+        // Tags all allocations since the last close with the fence value that signals their last use
+        void Close(u64 fence);
+
+        // Frees all closed regions whose fence value is less or equal to the completed one
+        void Release(u64 completedFence);
+
+        [[nodiscard]] u64 GetCapacity() const { return m_Capacity; }
+        [[nodiscard]] u64 GetUsedSize() const { return m_UsedSize; }
+        [[nodiscard]] u64 GetOpenSize() const { return m_OpenSize; }
+        [[nodiscard]] u64 GetPendingRegionCount() const { return m_Regions.size(); }
+
+        // Fence value of the oldest closed region, which has to complete before the ring can advance
+        [[nodiscard]] u64 GetOldestFence() const { return m_Regions.empty() ? 0 : m_Regions.front().Fence; }
+
+    private:
+        struct Region
+        {
+            u64 End   = 0; // Head at the time of closing, becomes the new tail on release
+            u64 Size  = 0; // Including alignment padding and skipped tails
+            u64 Fence = 0;
+        };
+
+        std::deque<Region> m_Regions;
+
+        u64 m_Capacity = 0;
+        u64 m_Head     = 0; // Next free byte
+        u64 m_Tail     = 0; // Oldest byte still in use
+        u64 m_UsedSize = 0; // Bytes between tail and head, tells a full ring apart from an empty one
+        u64 m_OpenSize = 0; // Bytes allocated since the last close
+    };
+}
@@ -0,0 +1,257 @@
+#include "MeshCache.hpp"
+
+#include "Core/Hash.hpp"
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <array>
+#include <fstream>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    constexpr std::string_view MESH_CACHE_DIRECTORY = "Cache/Meshes";
+    constexpr std::string_view MESH_CACHE_EXTENSION = ".vkmesh";
+    constexpr u32              MESH_CACHE_MAGIC     = 0x48534D56; // 'VMSH'
+    constexpr u32              MESH_CACHE_VERSION   = 4;
+
+    // Covers the offset alignment of all buffer types and the non-coherent atom size on common hardware
+    constexpr u64 MESH_CACHE_ALIGNMENT = 256;
+
+    struct MeshCacheHeader
+    {
+        u32 Magic;
+        u32 Version;
+        u64 SourcePathHash;
+        u64 SourceModifiedTime;
+        u64 SourceSize;
+        u64 SourceHash;
+        u32 Flags;
+        u32 VertexStride;
+        u32 IndexStride;
+        u32 LodStride;
+        u64 VertexCount;
+        u64 VertexOffset;
+        u64 IndexCount;
+        u64 IndexOffset;
+        u64 LodCount;
+        u64 LodOffset;
+    };
+
+    constexpr u64 AlignUp(u64 value, u64 alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    u64 HashPath(const std::filesystem::path& path)
+    {
+        const std::string normalized = path.lexically_normal().generic_string();
+        return Core::HashBytes(normalized.data(), normalized.size());
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- MappedMesh -----
+
+    MappedMesh::MappedMesh(Scope<Platform::MappedFile> file, const MeshView& view)
+        : m_File(std::move(file)), m_View(view)
+    {
+    }
+
+    MappedMesh::MappedMesh(Mesh&& mesh) : m_Mesh(std::move(mesh))
+    {
+        // Moving a vector keeps its buffer, so the view stays valid when this object gets moved
+        m_View = m_Mesh.GetView();
+    }
+
+    // ----- MeshCache -----
+
+    MeshCacheKey MeshCache::CreateKey(const std::filesystem::path& sourcePath, u32 flags)
+    {
+        const Platform::MappedFile source(sourcePath);
+        const auto                 modifiedTime = std::filesystem::last_write_time(sourcePath);
+
+        return { .SourcePath         = sourcePath,
+                 .SourceModifiedTime = (u64)modifiedTime.time_since_epoch().count(),
+                 .SourceSize         = source.GetSize(),
+                 .SourceHash         = Core::HashBytes(source.GetData(), source.GetSize()),
+                 .Flags              = flags };
+    }
+
+    std::filesystem::path MeshCache::GetCachePath(const MeshCacheKey& key)
+    {
+        // Source path hash keeps equally named files from different directories apart
+        const std::string fileName = fmt::format(
+            "{}-{:016x}{}", key.SourcePath.stem().string(), HashPath(key.SourcePath), MESH_CACHE_EXTENSION);
+
+        return std::filesystem::path(MESH_CACHE_DIRECTORY) / fileName;
+    }
+
+    MappedMesh MeshCache::Load(const MeshCacheKey& key)
+    {
+        const std::filesystem::path cachePath = GetCachePath(key);
+
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(cachePath, ec))
+        {
+            LOG_VERBOSE("No mesh cache entry for '{}' ...", key.SourcePath.string());
+            return {};
+        }
+
+        auto file = MakeScope<Platform::MappedFile>(cachePath);
+        if (file->GetSize() < sizeof(MeshCacheHeader))
+        {
+            LOG_WARN("Mesh cache entry '{}' is truncated ... Rebuilding", cachePath.string());
+            return {};
+        }
+
+        MeshCacheHeader header;
+        std::memcpy(&header, file->GetData(), sizeof(MeshCacheHeader));
+
+        const b8 validIndexStride = header.IndexStride == sizeof(u16) || header.IndexStride == sizeof(u32);
+
+        if (header.Magic != MESH_CACHE_MAGIC || header.Version != MESH_CACHE_VERSION
+            || header.VertexStride != sizeof(Vertex) || !validIndexStride || header.LodStride != sizeof(MeshLod))
+        {
+            LOG_WARN("Mesh cache entry '{}' has an incompatible format ... Rebuilding", cachePath.string());
+            return {};
+        }
+
+        if (header.SourcePathHash != HashPath(key.SourcePath) || header.SourceModifiedTime != key.SourceModifiedTime
+            || header.SourceSize != key.SourceSize || header.SourceHash != key.SourceHash || header.Flags != key.Flags)
+        {
+            LOG_INFO("Mesh cache entry '{}' is stale ... Rebuilding", cachePath.string());
+            return {};
+        }
+
+        const u64 vertexEnd = header.VertexOffset + (header.VertexCount * sizeof(Vertex));
+        const u64 indexSize = header.IndexCount * header.IndexStride;
+        const u64 indexEnd  = header.IndexOffset + indexSize;
+        const u64 lodEnd    = header.LodOffset + (header.LodCount * sizeof(MeshLod));
+
+        if (header.VertexOffset % MESH_CACHE_ALIGNMENT != 0 || header.IndexOffset % MESH_CACHE_ALIGNMENT != 0
+            || header.LodOffset % MESH_CACHE_ALIGNMENT != 0 || vertexEnd > file->GetSize()
+            || indexEnd > file->GetSize() || lodEnd > file->GetSize())
+        {
+            LOG_WARN("Mesh cache entry '{}' is corrupted ... Rebuilding", cachePath.string());
+            return {};
+        }
+
+        // The mapping is page aligned, so all blobs are properly aligned for their types
+        const MeshView view{
+            .Vertices      = { (const Vertex*)(file->GetData() + header.VertexOffset), header.VertexCount },
+            .Indices       = { (const u8*)(file->GetData() + header.IndexOffset), indexSize },
+            .Lods          = { (const MeshLod*)(file->GetData() + header.LodOffset), header.LodCount },
+            .IndexEncoding = header.IndexStride == sizeof(u16) ? IndexFormat::eUint16 : IndexFormat::eUint32
+        };
+
+        for (const MeshLod& lod : view.Lods)
+        {
+            if ((u64)lod.IndexOffset + lod.IndexCount > header.IndexCount)
+            {
+                LOG_WARN("Mesh cache entry '{}' has invalid levels of detail ... Rebuilding", cachePath.string());
+                return {};
+            }
+        }
+
+        LOG_INFO("Mapped cached mesh '{}' ... (Vertices: {}, Indices: {} ({}), LODs: {})",
+                 cachePath.string(),
+                 header.VertexCount,
+                 header.IndexCount,
+                 IndexFormatToString(view.IndexEncoding),
+                 header.LodCount);
+
+        return { std::move(file), view };
+    }
+
+    b8 MeshCache::Store(const MeshCacheKey& key, const MeshView& mesh)
+    {
+        const std::filesystem::path cachePath = GetCachePath(key);
+        std::filesystem::path       tempPath  = cachePath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+        // Store the smallest index format the vertex count allows, so loads can upload the indices as they are
+        std::vector<u16>    narrowed;
+        std::span<const u8> indices     = mesh.Indices;
+        IndexFormat         indexFormat = mesh.IndexEncoding;
+
+        if (indexFormat == IndexFormat::eUint32 && GetIndexFormat(mesh.Vertices.size()) == IndexFormat::eUint16)
+        {
+            narrowed    = NarrowIndices({ (const u32*)mesh.Indices.data(), mesh.GetIndexCount() });
+            indices     = { (const u8*)narrowed.data(), narrowed.size() * sizeof(u16) };
+            indexFormat = IndexFormat::eUint16;
+        }
+
+        const u64 vertexOffset = AlignUp(sizeof(MeshCacheHeader), MESH_CACHE_ALIGNMENT);
+        const u64 indexOffset  = AlignUp(vertexOffset + mesh.GetVerticeSize(), MESH_CACHE_ALIGNMENT);
+        const u64 lodOffset    = AlignUp(indexOffset + indices.size(), MESH_CACHE_ALIGNMENT);
+        const u64 lodSize      = mesh.Lods.size_bytes();
+
+        const MeshCacheHeader header{ .Magic              = MESH_CACHE_MAGIC,
+                                      .Version            = MESH_CACHE_VERSION,
+                                      .SourcePathHash     = HashPath(key.SourcePath),
+                                      .SourceModifiedTime = key.SourceModifiedTime,
+                                      .SourceSize         = key.SourceSize,
+                                      .SourceHash         = key.SourceHash,
+                                      .Flags              = key.Flags,
+                                      .VertexStride       = sizeof(Vertex),
+                                      .IndexStride        = GetIndexSize(indexFormat),
+                                      .LodStride          = sizeof(MeshLod),
+                                      .VertexCount        = mesh.Vertices.size(),
+                                      .VertexOffset       = vertexOffset,
+                                      .IndexCount         = mesh.GetIndexCount(),
+                                      .IndexOffset        = indexOffset,
+                                      .LodCount           = mesh.Lods.size(),
+                                      .LodOffset          = lodOffset };
+
+        constexpr std::array<char, MESH_CACHE_ALIGNMENT> padding{};
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                LOG_WARN("Can't write mesh cache entry '{}' ...", tempPath.string());
+                return false;
+            }
+
+            file.write((const char*)&header, sizeof(MeshCacheHeader));
+            file.write(padding.data(), (std::streamsize)(vertexOffset - sizeof(MeshCacheHeader)));
+            file.write((const char*)mesh.Vertices.data(), mesh.GetVerticeSize());
+            file.write(padding.data(), (std::streamsize)(indexOffset - vertexOffset - mesh.GetVerticeSize()));
+            file.write((const char*)indices.data(), (std::streamsize)indices.size());
+            file.write(padding.data(), (std::streamsize)(lodOffset - indexOffset - indices.size()));
+            file.write((const char*)mesh.Lods.data(), (std::streamsize)lodSize);
+
+            if (!file.good())
+            {
+                LOG_WARN("Failed writing mesh cache entry '{}' ...", tempPath.string());
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        // Replace the old entry in one step, so a crash never leaves a half written cache file behind
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+        {
+            LOG_WARN("Can't move mesh cache entry to '{}' ... ({})", cachePath.string(), ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        LOG_INFO("Wrote mesh cache entry '{}' ... ({})",
+                 cachePath.string(),
+                 Core::Utility::BytesToString(lodOffset + lodSize));
+
+        return true;
+    }
+}
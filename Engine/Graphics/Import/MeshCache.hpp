@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Core/Memory.hpp"
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include "Platform/MappedFile.hpp"
+
+#include <filesystem>
+
+namespace Engine::Graphics
+{
+    // Identifies the source a cached mesh was built from. A cache entry only gets used if all fields match.
+    struct MeshCacheKey
+    {
+        std::filesystem::path SourcePath;
+        u64                   SourceModifiedTime = 0;
+        u64                   SourceSize         = 0;
+        u64                   SourceHash         = 0;
+        u32                   Flags              = 0; // Loader settings that change the resulting mesh
+    };
+
+    // Mesh data living inside a memory-mapped .vkmesh file. The view points directly into the mapping, so nothing
+    // gets copied or parsed. Owns a regular mesh instead if the cache couldn't be written.
+    class MappedMesh
+    {
+    public:
+        MappedMesh() = default;
+        MappedMesh(Scope<Platform::MappedFile> file, const MeshView& view);
+        explicit MappedMesh(Mesh&& mesh);
+
+        [[nodiscard]] const MeshView& GetView() const { return m_View; }
+        [[nodiscard]] b8              IsValid() const { return !m_View.Vertices.empty(); }
+
+    private:
+        Scope<Platform::MappedFile> m_File;
+        Mesh                        m_Mesh;
+        MeshView                    m_View;
+    };
+
+    // Versioned binary mesh cache. File layout:
+    // [MeshCacheHeader][padding][Vertex blob][padding][u32 index blob], blobs aligned for direct upload.
+    class MeshCache
+    {
+    public:
+        MeshCache() = delete;
+
+        // Gathers modification time, size and content hash of the source file
+        [[nodiscard]] static MeshCacheKey          CreateKey(const std::filesystem::path& sourcePath, u32 flags);
+        [[nodiscard]] static std::filesystem::path GetCachePath(const MeshCacheKey& key);
+
+        // Returns an invalid mesh if there is no cache entry or it's stale or incompatible
+        [[nodiscard]] static MappedMesh Load(const MeshCacheKey& key);
+
+        // Writes the cache entry atomically. Returns false if it couldn't be written.
+        static b8 Store(const MeshCacheKey& key, const MeshView& mesh);
+    };
+}
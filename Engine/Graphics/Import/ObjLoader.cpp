@@ -1,90 +1,524 @@
 #include "ObjLoader.hpp"
 
+#include "Core/FlatHashMap.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Utility.hpp"
+
 #include "Debug/Log.hpp"
 #include "Debug/LogTable.hpp"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "Core/Utility.hpp"
+#include "Graphics/Resources/MeshOptimizer.hpp"
+#include "Graphics/Resources/MeshSimplifier.hpp"
 
-#include "Vendor/tinyobjloader/tiny_obj_loader.hpp"
+#include "Platform/MappedFile.hpp"
 
-namespace Engine::Graphics
+#include <charconv>
+#include <chrono>
+
+namespace
 {
-    Mesh ObjLoader::LoadMeshFromFile(const std::filesystem::path& path, Color color)
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    // Chunks smaller than this aren't worth a job of their own
+    constexpr u64 MIN_CHUNK_SIZE = 64ull * 1024;
+
+    // Marks a face corner without texture coordinate
+    constexpr u32 INVALID_OBJ_INDEX = UINT32_MAX;
+
+    struct ObjCorner
+    {
+        u32 Position = INVALID_OBJ_INDEX;
+        u32 TexCoord = INVALID_OBJ_INDEX;
+    };
+
+    // Line-aligned part of the file. Gets counted in a first pass and parsed in a second pass.
+    struct ObjChunk
+    {
+        const char* Begin = nullptr;
+        const char* End   = nullptr;
+
+        // Amount of elements inside this chunk (first pass)
+        u32 PositionCount = 0;
+        u32 TexCoordCount = 0;
+        u32 NormalCount   = 0;
+
+        // Global element indices of the first element inside this chunk (prefix sums of the counts)
+        u32 PositionBase = 0;
+        u32 TexCoordBase = 0;
+        u32 NormalBase   = 0;
+
+        // Triangulated face corners (second pass)
+        std::vector<ObjCorner> Corners;
+        std::vector<u32>       QuadOffsets;
+        u32                    FaceCount = 0;
+        b8                     AllColors = true;
+    };
+
+    struct ObjData
+    {
+        std::vector<glm::vec3> Positions;
+        std::vector<glm::vec3> Colors;
+        std::vector<glm::vec2> TexCoords;
+        std::vector<ObjChunk>  Chunks;
+        u32                    NormalCount = 0;
+        b8                     HasColors   = false;
+    };
+
+    enum class ObjLineType : u8
+    {
+        eOther    = 0,
+        ePosition = 1,
+        eTexCoord = 2,
+        eNormal   = 3,
+        eFace     = 4
+    };
+
+    inline bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    inline bool IsLineEnd(char c)
+    {
+        return c == '\n' || c == '\r';
+    }
+
+    inline const char* SkipSpaces(const char* it, const char* end)
+    {
+        while (it < end && IsSpace(*it))
+        {
+            it++;
+        }
+        return it;
+    }
+
+    inline const char* FindLineEnd(const char* it, const char* end)
+    {
+        const void* lineEnd = std::memchr(it, '\n', (size_t)(end - it));
+        return lineEnd != nullptr ? (const char*)lineEnd : end;
+    }
+
+    // Classifies the line and moves the iterator behind the keyword
+    inline ObjLineType ClassifyLine(const char*& it, const char* end)
+    {
+        it = SkipSpaces(it, end);
+
+        if (end - it < 2)
+        {
+            return ObjLineType::eOther;
+        }
+
+        if (it[0] == 'f' && IsSpace(it[1]))
+        {
+            it += 2;
+            return ObjLineType::eFace;
+        }
+
+        if (it[0] != 'v')
+        {
+            return ObjLineType::eOther;
+        }
+
+        if (IsSpace(it[1]))
+        {
+            it += 2;
+            return ObjLineType::ePosition;
+        }
+
+        if (end - it >= 3 && IsSpace(it[2]))
+        {
+            switch (it[1])
+            {
+            case 't':
+                it += 3;
+                return ObjLineType::eTexCoord;
+            case 'n':
+                it += 3;
+                return ObjLineType::eNormal;
+            default:
+                break;
+            }
+        }
+
+        return ObjLineType::eOther;
+    }
+
+    inline bool ParseFloat(const char*& it, const char* end, f32& value)
+    {
+        it = SkipSpaces(it, end);
+
+        // std::from_chars doesn't accept a leading plus sign
+        if (it < end && *it == '+')
+        {
+            it++;
+        }
+
+        const auto [ptr, ec] = std::from_chars(it, end, value);
+        if (ec != std::errc())
+        {
+            return false;
+        }
+
+        it = ptr;
+        return true;
+    }
+
+    inline bool ParseInt(const char*& it, const char* end, i64& value)
+    {
+        const auto [ptr, ec] = std::from_chars(it, end, value);
+        if (ec != std::errc())
+        {
+            return false;
+        }
+
+        it = ptr;
+        return true;
+    }
+
+    // Converts 1-based and negative (relative) obj indices into 0-based global indices
+    inline u32 ResolveIndex(i64 index, u32 currentCount, u64 totalCount, const std::filesystem::path& path)
+    {
+        const i64 resolved = index > 0 ? index - 1 : (i64)currentCount + index;
+        ASSERT(index != 0 && resolved >= 0 && (u64)resolved < totalCount,
+               "Index '{}' out of range in model '{}'",
+               index,
+               path.string());
+        return (u32)resolved;
+    }
+
+    // Parses one 'v/vt/vn' corner of a face. Normals are validated but not stored.
+    inline ObjCorner ParseCorner(const char*& it, const char* end, const ObjChunk& chunk, const ObjData& data,
+                                 u32 positionCount, u32 texCoordCount, const std::filesystem::path& path)
+    {
+        ObjCorner corner{};
+        i64       index = 0;
+
+        ASSERT(ParseInt(it, end, index), "Malformed face in model '{}'", path.string());
+        corner.Position = ResolveIndex(index, chunk.PositionBase + positionCount, data.Positions.size(), path);
+
+        if (it < end && *it == '/')
+        {
+            it++;
+
+            // Texture coordinate is optional ('v//vn')
+            if (it < end && *it != '/' && ParseInt(it, end, index))
+            {
+                corner.TexCoord =
+                    ResolveIndex(index, chunk.TexCoordBase + texCoordCount, data.TexCoords.size(), path);
+            }
+
+            if (it < end && *it == '/')
+            {
+                it++;
+                ParseInt(it, end, index);
+            }
+        }
+
+        return corner;
+    }
+
+    // Splits the file into line-aligned chunks
+    std::vector<ObjChunk> SplitIntoChunks(std::string_view file)
+    {
+        const u64 workerCount = Core::JobSystem::GetWorkerCount();
+        const u64 chunkSize   = std::max(MIN_CHUNK_SIZE, file.size() / (workerCount * 4));
+
+        std::vector<ObjChunk> chunks;
+        const char*           it  = file.data();
+        const char*           end = file.data() + file.size();
+
+        while (it < end)
+        {
+            const char* chunkEnd = it + std::min<u64>(chunkSize, (u64)(end - it));
+            chunkEnd             = chunkEnd < end ? FindLineEnd(chunkEnd, end) : end;
+            chunkEnd             = chunkEnd < end ? chunkEnd + 1 : end;
+
+            ObjChunk& chunk = chunks.emplace_back();
+            chunk.Begin     = it;
+            chunk.End       = chunkEnd;
+            it = chunkEnd;
+        }
+
+        return chunks;
+    }
+
+    // First pass: Count the elements of each chunk, so every chunk knows its global index base afterwards
+    void CountChunk(ObjChunk& chunk)
+    {
+        for (const char* it = chunk.Begin; it < chunk.End;)
+        {
+            const char* lineEnd = FindLineEnd(it, chunk.End);
+
+            switch (ClassifyLine(it, lineEnd))
+            {
+            case ObjLineType::ePosition:
+                chunk.PositionCount++;
+                break;
+            case ObjLineType::eTexCoord:
+                chunk.TexCoordCount++;
+                break;
+            case ObjLineType::eNormal:
+                chunk.NormalCount++;
+                break;
+            default:
+                break;
+            }
+
+            it = lineEnd < chunk.End ? lineEnd + 1 : chunk.End;
+        }
+    }
+
+    // Second pass: Parse attributes straight into the global arrays and collect the triangulated face corners
+    void ParseChunk(ObjChunk& chunk, ObjData& data, const std::filesystem::path& path)
     {
-        tinyobj::attrib_t                attrib;
-        std::vector<tinyobj::shape_t>    shapes;
-        std::vector<tinyobj::material_t> materials;
-        std::string                      warn;
-        std::string                      error;
-        const std::string                objPath = path.string();
+        u32                    positionCount = 0;
+        u32                    texCoordCount = 0;
+        std::vector<ObjCorner> polygon;
 
-        // Load obj file
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &error, objPath.c_str(), nullptr, true, false))
+        for (const char* it = chunk.Begin; it < chunk.End;)
         {
-            if (!warn.empty())
+            const char* lineEnd = FindLineEnd(it, chunk.End);
+
+            // Ignore carriage returns of windows line endings
+            const char* contentEnd = lineEnd;
+            while (contentEnd > it && IsLineEnd(*(contentEnd - 1)))
             {
-                LOG_WARN("tinyobjloader: {}", warn);
+                contentEnd--;
             }
 
-            if (!error.empty())
+            switch (ClassifyLine(it, contentEnd))
+            {
+            case ObjLineType::ePosition:
+            {
+                glm::vec3& position = data.Positions[chunk.PositionBase + positionCount];
+                ASSERT(ParseFloat(it, contentEnd, position.x) && ParseFloat(it, contentEnd, position.y)
+                           && ParseFloat(it, contentEnd, position.z),
+                       "Malformed vertex position in model '{}'",
+                       path.string());
+
+                // Optional vertex colors (extension: 'v x y z r g b')
+                glm::vec3& color = data.Colors[chunk.PositionBase + positionCount];
+                chunk.AllColors &= ParseFloat(it, contentEnd, color.r) && ParseFloat(it, contentEnd, color.g)
+                                   && ParseFloat(it, contentEnd, color.b);
+
+                positionCount++;
+                break;
+            }
+            case ObjLineType::eTexCoord:
             {
-                LOG_ERROR("tinyobjloader: {}", error);
+                glm::vec2& texCoord = data.TexCoords[chunk.TexCoordBase + texCoordCount];
+                ASSERT(ParseFloat(it, contentEnd, texCoord.x), "Malformed texture coordinate in '{}'", path.string());
+                ParseFloat(it, contentEnd, texCoord.y);
+
+                texCoordCount++;
+                break;
             }
+            case ObjLineType::eFace:
+            {
+                polygon.clear();
+
+                for (it = SkipSpaces(it, contentEnd); it < contentEnd; it = SkipSpaces(it, contentEnd))
+                {
+                    polygon.push_back(ParseCorner(it, contentEnd, chunk, data, positionCount, texCoordCount, path));
+                }
+
+                ASSERT(polygon.size() >= 3, "Degenerated face found in model '{}'", path.string());
+
+                // Fan-triangulate polygons. Quads get split along their shorter diagonal later on, as their
+                // positions might live in chunks which are still being parsed.
+                if (polygon.size() == 4)
+                {
+                    chunk.QuadOffsets.push_back((u32)chunk.Corners.size());
+                }
+
+                for (size_t i = 1; i + 1 < polygon.size(); i++)
+                {
+                    chunk.Corners.insert(chunk.Corners.end(), { polygon[0], polygon[i], polygon[i + 1] });
+                }
+
+                chunk.FaceCount++;
+                break;
+            }
+            default:
+                break;
+            }
+
+            it = lineEnd < chunk.End ? lineEnd + 1 : chunk.End;
+        }
+    }
+
+    // Third pass: Re-split quads whose second diagonal is the shorter one
+    // ([0, 1, 2], [0, 2, 3] -> [0, 1, 3], [1, 2, 3])
+    void SplitQuads(ObjChunk& chunk, const ObjData& data)
+    {
+        for (const u32 offset : chunk.QuadOffsets)
+        {
+            ObjCorner* corners = &chunk.Corners[offset];
+            const ObjCorner quad[4] = { corners[0], corners[1], corners[2], corners[5] };
+
+            const glm::vec3 diagonal02 = data.Positions[quad[2].Position] - data.Positions[quad[0].Position];
+            const glm::vec3 diagonal13 = data.Positions[quad[3].Position] - data.Positions[quad[1].Position];
+
+            if (glm::dot(diagonal02, diagonal02) >= glm::dot(diagonal13, diagonal13))
+            {
+                corners[0] = quad[0];
+                corners[1] = quad[1];
+                corners[2] = quad[3];
+                corners[3] = quad[1];
+                corners[4] = quad[2];
+                corners[5] = quad[3];
+            }
+        }
+    }
+
+    ObjData ParseObj(std::string_view file, const std::filesystem::path& path)
+    {
+        ObjData data;
+        data.Chunks = SplitIntoChunks(file);
+
+        // First pass: Count elements per chunk
+        Core::JobSystem::ParallelFor(0,
+                                     data.Chunks.size(),
+                                     1,
+                                     [&data](u64 begin, u64 end)
+                                     {
+                                         for (u64 i = begin; i < end; i++)
+                                         {
+                                             CountChunk(data.Chunks[i]);
+                                         }
+                                     });
+
+        // Calculate global index bases
+        u32 positionCount = 0;
+        u32 texCoordCount = 0;
+
+        for (auto& chunk : data.Chunks)
+        {
+            chunk.PositionBase = positionCount;
+            chunk.TexCoordBase = texCoordCount;
+            chunk.NormalBase   = data.NormalCount;
+
+            positionCount += chunk.PositionCount;
+            texCoordCount += chunk.TexCoordCount;
+            data.NormalCount += chunk.NormalCount;
+        }
+
+        data.Positions.resize(positionCount);
+        data.Colors.resize(positionCount);
+        data.TexCoords.resize(texCoordCount);
+
+        // Second pass: Parse chunks
+        Core::JobSystem::ParallelFor(0,
+                                     data.Chunks.size(),
+                                     1,
+                                     [&data, &path](u64 begin, u64 end)
+                                     {
+                                         for (u64 i = begin; i < end; i++)
+                                         {
+                                             ParseChunk(data.Chunks[i], data, path);
+                                         }
+                                     });
+
+        // Third pass: All positions are known now, so quads can be split
+        Core::JobSystem::ParallelFor(0,
+                                     data.Chunks.size(),
+                                     1,
+                                     [&data](u64 begin, u64 end)
+                                     {
+                                         for (u64 i = begin; i < end; i++)
+                                         {
+                                             SplitQuads(data.Chunks[i], data);
+                                         }
+                                     });
+
+        // Vertex colors only count if every vertex provides them
+        data.HasColors = positionCount > 0;
+        for (const auto& chunk : data.Chunks)
+        {
+            data.HasColors &= chunk.AllColors;
+        }
 
-            ASSERT(false, "Failed to load model '{}'", path.string());
+        if (!data.HasColors)
+        {
+            data.Colors.clear();
+        }
+
+        return data;
+    }
+}
+
+namespace Engine::Graphics
+{
+    Mesh ObjLoader::LoadMeshFromFile(const std::filesystem::path& path, Color color)
+    {
+        const auto startClock = std::chrono::high_resolution_clock::now();
+
+        // Map and parse obj file on all workers
+        const Platform::MappedFile file(path);
+        const ObjData              data = ParseObj(file.GetView(), path);
+
+        const auto parseClock = std::chrono::high_resolution_clock::now();
+
+        u64 cornerCount = 0;
+        u64 faceCount   = 0;
+        for (const auto& chunk : data.Chunks)
+        {
+            cornerCount += chunk.Corners.size();
+            faceCount += chunk.FaceCount;
         }
 
         LOG_INFO("Loaded .obj model '{}' ...", path.string());
         LOG_TABLE_BEGIN(6);
-        LOG_TABLE_COLUMN("Shapes", "{}", shapes.size());
-        LOG_TABLE_COLUMN("Materials", "{}", materials.size());
-        LOG_TABLE_COLUMN("Positions", "{} floats", attrib.vertices.size());
-        LOG_TABLE_COLUMN("Colors", "{} floats", attrib.colors.size());
-        LOG_TABLE_COLUMN("Normals", "{} floats", attrib.normals.size());
-        LOG_TABLE_COLUMN("TexCoords", "{} floats", attrib.texcoords.size());
+        LOG_TABLE_COLUMN("Chunks", "{}", data.Chunks.size());
+        LOG_TABLE_COLUMN("Faces", "{}", faceCount);
+        LOG_TABLE_COLUMN("Positions", "{} floats", data.Positions.size() * 3);
+        LOG_TABLE_COLUMN("Colors", "{} floats", data.Colors.size() * 3);
+        LOG_TABLE_COLUMN("Normals", "{} floats", (u64)data.NormalCount * 3);
+        LOG_TABLE_COLUMN("TexCoords", "{} floats", data.TexCoords.size() * 2);
         LOG_TABLE_END();
 
-        // Hash map to store and reuse vertices (needs a hashing function and an overloaded comparison operator)
-        std::unordered_map<Vertex, u32> uniqueVertices{};
+        // Hash map to store and reuse vertices. Pre-sized for the common case of one vertex per position or texture
+        // coordinate, so that it rarely has to grow.
+        const u64 expectedVertexCount = std::max(data.Positions.size(), data.TexCoords.size());
+        Core::FlatHashMap<Vertex, u32, VertexHash, VertexEqual> uniqueVertices(expectedVertexCount);
 
         Mesh mesh;
         b8   gotCompressed = false;
 
-        // Combine all faces into a single mesh by iterating over all shapes
-        for (const auto& shape : shapes)
+        mesh.Vertices.reserve(expectedVertexCount);
+        mesh.Indices.reserve(cornerCount);
+
+        // Combine all faces into a single mesh by iterating over all chunks in file order
+        for (const auto& chunk : data.Chunks)
         {
-            for (const auto& index : shape.mesh.indices)
+            for (const auto& corner : chunk.Corners)
             {
                 Vertex vertex{};
+                vertex.Position = data.Positions[corner.Position];
 
-                vertex.Position = { attrib.vertices[(3 * index.vertex_index) + 0],
-                                    attrib.vertices[(3 * index.vertex_index) + 1],
-                                    attrib.vertices[(3 * index.vertex_index) + 2] };
-
-                if (!attrib.colors.empty())
+                if (data.HasColors)
                 {
-                    vertex.Color = { attrib.colors[(3 * index.vertex_index) + 0],
-                                     attrib.colors[(3 * index.vertex_index) + 1],
-                                     attrib.colors[(3 * index.vertex_index) + 2] };
+                    vertex.Color = data.Colors[corner.Position];
                 }
                 else if (color == Color::RANDOMIZE)
                 {
                     vertex.Color = Core::Utility::GetRandomVec3();
                 }
 
-                if (!attrib.texcoords.empty())
+                if (corner.TexCoord != INVALID_OBJ_INDEX)
                 {
-                    vertex.TexCoord = {
-                        attrib.texcoords[(2 * index.texcoord_index) + 0],
-                        1.0f - attrib.texcoords[(2 * index.texcoord_index) + 1] // Flip v-axis
-                    };
+                    const glm::vec2& texCoord = data.TexCoords[corner.TexCoord];
+                    vertex.TexCoord           = { texCoord.x, 1.0f - texCoord.y }; // Flip v-axis
                 }
 
-                // Check for duplicate vertex
-                if (!uniqueVertices.contains(vertex))
+                // Look up and insert with a single probe, keys are compared by their bits
+                vertex                       = CanonicalizeVertex(vertex);
+                const auto [index, inserted] = uniqueVertices.FindOrInsert(vertex, (u32)mesh.Vertices.size());
+
+                if (inserted)
                 {
-                    uniqueVertices[vertex] = (u32)(mesh.Vertices.size());
                     mesh.Vertices.push_back(vertex);
                 }
                 else
@@ -93,7 +527,7 @@ namespace Engine::Graphics
                 }
 
                 // Save index
-                mesh.Indices.push_back(uniqueVertices[vertex]);
+                mesh.Indices.push_back(index);
             }
         }
 
@@ -108,6 +542,52 @@ namespace Engine::Graphics
             LOG_VERBOSE("Mesh was already compressed ...");
         }
 
+        const auto endClock = std::chrono::high_resolution_clock::now();
+        LOG_PERF("Loading '{}' took {} (Parse: {}, Build: {}) ...",
+                 path.filename().string(),
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()),
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(parseClock - startClock).count()),
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - parseClock).count()));
+
         return mesh;
     }
+
+    MappedMesh ObjLoader::LoadCachedMesh(const std::filesystem::path& path, Color color)
+    {
+        const auto startClock = std::chrono::high_resolution_clock::now();
+
+        const MeshCacheKey key    = MeshCache::CreateKey(path, (u32)color);
+        MappedMesh         cached = MeshCache::Load(key);
+
+        if (!cached.IsValid())
+        {
+            Mesh mesh = LoadMeshFromFile(path, color);
+
+            // Optimizing and simplifying only pays off once, as the result gets cached
+            MeshOptimizer::Optimize(mesh);
+            MeshSimplifier::GenerateLods(mesh);
+
+            // Map the freshly written entry, so both paths hand out the same kind of data
+            if (MeshCache::Store(key, mesh.GetView()))
+            {
+                cached = MeshCache::Load(key);
+            }
+
+            if (!cached.IsValid())
+            {
+                cached = MappedMesh(std::move(mesh));
+            }
+        }
+
+        const auto endClock = std::chrono::high_resolution_clock::now();
+        LOG_PERF("Loading cached '{}' took {} ...",
+                 path.filename().string(),
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()));
+
+        return cached;
+    }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Graphics/Import/MeshCache.hpp"
 #include "Graphics/Resources/Mesh.hpp"
 
 #include <filesystem>
@@ -18,5 +19,9 @@ namespace Engine::Graphics
         ObjLoader() = delete;
 
         static Mesh LoadMeshFromFile(const std::filesystem::path& path, Color color = Color::DEFAULT);
+
+        // Maps the binary mesh cache entry of the file. Parses, optimizes and simplifies the file into a chain of
+        // levels of detail and writes the entry first if it's missing or out of date.
+        static MappedMesh LoadCachedMesh(const std::filesystem::path& path, Color color = Color::DEFAULT);
     };
 }
@@ -0,0 +1,203 @@
+#include "ShaderCache.hpp"
+
+#include "Core/Hash.hpp"
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <shaderc/shaderc.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    constexpr std::string_view SHADER_CACHE_DIRECTORY = "Cache/Shaders";
+    constexpr std::string_view SHADER_CACHE_EXTENSION = ".spv";
+    constexpr u32              SPIRV_MAGIC            = 0x07230203;
+
+    // Bump whenever the compile options change, entries of older settings then simply stop being found
+    constexpr u64 SHADER_CACHE_VERSION = 1;
+
+    shaderc_shader_kind GetShaderKind(vk::ShaderStageFlagBits stage)
+    {
+        switch (stage)
+        {
+            case vk::ShaderStageFlagBits::eVertex:
+                return shaderc_vertex_shader;
+            case vk::ShaderStageFlagBits::eFragment:
+                return shaderc_fragment_shader;
+            case vk::ShaderStageFlagBits::eCompute:
+                return shaderc_compute_shader;
+            default:
+                ASSERT(false, "Shader stage '{}' isn't supported!", vk::to_string(stage));
+                return shaderc_glsl_infer_from_source;
+        }
+    }
+
+    std::filesystem::path GetCachePath(const ShaderSource& source, u64 key)
+    {
+        const std::string fileName =
+            fmt::format("{}-{:016x}{}", source.Path.stem().string(), key, SHADER_CACHE_EXTENSION);
+        return std::filesystem::path(SHADER_CACHE_DIRECTORY) / fileName;
+    }
+
+    std::vector<u32> LoadEntry(const std::filesystem::path& cachePath)
+    {
+        std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        const u64 size = (u64)file.tellg();
+        if (size < sizeof(u32) || size % sizeof(u32) != 0)
+        {
+            LOG_WARN("Shader cache entry '{}' is corrupted ... Recompiling", cachePath.string());
+            return {};
+        }
+
+        std::vector<u32> code(size / sizeof(u32));
+        file.seekg(0);
+        file.read((char*)code.data(), (std::streamsize)size);
+
+        if (!file.good() || code.front() != SPIRV_MAGIC)
+        {
+            LOG_WARN("Shader cache entry '{}' is corrupted ... Recompiling", cachePath.string());
+            return {};
+        }
+
+        return code;
+    }
+
+    // Writes the entry atomically, a failure only costs a recompilation next time
+    void StoreEntry(const std::filesystem::path& cachePath, const std::vector<u32>& code)
+    {
+        std::filesystem::path tempPath = cachePath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write((const char*)code.data(), (std::streamsize)(code.size() * sizeof(u32)));
+
+            if (!file.good())
+            {
+                LOG_WARN("Failed writing shader cache entry '{}' ...", tempPath.string());
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+        {
+            LOG_WARN("Can't move shader cache entry to '{}' ... ({})", cachePath.string(), ec.message());
+            std::filesystem::remove(tempPath, ec);
+        }
+    }
+
+    std::vector<u32> Compile(const ShaderSource& source, const std::string& code)
+    {
+        shaderc::CompileOptions options;
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+
+        for (const std::string& define : source.Defines)
+        {
+            const size_t separator = define.find('=');
+            if (separator == std::string::npos)
+            {
+                options.AddMacroDefinition(define);
+            }
+            else
+            {
+                options.AddMacroDefinition(define.substr(0, separator), define.substr(separator + 1));
+            }
+        }
+
+        // A compiler per call, shaderc compilers aren't meant to be shared across threads
+        const shaderc::Compiler             compiler;
+        const shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
+            code, GetShaderKind(source.Stage), source.Path.string().c_str(), options);
+
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            LOG_WARN("Can't compile shader '{}' ...\n{}", source.Path.string(), result.GetErrorMessage());
+            return {};
+        }
+
+        return { result.cbegin(), result.cend() };
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    u64 ShaderCache::CreateKey(const ShaderSource& source, std::string_view code)
+    {
+        u64 key = Core::HashBytes(code.data(), code.size(), SHADER_CACHE_VERSION);
+        key     = Core::HashBytes(&source.Stage, sizeof(source.Stage), key);
+
+        // Separators keep {"AB"} and {"A", "B"} apart
+        for (const std::string& define : source.Defines)
+        {
+            key = Core::HashBytes(define.data(), define.size() + 1, key);
+        }
+
+        return key;
+    }
+
+    std::vector<u32> ShaderCache::LoadOrCompile(const ShaderSource& source)
+    {
+        std::ifstream sourceFile(source.Path);
+        if (!sourceFile.is_open())
+        {
+            LOG_WARN("Can't open shader source '{}' ...", source.Path.string());
+            return {};
+        }
+
+        std::stringstream stream;
+        stream << sourceFile.rdbuf();
+        const std::string code = stream.str();
+
+        const std::filesystem::path cachePath = GetCachePath(source, CreateKey(source, code));
+
+        std::vector<u32> spirv = LoadEntry(cachePath);
+        if (!spirv.empty())
+        {
+            LOG_VERBOSE("Loaded cached shader '{}' ...", cachePath.string());
+            return spirv;
+        }
+
+        const auto startClock = std::chrono::high_resolution_clock::now();
+
+        spirv = Compile(source, code);
+        if (spirv.empty())
+        {
+            return {};
+        }
+
+        const auto endClock = std::chrono::high_resolution_clock::now();
+
+        StoreEntry(cachePath, spirv);
+
+        LOG_INFO("Compiled shader '{}' ... ({})",
+                 source.Path.string(),
+                 Core::Utility::BytesToString(spirv.size() * sizeof(u32)));
+        LOG_PERF("Shader compilation took {} ...",
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()));
+
+        return spirv;
+    }
+}
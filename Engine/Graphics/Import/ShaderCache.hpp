@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // GLSL source file and everything that changes the SPIR-V compiled from it
+    struct ShaderSource
+    {
+        std::filesystem::path    Path;
+        vk::ShaderStageFlagBits  Stage = vk::ShaderStageFlagBits::eVertex;
+        std::vector<std::string> Defines; // "NAME" or "NAME=VALUE"
+    };
+
+    // Content-addressed SPIR-V cache. Entries are named after a hash of the source text, stage, defines and compiler
+    // settings, so an unchanged shader never gets compiled twice and edits simply produce a new entry.
+    class ShaderCache
+    {
+    public:
+        ShaderCache() = delete;
+
+        [[nodiscard]] static u64 CreateKey(const ShaderSource& source, std::string_view code);
+
+        // Compiles the GLSL source with shaderc on a cache miss and stores the result. Returns no code if the source
+        // can't be read or doesn't compile, the errors get logged.
+        [[nodiscard]] static std::vector<u32> LoadOrCompile(const ShaderSource& source);
+    };
+}
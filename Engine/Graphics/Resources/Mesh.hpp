@@ -1,14 +1,13 @@
 #pragma once
 
+#include "Core/Hash.hpp"
 #include "Core/Types.hpp"
 
-#define GLM_ENABLE_EXPERIMENTAL
 #include "Vendor/glm/glm.hpp"
-#include "Vendor/glm/gtx/hash.hpp"
 
-#include <vulkan/vulkan.hpp>
-
-#include <array>
+#include <algorithm>
+#include <cmath>
+#include <span>
 #include <vector>
 
 namespace Engine::Graphics
@@ -23,59 +22,142 @@ namespace Engine::Graphics
         {
             return Position == vertex.Position && Color == vertex.Color && TexCoord == vertex.TexCoord;
         }
+    };
+
+    // Vertices get hashed and compared by their raw bits during deduplication, so they must not contain padding
+    static_assert(sizeof(Vertex) == 8 * sizeof(f32), "Vertex contains padding bytes!");
+
+    using VertexHash  = Core::BitwiseHash<Vertex>;
+    using VertexEqual = Core::BitwiseEqual<Vertex>;
+
+    // Turns -0.0f into +0.0f, so vertices which only differ in the sign of a zero share the same bits and get merged
+    // during deduplication like operator== would
+    [[nodiscard]] inline Vertex CanonicalizeVertex(Vertex vertex)
+    {
+        const auto canonicalize = [](f32 value) { return value == 0.0f ? 0.0f : value; };
+
+        vertex.Position = { canonicalize(vertex.Position.x), canonicalize(vertex.Position.y),
+                            canonicalize(vertex.Position.z) };
+        vertex.Color    = { canonicalize(vertex.Color.x), canonicalize(vertex.Color.y), canonicalize(vertex.Color.z) };
+        vertex.TexCoord = { canonicalize(vertex.TexCoord.x), canonicalize(vertex.TexCoord.y) };
+
+        return vertex;
+    }
+
+    // Level of detail as range inside the index buffer. All levels share the vertex buffer.
+    struct MeshLod
+    {
+        u32 IndexOffset = 0;
+        u32 IndexCount  = 0;
+        f32 Error       = 0.0f; // Approximate deviation from the full detail mesh in model space units
+    };
+
+    // Width of the indices in an index buffer
+    enum class IndexFormat : u8
+    {
+        eUint16 = 0,
+        eUint32 = 1
+    };
+
+    // Primitive restart isn't used, so 16-bit indices can address every vertex up to and including 0xFFFF
+    inline constexpr u64 MAX_UINT16_INDEXED_VERTICES = 65536;
+
+    // Smallest index format that can address all vertices
+    [[nodiscard]] constexpr IndexFormat GetIndexFormat(u64 vertexCount)
+    {
+        return vertexCount <= MAX_UINT16_INDEXED_VERTICES ? IndexFormat::eUint16 : IndexFormat::eUint32;
+    }
+
+    [[nodiscard]] constexpr u32 GetIndexSize(IndexFormat format)
+    {
+        return format == IndexFormat::eUint16 ? sizeof(u16) : sizeof(u32);
+    }
+
+    [[nodiscard]] constexpr const char* IndexFormatToString(IndexFormat format)
+    {
+        return format == IndexFormat::eUint16 ? "Uint16" : "Uint32";
+    }
+
+    // Expects all indices to be below MAX_UINT16_INDEXED_VERTICES
+    [[nodiscard]] inline std::vector<u16> NarrowIndices(std::span<const u32> indices)
+    {
+        return std::vector<u16>(indices.begin(), indices.end());
+    }
+
+    // Bounding volumes in model space. The sphere is centered on the box, which isn't the tightest sphere but cheap
+    // and good enough for culling and distance estimates.
+    struct MeshBounds
+    {
+        glm::vec3 Min    = glm::vec3(0.0f);
+        glm::vec3 Max    = glm::vec3(0.0f);
+        glm::vec3 Center = glm::vec3(0.0f);
+        f32       Radius = 0.0f;
+    };
+
+    // Empty meshes get zero sized bounds at the origin
+    [[nodiscard]] inline MeshBounds ComputeMeshBounds(std::span<const Vertex> vertices)
+    {
+        if (vertices.empty())
+        {
+            return {};
+        }
+
+        MeshBounds bounds{ .Min = vertices.front().Position, .Max = vertices.front().Position };
 
-        static constexpr vk::VertexInputBindingDescription GetBindingDescription()
+        for (const Vertex& vertex : vertices)
         {
-            return { .binding = 0, .stride = sizeof(Vertex), .inputRate = vk::VertexInputRate::eVertex };
+            bounds.Min = glm::min(bounds.Min, vertex.Position);
+            bounds.Max = glm::max(bounds.Max, vertex.Position);
         }
 
-        // clang-format off
-        static constexpr std::array<vk::VertexInputAttributeDescription, 3> GetAttributeDescriptions()
+        bounds.Center = (bounds.Min + bounds.Max) * 0.5f;
+
+        // Compare squared distances, only the largest one needs a square root
+        f32 radiusSquared = 0.0f;
+        for (const Vertex& vertex : vertices)
         {
-            return std::to_array<vk::VertexInputAttributeDescription>
-            ({
-                {
-                    .location = 0,
-                    .binding  = 0,
-                    .format   = vk::Format::eR32G32B32Sfloat,
-                    .offset   = offsetof(Vertex, Position)
-                },
-                {
-                    .location = 1,
-                    .binding  = 0,
-                    .format   = vk::Format::eR32G32B32Sfloat,
-                    .offset   = offsetof(Vertex, Color)
-                },
-                {
-                    .location = 2,
-                    .binding  = 0,
-                    .format   = vk::Format::eR32G32Sfloat,
-                    .offset   = offsetof(Vertex, TexCoord)
-                }
-            });
+            const glm::vec3 offset = vertex.Position - bounds.Center;
+            radiusSquared          = std::max(radiusSquared, glm::dot(offset, offset));
         }
-        // clang-format on
+
+        bounds.Radius = std::sqrt(radiusSquared);
+        return bounds;
+    }
+
+    // Non-owning view onto mesh data, either from a Mesh or from a memory-mapped mesh cache. Indices are stored
+    // in their upload format, which is 16-bit for cached meshes with few enough vertices.
+    struct MeshView
+    {
+        std::span<const Vertex>  Vertices;
+        std::span<const u8>      Indices; // Raw index data in IndexEncoding
+        std::span<const MeshLod> Lods;    // Empty if the mesh has no generated levels of detail
+        IndexFormat              IndexEncoding = IndexFormat::eUint32;
+
+        [[nodiscard]] u32 GetVerticeSize() const { return sizeof(Vertex) * Vertices.size(); };
+        [[nodiscard]] u32 GetIndiceSize() const { return Indices.size(); };
+        [[nodiscard]] u32 GetIndexCount() const { return Indices.size() / GetIndexSize(IndexEncoding); };
+
+        [[nodiscard]] MeshBounds ComputeBounds() const { return ComputeMeshBounds(Vertices); };
     };
 
+    // Processing format of the loader, optimizer and simplifier, which always works on 32-bit indices
     struct Mesh
     {
-        std::vector<Vertex> Vertices;
-        std::vector<u32>    Indices;
+        std::vector<Vertex>  Vertices;
+        std::vector<u32>     Indices;
+        std::vector<MeshLod> Lods = {}; // Level 0 covers the original indices, coarser levels follow behind it
 
         [[nodiscard]] u32 GetVerticeSize() const { return sizeof(Vertex) * Vertices.size(); };
         [[nodiscard]] u32 GetIndiceSize() const { return sizeof(u32) * Indices.size(); };
-    };
-}
 
-namespace std
-{
-    template <>
-    struct hash<Engine::Graphics::Vertex>
-    {
-        size_t operator()(Engine::Graphics::Vertex const& vertex) const
+        [[nodiscard]] MeshBounds ComputeBounds() const { return ComputeMeshBounds(Vertices); };
+
+        [[nodiscard]] MeshView GetView() const
         {
-            return ((hash<glm::vec3>()(vertex.Position) ^ (hash<glm::vec3>()(vertex.Color) << 1)) >> 1)
-                   ^ (hash<glm::vec2>()(vertex.TexCoord) << 1);
-        }
+            return { .Vertices      = Vertices,
+                     .Indices       = { (const u8*)Indices.data(), GetIndiceSize() },
+                     .Lods          = Lods,
+                     .IndexEncoding = IndexFormat::eUint32 };
+        };
     };
 }
@@ -0,0 +1,442 @@
+#include "MeshOptimizer.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+#include "Debug/LogTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+    using namespace Engine::Graphics;
+
+    constexpr u32 INVALID_VERTEX = UINT32_MAX;
+
+    u32 GetVertexCount(std::span<const u32> indices)
+    {
+        return indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+    }
+
+    // FIFO cache simulation. A vertex is cached if it got inserted within the last 'cacheSize' insertions.
+    class FifoCache
+    {
+    public:
+        FifoCache(u32 vertexCount, u32 cacheSize)
+            : m_TimeStamps(vertexCount, 0), m_Time(cacheSize + 1), m_CacheSize(cacheSize)
+        {
+        }
+
+        // Returns true on a cache miss
+        bool Access(u32 vertex)
+        {
+            if (m_Time - m_TimeStamps[vertex] > m_CacheSize)
+            {
+                m_TimeStamps[vertex] = m_Time++;
+                return true;
+            }
+
+            return false;
+        }
+
+        // Invalidates all entries at once
+        void Flush() { m_Time += m_CacheSize + 1; }
+
+    private:
+        std::vector<u32> m_TimeStamps;
+        u32              m_Time;
+        u32              m_CacheSize;
+    };
+
+    std::vector<u32> Tipsify(std::span<const u32> indices, u32 vertexCount, u32 cacheSize)
+    {
+        const u32 triangleCount = indices.size() / 3;
+
+        // Vertex-triangle adjacency in compressed row storage
+        std::vector<u32> liveTriangles(vertexCount, 0);
+        std::vector<u32> offsets(vertexCount + 1, 0);
+        std::vector<u32> adjacency(indices.size());
+
+        for (const u32 index : indices)
+        {
+            liveTriangles[index]++;
+        }
+
+        std::inclusive_scan(liveTriangles.begin(), liveTriangles.end(), offsets.begin() + 1);
+
+        std::vector<u32> cursors(offsets.begin(), offsets.end() - 1);
+        for (u32 i = 0; i < indices.size(); i++)
+        {
+            adjacency[cursors[indices[i]]++] = i / 3;
+        }
+
+        // Same FIFO semantics as the analysis, but Tipsify needs to look at the time stamps directly
+        std::vector<u32>  timeStamps(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<u32>  deadEndStack;
+        std::vector<u32>  candidates;
+        std::vector<u32>  output;
+
+        deadEndStack.reserve(indices.size());
+        output.reserve(indices.size());
+
+        u32 time        = cacheSize + 1;
+        u32 cursor      = 0;
+        u32 fanningVert = indices.empty() ? INVALID_VERTEX : indices[0];
+
+        while (fanningVert != INVALID_VERTEX)
+        {
+            candidates.clear();
+
+            // Emit all remaining triangles around the fanning vertex
+            for (u32 i = offsets[fanningVert]; i < offsets[fanningVert + 1]; i++)
+            {
+                const u32 triangle = adjacency[i];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    const u32 vertex = indices[(triangle * 3) + corner];
+
+                    output.push_back(vertex);
+                    deadEndStack.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+
+                    if (time - timeStamps[vertex] > cacheSize)
+                    {
+                        timeStamps[vertex] = time++;
+                    }
+                }
+
+                emitted[triangle] = true;
+            }
+
+            // Prefer the oldest candidate that stays in the cache while its remaining triangles get emitted
+            u32 nextVertex   = INVALID_VERTEX;
+            i64 bestPriority = -1;
+
+            for (const u32 vertex : candidates)
+            {
+                if (liveTriangles[vertex] == 0)
+                {
+                    continue;
+                }
+
+                i64       priority = 0;
+                const i64 age      = (i64)time - timeStamps[vertex];
+
+                if (age + (2 * (i64)liveTriangles[vertex]) <= (i64)cacheSize)
+                {
+                    priority = age;
+                }
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    nextVertex   = vertex;
+                }
+            }
+
+            // Dead end: Fall back to recently used vertices, then to the next vertex in input order
+            while (nextVertex == INVALID_VERTEX && !deadEndStack.empty())
+            {
+                const u32 vertex = deadEndStack.back();
+                deadEndStack.pop_back();
+
+                if (liveTriangles[vertex] > 0)
+                {
+                    nextVertex = vertex;
+                }
+            }
+
+            while (nextVertex == INVALID_VERTEX && cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0)
+                {
+                    nextVertex = cursor;
+                }
+                cursor++;
+            }
+
+            fanningVert = nextVertex;
+        }
+
+        return output;
+    }
+
+    struct TriangleCluster
+    {
+        u32 Begin = 0; // First triangle
+        u32 End   = 0; // One past the last triangle
+        f32 Sort  = 0.0f;
+    };
+
+    // Hard boundaries are triangles that miss the cache with all three vertices
+    std::vector<u32> FindHardBoundaries(std::span<const u32> indices, u32 vertexCount, u32 cacheSize)
+    {
+        std::vector<u32> boundaries;
+        FifoCache        cache(vertexCount, cacheSize);
+
+        for (u32 triangle = 0; triangle < indices.size() / 3; triangle++)
+        {
+            u32 misses = 0;
+            for (u32 corner = 0; corner < 3; corner++)
+            {
+                misses += cache.Access(indices[(triangle * 3) + corner]);
+            }
+
+            if (triangle == 0 || misses == 3)
+            {
+                boundaries.push_back(triangle);
+            }
+        }
+
+        return boundaries;
+    }
+
+    // Soft boundaries split hard clusters further, as long as the ACMR of each part stays within the threshold
+    std::vector<TriangleCluster> SplitClusters(std::span<const u32>    indices,
+                                               const std::vector<u32>& hardBoundaries,
+                                               u32                     vertexCount,
+                                               u32                     cacheSize,
+                                               f32                     threshold)
+    {
+        const u32                    triangleCount = indices.size() / 3;
+        std::vector<TriangleCluster> clusters;
+        FifoCache                    cache(vertexCount, cacheSize);
+
+        for (u32 i = 0; i < hardBoundaries.size(); i++)
+        {
+            const u32 begin = hardBoundaries[i];
+            const u32 end   = i + 1 < hardBoundaries.size() ? hardBoundaries[i + 1] : triangleCount;
+
+            // ACMR of the whole hard cluster
+            u32 clusterMisses = 0;
+            cache.Flush();
+            for (u32 index = begin * 3; index < end * 3; index++)
+            {
+                clusterMisses += cache.Access(indices[index]);
+            }
+
+            const f32 clusterACMR = (f32)clusterMisses / (f32)(end - begin);
+
+            // Start a new cluster as soon as the running ACMR is good enough
+            u32 softBegin = begin;
+            u32 misses    = 0;
+            cache.Flush();
+
+            for (u32 triangle = begin; triangle < end; triangle++)
+            {
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    misses += cache.Access(indices[(triangle * 3) + corner]);
+                }
+
+                const f32 runningACMR = (f32)misses / (f32)(triangle + 1 - softBegin);
+                if (triangle + 1 < end && runningACMR <= clusterACMR * threshold)
+                {
+                    clusters.push_back({ .Begin = softBegin, .End = triangle + 1 });
+                    softBegin = triangle + 1;
+                    misses    = 0;
+                    cache.Flush();
+                }
+            }
+
+            clusters.push_back({ .Begin = softBegin, .End = end });
+        }
+
+        return clusters;
+    }
+
+    void LogPass(std::string_view pass, const VertexCacheStats& before, const VertexCacheStats& after)
+    {
+        LOG_INFO("Mesh optimizer: {} ... (ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f})",
+                 pass,
+                 before.GetACMR(),
+                 after.GetACMR(),
+                 before.GetATVR(),
+                 after.GetATVR());
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const u32> indices, u32 cacheSize)
+    {
+        const u32         vertexCount = GetVertexCount(indices);
+        FifoCache         cache(vertexCount, cacheSize);
+        std::vector<bool> referenced(vertexCount, false);
+        VertexCacheStats  stats{ .TriangleCount = (u32)(indices.size() / 3) };
+
+        for (const u32 index : indices)
+        {
+            stats.TransformedVertices += cache.Access(index);
+
+            if (!referenced[index])
+            {
+                referenced[index] = true;
+                stats.VertexCount++;
+            }
+        }
+
+        return stats;
+    }
+
+    void MeshOptimizer::Optimize(Mesh& mesh, u32 cacheSize)
+    {
+        const auto             startClock = std::chrono::high_resolution_clock::now();
+        const VertexCacheStats before     = AnalyzeVertexCache(mesh.Indices, cacheSize);
+        const u64              vertices   = mesh.Vertices.size();
+
+        OptimizeVertexCache(mesh, cacheSize);
+        OptimizeOverdraw(mesh, cacheSize);
+        OptimizeVertexFetch(mesh);
+
+        const VertexCacheStats after    = AnalyzeVertexCache(mesh.Indices, cacheSize);
+        const auto             endClock = std::chrono::high_resolution_clock::now();
+
+        LOG_INFO("Optimized mesh ...");
+        LOG_TABLE_BEGIN(5);
+        LOG_TABLE_COLUMN("Triangles", "{}", after.TriangleCount);
+        LOG_TABLE_COLUMN("Vertices", "{} -> {}", vertices, mesh.Vertices.size());
+        LOG_TABLE_COLUMN("ACMR", "{:.3f} -> {:.3f}", before.GetACMR(), after.GetACMR());
+        LOG_TABLE_COLUMN("ATVR", "{:.3f} -> {:.3f}", before.GetATVR(), after.GetATVR());
+        LOG_TABLE_COLUMN("Cache size", "{}", cacheSize);
+        LOG_TABLE_END();
+        LOG_PERF("Mesh optimization took {} ...",
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()));
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(Mesh& mesh, u32 cacheSize)
+    {
+        OptimizeVertexCache(mesh.Indices, cacheSize);
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::vector<u32>& indices, u32 cacheSize)
+    {
+        ASSERT(indices.size() % 3 == 0, "Mesh optimizer expects a triangle list!");
+
+        const VertexCacheStats before = AnalyzeVertexCache(indices, cacheSize);
+
+        indices = Tipsify(indices, GetVertexCount(indices), cacheSize);
+
+        LogPass("Vertex cache", before, AnalyzeVertexCache(indices, cacheSize));
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(Mesh& mesh, u32 cacheSize, f32 threshold)
+    {
+        ASSERT(mesh.Indices.size() % 3 == 0, "Mesh optimizer expects a triangle list!");
+
+        if (mesh.Indices.empty())
+        {
+            return;
+        }
+
+        const VertexCacheStats before      = AnalyzeVertexCache(mesh.Indices, cacheSize);
+        const u32              vertexCount = GetVertexCount(mesh.Indices);
+
+        std::vector<TriangleCluster> clusters =
+            SplitClusters(mesh.Indices,
+                          FindHardBoundaries(mesh.Indices, vertexCount, cacheSize),
+                          vertexCount,
+                          cacheSize,
+                          threshold);
+
+        // Area weighted centroid and normal of every cluster (counter-clockwise front faces, as in .obj files)
+        std::vector<glm::vec3> centroids(clusters.size());
+        std::vector<glm::vec3> normals(clusters.size());
+        glm::vec3              meshCentroid(0.0f);
+        f32                    meshArea = 0.0f;
+
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            glm::vec3 centroid(0.0f);
+            glm::vec3 normal(0.0f);
+            f32       area = 0.0f;
+
+            for (u32 triangle = clusters[i].Begin; triangle < clusters[i].End; triangle++)
+            {
+                const glm::vec3& a = mesh.Vertices[mesh.Indices[(triangle * 3) + 0]].Position;
+                const glm::vec3& b = mesh.Vertices[mesh.Indices[(triangle * 3) + 1]].Position;
+                const glm::vec3& c = mesh.Vertices[mesh.Indices[(triangle * 3) + 2]].Position;
+
+                const glm::vec3 cross        = glm::cross(b - a, c - a);
+                const f32       triangleArea = glm::length(cross);
+
+                centroid += (a + b + c) * (triangleArea / 3.0f);
+                normal += cross;
+                area += triangleArea;
+            }
+
+            meshCentroid += centroid;
+            meshArea += area;
+
+            centroids[i] = area > 0.0f ? centroid / area : centroid;
+            normals[i]   = glm::length(normal) > 0.0f ? glm::normalize(normal) : normal;
+        }
+
+        meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+        // Clusters facing away from the center are likely to occlude the others, so they get drawn first
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            clusters[i].Sort = glm::dot(centroids[i] - meshCentroid, normals[i]);
+        }
+
+        std::stable_sort(clusters.begin(),
+                         clusters.end(),
+                         [](const TriangleCluster& lhs, const TriangleCluster& rhs) { return lhs.Sort > rhs.Sort; });
+
+        std::vector<u32> indices;
+        indices.reserve(mesh.Indices.size());
+
+        for (const auto& cluster : clusters)
+        {
+            indices.insert(indices.end(),
+                           mesh.Indices.begin() + (cluster.Begin * 3),
+                           mesh.Indices.begin() + (cluster.End * 3));
+        }
+
+        mesh.Indices = std::move(indices);
+
+        LOG_VERBOSE("Mesh optimizer: Sorted {} clusters for overdraw ...", clusters.size());
+        LogPass("Overdraw", before, AnalyzeVertexCache(mesh.Indices, cacheSize));
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(Mesh& mesh)
+    {
+        const VertexCacheStats before = AnalyzeVertexCache(mesh.Indices, DEFAULT_CACHE_SIZE);
+
+        std::vector<u32>    remap(mesh.Vertices.size(), INVALID_VERTEX);
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.Vertices.size());
+
+        for (u32& index : mesh.Indices)
+        {
+            if (remap[index] == INVALID_VERTEX)
+            {
+                remap[index] = (u32)vertices.size();
+                vertices.push_back(mesh.Vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        LOG_VERBOSE("Mesh optimizer: Vertex fetch ... (Vertices: {} -> {})", mesh.Vertices.size(), vertices.size());
+        mesh.Vertices = std::move(vertices);
+
+        LogPass("Vertex fetch", before, AnalyzeVertexCache(mesh.Indices, DEFAULT_CACHE_SIZE));
+    }
+}
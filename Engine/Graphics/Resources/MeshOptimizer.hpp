@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Result of simulating a FIFO post-transform vertex cache over an index buffer
+    struct VertexCacheStats
+    {
+        u32 TransformedVertices = 0;
+        u32 TriangleCount       = 0;
+        u32 VertexCount         = 0; // Unique referenced vertices
+
+        // Average cache miss ratio (transformed vertices per triangle, 0.5 is optimal for regular grids, 3 is worst)
+        [[nodiscard]] f32 GetACMR() const
+        {
+            return TriangleCount > 0 ? (f32)TransformedVertices / (f32)TriangleCount : 0.0f;
+        }
+
+        // Average transform to vertex ratio (1 is optimal, every vertex gets transformed exactly once)
+        [[nodiscard]] f32 GetATVR() const
+        {
+            return VertexCount > 0 ? (f32)TransformedVertices / (f32)VertexCount : 0.0f;
+        }
+    };
+
+    class MeshOptimizer
+    {
+    public:
+        MeshOptimizer() = delete;
+
+        // Matches the post-transform cache size most desktop GPUs behave like
+        static constexpr u32 DEFAULT_CACHE_SIZE = 16;
+
+        // Overdraw pass may raise the ACMR of a cluster by at most this factor when splitting it
+        static constexpr f32 DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+        [[nodiscard]] static VertexCacheStats AnalyzeVertexCache(std::span<const u32> indices,
+                                                                 u32                  cacheSize = DEFAULT_CACHE_SIZE);
+
+        // Runs all passes in order: vertex cache, overdraw and vertex fetch
+        static void Optimize(Mesh& mesh, u32 cacheSize = DEFAULT_CACHE_SIZE);
+
+        // Reorders triangles for the post-transform cache (Tipsify, Sander et al. 2007)
+        static void OptimizeVertexCache(Mesh& mesh, u32 cacheSize = DEFAULT_CACHE_SIZE);
+        static void OptimizeVertexCache(std::vector<u32>& indices, u32 cacheSize = DEFAULT_CACHE_SIZE);
+
+        // Splits the triangle order into clusters at cache discontinuities and sorts them by a view independent
+        // occlusion metric, so outward facing clusters get drawn first. Expects a vertex cache optimized order.
+        static void OptimizeOverdraw(Mesh& mesh,
+                                     u32  cacheSize = DEFAULT_CACHE_SIZE,
+                                     f32  threshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+        // Remaps vertices into the order of their first use and drops unreferenced ones
+        static void OptimizeVertexFetch(Mesh& mesh);
+    };
+}
@@ -0,0 +1,577 @@
+#include "MeshSimplifier.hpp"
+
+#include "Core/FlatHashMap.hpp"
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Resources/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <queue>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+    using namespace Engine::Graphics;
+
+    // Boundary and attribute seam edges get constrained by planes perpendicular to their triangle. The weight is
+    // relative to the surface planes, higher values keep silhouettes and texture seams in place for longer.
+    constexpr f64 BOUNDARY_WEIGHT = 10.0;
+
+    // Collapses that rotate any triangle normal by more than ~80 degrees get rejected to prevent fold-overs
+    constexpr f32 MIN_NORMAL_DOT = 0.15f;
+
+    // Symmetric 4x4 matrix measuring the squared distance to a set of weighted planes
+    struct Quadric
+    {
+        f64 XX = 0.0, XY = 0.0, XZ = 0.0, XW = 0.0;
+        f64 YY = 0.0, YZ = 0.0, YW = 0.0;
+        f64 ZZ = 0.0, ZW = 0.0;
+        f64 WW     = 0.0;
+        f64 Weight = 0.0;
+
+        static Quadric FromPlane(const glm::vec3& normal, f32 distance, f64 weight)
+        {
+            const f64 a = normal.x;
+            const f64 b = normal.y;
+            const f64 c = normal.z;
+            const f64 d = distance;
+
+            return { .XX     = weight * a * a,
+                     .XY     = weight * a * b,
+                     .XZ     = weight * a * c,
+                     .XW     = weight * a * d,
+                     .YY     = weight * b * b,
+                     .YZ     = weight * b * c,
+                     .YW     = weight * b * d,
+                     .ZZ     = weight * c * c,
+                     .ZW     = weight * c * d,
+                     .WW     = weight * d * d,
+                     .Weight = weight };
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            XX += other.XX;
+            XY += other.XY;
+            XZ += other.XZ;
+            XW += other.XW;
+            YY += other.YY;
+            YZ += other.YZ;
+            YW += other.YW;
+            ZZ += other.ZZ;
+            ZW += other.ZW;
+            WW += other.WW;
+            Weight += other.Weight;
+            return *this;
+        }
+
+        // Weighted average of the squared plane distances
+        [[nodiscard]] f64 Evaluate(const glm::vec3& position) const
+        {
+            const f64 x = position.x;
+            const f64 y = position.y;
+            const f64 z = position.z;
+
+            const f64 error = (XX * x * x) + (YY * y * y) + (ZZ * z * z) + WW
+                            + (2.0 * ((XY * x * y) + (XZ * x * z) + (YZ * y * z)))
+                            + (2.0 * ((XW * x) + (YW * y) + (ZW * z)));
+
+            return Weight > 0.0 ? std::max(error, 0.0) / Weight : 0.0;
+        }
+    };
+
+    struct Collapse
+    {
+        f64 Cost        = 0.0;
+        u32 From        = 0;
+        u32 To          = 0;
+        u32 FromVersion = 0;
+        u32 ToVersion   = 0;
+
+        bool operator>(const Collapse& other) const { return Cost > other.Cost; }
+    };
+
+    using Triangle = std::array<u32, 3>;
+
+    // Collapses work on position classes (all vertices sharing a position), so attribute seams don't block the
+    // simplification. The class of a vertex is identified by the first vertex with that position.
+    class QuadricSimplifier
+    {
+    public:
+        QuadricSimplifier(std::span<const Vertex> vertices, std::span<const u32> indices) : m_Vertices(vertices)
+        {
+            ASSERT(indices.size() % 3 == 0, "Mesh simplifier expects a triangle list!");
+
+            const u32 vertexCount = vertices.size();
+            WeldPositions();
+
+            m_Versions.assign(vertexCount, 0);
+            m_Quadrics.assign(vertexCount, {});
+            m_VertexTriangles.resize(vertexCount);
+
+            // Triangles collapsed by the welding can't be represented anymore
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                const Triangle corners = { indices[i + 0], indices[i + 1], indices[i + 2] };
+                const Triangle classes = { m_Class[corners[0]], m_Class[corners[1]], m_Class[corners[2]] };
+
+                if (classes[0] != classes[1] && classes[1] != classes[2] && classes[2] != classes[0])
+                {
+                    m_Corners.push_back(corners);
+                    m_Triangles.push_back(classes);
+                }
+            }
+
+            m_Alive.assign(m_Triangles.size(), true);
+            m_LiveTriangles = m_Triangles.size();
+
+            for (u32 triangle = 0; triangle < m_Triangles.size(); triangle++)
+            {
+                for (const u32 vertex : m_Triangles[triangle])
+                {
+                    m_VertexTriangles[vertex].push_back(triangle);
+                }
+            }
+
+            ComputeQuadrics();
+
+            for (const Triangle& triangle : m_Triangles)
+            {
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    PushCollapse(triangle[corner], triangle[(corner + 1) % 3]);
+                    PushCollapse(triangle[(corner + 1) % 3], triangle[corner]);
+                }
+            }
+        }
+
+        // Can be called repeatedly with decreasing targets to build a chain of levels in one go
+        void Run(u32 targetTriangleCount, f32 maxError)
+        {
+            const f64 maxCost = (f64)maxError * (f64)maxError;
+
+            while (m_LiveTriangles > targetTriangleCount && !m_Queue.empty())
+            {
+                const Collapse collapse = m_Queue.top();
+
+                if (collapse.FromVersion != m_Versions[collapse.From] || collapse.ToVersion != m_Versions[collapse.To])
+                {
+                    m_Queue.pop();
+                    continue;
+                }
+
+                // Leave it in the queue, a later run might allow a larger error
+                if (collapse.Cost > maxCost)
+                {
+                    break;
+                }
+
+                m_Queue.pop();
+
+                if (IsValid(collapse))
+                {
+                    Apply(collapse);
+                }
+            }
+        }
+
+        [[nodiscard]] std::vector<u32> Extract() const
+        {
+            std::vector<u32> indices;
+            indices.reserve((size_t)m_LiveTriangles * 3);
+
+            for (u32 triangle = 0; triangle < m_Triangles.size(); triangle++)
+            {
+                if (!m_Alive[triangle])
+                {
+                    continue;
+                }
+
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    const u32 vertex   = m_Corners[triangle][corner];
+                    const u32 position = m_Triangles[triangle][corner];
+
+                    // Untouched corners keep their vertex, moved ones take the best matching vertex at the target
+                    indices.push_back(m_Class[vertex] == position ? vertex : FindClosestVertex(position, vertex));
+                }
+            }
+
+            return indices;
+        }
+
+        [[nodiscard]] f32 GetError() const { return (f32)std::sqrt(m_MaxCost); }
+
+    private:
+        void WeldPositions()
+        {
+            const u32 vertexCount = m_Vertices.size();
+
+            Core::FlatHashMap<glm::vec3, u32, Core::BitwiseHash<glm::vec3>, Core::BitwiseEqual<glm::vec3>> classes(
+                vertexCount);
+
+            m_Class.resize(vertexCount);
+            for (u32 vertex = 0; vertex < vertexCount; vertex++)
+            {
+                m_Class[vertex] = classes.FindOrInsert(m_Vertices[vertex].Position, vertex).Entry;
+            }
+
+            // Members of every class in compressed row storage
+            std::vector<u32> counts(vertexCount, 0);
+            for (const u32 position : m_Class)
+            {
+                counts[position]++;
+            }
+
+            m_ClassOffsets.assign(vertexCount + 1, 0);
+            std::inclusive_scan(counts.begin(), counts.end(), m_ClassOffsets.begin() + 1);
+
+            std::vector<u32> cursors(m_ClassOffsets.begin(), m_ClassOffsets.end() - 1);
+            m_ClassMembers.resize(vertexCount);
+            for (u32 vertex = 0; vertex < vertexCount; vertex++)
+            {
+                m_ClassMembers[cursors[m_Class[vertex]]++] = vertex;
+            }
+        }
+
+        void ComputeQuadrics()
+        {
+            // Half-edges between position classes, mapped to the vertices they connect
+            Core::FlatHashMap<u64, std::array<u32, 2>> halfEdges(m_Triangles.size() * 3);
+
+            for (u32 triangle = 0; triangle < m_Triangles.size(); triangle++)
+            {
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    const u32 next = (corner + 1) % 3;
+                    halfEdges.FindOrInsert(GetEdgeKey(m_Triangles[triangle][corner], m_Triangles[triangle][next]),
+                                           { m_Corners[triangle][corner], m_Corners[triangle][next] });
+                }
+            }
+
+            for (u32 triangle = 0; triangle < m_Triangles.size(); triangle++)
+            {
+                const Triangle& classes = m_Triangles[triangle];
+                const Triangle& corners = m_Corners[triangle];
+
+                const glm::vec3 cross  = glm::cross(GetPosition(classes[1]) - GetPosition(classes[0]),
+                                                    GetPosition(classes[2]) - GetPosition(classes[0]));
+                const f32       length = glm::length(cross);
+
+                if (length <= 0.0f)
+                {
+                    continue;
+                }
+
+                // Area weighted plane of the triangle
+                const glm::vec3 normal  = cross / length;
+                const Quadric   surface = Quadric::FromPlane(
+                    normal, -glm::dot(normal, GetPosition(classes[0])), (f64)length * 0.5);
+
+                for (const u32 vertex : classes)
+                {
+                    m_Quadrics[vertex] += surface;
+                }
+
+                // Open edges and edges whose opposite side uses different vertices (texture seams, hard edges)
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    const u32 next = (corner + 1) % 3;
+
+                    const std::array<u32, 2>* opposite = halfEdges.Find(GetEdgeKey(classes[next], classes[corner]));
+                    if (opposite != nullptr && (*opposite)[0] == corners[next] && (*opposite)[1] == corners[corner])
+                    {
+                        continue;
+                    }
+
+                    const glm::vec3 edge       = GetPosition(classes[next]) - GetPosition(classes[corner]);
+                    const glm::vec3 edgeNormal = glm::cross(edge, normal);
+                    const f32       edgeLength = glm::length(edgeNormal);
+
+                    if (edgeLength <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    const glm::vec3 planeNormal = edgeNormal / edgeLength;
+                    const Quadric   boundary =
+                        Quadric::FromPlane(planeNormal,
+                                           -glm::dot(planeNormal, GetPosition(classes[corner])),
+                                           BOUNDARY_WEIGHT * (f64)glm::dot(edge, edge));
+
+                    m_Quadrics[classes[corner]] += boundary;
+                    m_Quadrics[classes[next]] += boundary;
+                }
+            }
+        }
+
+        void PushCollapse(u32 from, u32 to)
+        {
+            Quadric quadric = m_Quadrics[from];
+            quadric += m_Quadrics[to];
+
+            m_Queue.push({ .Cost        = quadric.Evaluate(GetPosition(to)),
+                           .From        = from,
+                           .To          = to,
+                           .FromVersion = m_Versions[from],
+                           .ToVersion   = m_Versions[to] });
+        }
+
+        [[nodiscard]] b8 IsValid(const Collapse& collapse)
+        {
+            const glm::vec3& target = GetPosition(collapse.To);
+
+            m_FromNeighbors.clear();
+            m_ToNeighbors.clear();
+            u32 sharedTriangles = 0;
+
+            for (const u32 triangle : m_VertexTriangles[collapse.From])
+            {
+                if (!m_Alive[triangle])
+                {
+                    continue;
+                }
+
+                const Triangle& classes = m_Triangles[triangle];
+                m_FromNeighbors.insert(m_FromNeighbors.end(), classes.begin(), classes.end());
+
+                if (std::find(classes.begin(), classes.end(), collapse.To) != classes.end())
+                {
+                    sharedTriangles++;
+                    continue;
+                }
+
+                // Triangles that survive the collapse must not flip or degenerate
+                std::array<glm::vec3, 3> before{};
+                std::array<glm::vec3, 3> after{};
+
+                for (u32 corner = 0; corner < 3; corner++)
+                {
+                    before[corner] = GetPosition(classes[corner]);
+                    after[corner]  = classes[corner] == collapse.From ? target : before[corner];
+                }
+
+                const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                const glm::vec3 normalAfter  = glm::cross(after[1] - after[0], after[2] - after[0]);
+                const f32       lengthAfter  = glm::length(normalAfter);
+
+                if (lengthAfter <= 0.0f
+                    || glm::dot(normalBefore, normalAfter) < MIN_NORMAL_DOT * glm::length(normalBefore) * lengthAfter)
+                {
+                    return false;
+                }
+            }
+
+            for (const u32 triangle : m_VertexTriangles[collapse.To])
+            {
+                if (m_Alive[triangle])
+                {
+                    const Triangle& classes = m_Triangles[triangle];
+                    m_ToNeighbors.insert(m_ToNeighbors.end(), classes.begin(), classes.end());
+                }
+            }
+
+            // Link condition: Both vertices may only share the neighbors opposite of their common triangles,
+            // everything else would pinch the surface into a non-manifold shape
+            std::sort(m_FromNeighbors.begin(), m_FromNeighbors.end());
+            std::sort(m_ToNeighbors.begin(), m_ToNeighbors.end());
+            m_FromNeighbors.erase(std::unique(m_FromNeighbors.begin(), m_FromNeighbors.end()), m_FromNeighbors.end());
+            m_ToNeighbors.erase(std::unique(m_ToNeighbors.begin(), m_ToNeighbors.end()), m_ToNeighbors.end());
+
+            u32 sharedNeighbors = 0;
+            for (auto from = m_FromNeighbors.begin(), to = m_ToNeighbors.begin();
+                 from != m_FromNeighbors.end() && to != m_ToNeighbors.end();)
+            {
+                if (*from < *to)
+                {
+                    ++from;
+                }
+                else if (*to < *from)
+                {
+                    ++to;
+                }
+                else
+                {
+                    sharedNeighbors += *from != collapse.From && *from != collapse.To;
+                    ++from;
+                    ++to;
+                }
+            }
+
+            return sharedTriangles > 0 && sharedNeighbors <= sharedTriangles;
+        }
+
+        void Apply(const Collapse& collapse)
+        {
+            m_Quadrics[collapse.To] += m_Quadrics[collapse.From];
+            m_MaxCost = std::max(m_MaxCost, collapse.Cost);
+
+            for (const u32 triangle : m_VertexTriangles[collapse.From])
+            {
+                if (!m_Alive[triangle])
+                {
+                    continue;
+                }
+
+                Triangle& classes = m_Triangles[triangle];
+
+                if (std::find(classes.begin(), classes.end(), collapse.To) != classes.end())
+                {
+                    m_Alive[triangle] = false;
+                    m_LiveTriangles--;
+                    continue;
+                }
+
+                std::replace(classes.begin(), classes.end(), collapse.From, collapse.To);
+                m_VertexTriangles[collapse.To].push_back(triangle);
+            }
+
+            m_VertexTriangles[collapse.From].clear();
+            m_Versions[collapse.From]++;
+            m_Versions[collapse.To]++;
+
+            // Drop dead triangles and requeue every edge around the merged vertex with its new quadric
+            std::vector<u32>& triangles = m_VertexTriangles[collapse.To];
+            std::erase_if(triangles, [this](u32 triangle) { return !m_Alive[triangle]; });
+
+            for (const u32 triangle : triangles)
+            {
+                for (const u32 vertex : m_Triangles[triangle])
+                {
+                    if (vertex != collapse.To)
+                    {
+                        PushCollapse(collapse.To, vertex);
+                        PushCollapse(vertex, collapse.To);
+                    }
+                }
+            }
+        }
+
+        // Vertex of a position class whose attributes are closest to the given vertex
+        [[nodiscard]] u32 FindClosestVertex(u32 position, u32 vertex) const
+        {
+            const Vertex& reference = m_Vertices[vertex];
+
+            u32 closest     = position;
+            f32 minDistance = FLT_MAX;
+
+            for (u32 i = m_ClassOffsets[position]; i < m_ClassOffsets[position + 1]; i++)
+            {
+                const Vertex&   candidate = m_Vertices[m_ClassMembers[i]];
+                const glm::vec2 texCoord  = candidate.TexCoord - reference.TexCoord;
+                const glm::vec3 color     = candidate.Color - reference.Color;
+                const f32       distance  = glm::dot(texCoord, texCoord) + glm::dot(color, color);
+
+                if (distance < minDistance)
+                {
+                    minDistance = distance;
+                    closest     = m_ClassMembers[i];
+                }
+            }
+
+            return closest;
+        }
+
+        [[nodiscard]] const glm::vec3& GetPosition(u32 vertex) const { return m_Vertices[vertex].Position; }
+
+        [[nodiscard]] static u64 GetEdgeKey(u32 from, u32 to) { return ((u64)from << 32) | to; }
+
+        std::span<const Vertex> m_Vertices;
+
+        // Position classes
+        std::vector<u32> m_Class;
+        std::vector<u32> m_ClassOffsets;
+        std::vector<u32> m_ClassMembers;
+
+        // Per position class, versions invalidate queued collapses once a quadric or neighborhood changes
+        std::vector<u32>              m_Versions;
+        std::vector<Quadric>          m_Quadrics;
+        std::vector<std::vector<u32>> m_VertexTriangles;
+
+        // Per triangle, classes get updated by collapses while corners keep the original vertices
+        std::vector<Triangle> m_Triangles;
+        std::vector<Triangle> m_Corners;
+        std::vector<bool>     m_Alive;
+        u32                   m_LiveTriangles = 0;
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> m_Queue;
+        f64                                                                  m_MaxCost = 0.0;
+
+        // Scratch buffers for the link condition
+        std::vector<u32> m_FromNeighbors;
+        std::vector<u32> m_ToNeighbors;
+    };
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    SimplifiedIndices MeshSimplifier::Simplify(std::span<const Vertex> vertices,
+                                               std::span<const u32>    indices,
+                                               u32                     targetIndexCount,
+                                               f32                     maxError)
+    {
+        QuadricSimplifier simplifier(vertices, indices);
+        simplifier.Run(targetIndexCount / 3, maxError);
+
+        return { .Indices = simplifier.Extract(), .Error = simplifier.GetError() };
+    }
+
+    void MeshSimplifier::GenerateLods(Mesh& mesh, std::span<const f32> ratios)
+    {
+        ASSERT(mesh.Lods.empty(), "Mesh already has levels of detail!");
+
+        const auto startClock = std::chrono::high_resolution_clock::now();
+        const u32  indexCount = mesh.Indices.size();
+
+        mesh.Lods.push_back({ .IndexOffset = 0, .IndexCount = indexCount, .Error = 0.0f });
+
+        // One simplifier for the whole chain, every level continues where the previous one stopped
+        QuadricSimplifier simplifier(mesh.Vertices, mesh.Indices);
+
+        for (const f32 ratio : ratios)
+        {
+            simplifier.Run((u32)((f32)(indexCount / 3) * ratio), FLT_MAX);
+
+            std::vector<u32> indices  = simplifier.Extract();
+            const MeshLod&   previous = mesh.Lods.back();
+
+            if ((f32)indices.size() > (f32)previous.IndexCount * (1.0f - MIN_LOD_REDUCTION))
+            {
+                LOG_WARN("Mesh simplifier: Can't reduce level {} any further ... Stopping", mesh.Lods.size() - 1);
+                break;
+            }
+
+            MeshOptimizer::OptimizeVertexCache(indices);
+
+            mesh.Lods.push_back({ .IndexOffset = (u32)mesh.Indices.size(),
+                                  .IndexCount  = (u32)indices.size(),
+                                  .Error       = simplifier.GetError() });
+            mesh.Indices.insert(mesh.Indices.end(), indices.begin(), indices.end());
+        }
+
+        const auto endClock = std::chrono::high_resolution_clock::now();
+
+        LOG_INFO("Generated {} levels of detail ...", mesh.Lods.size());
+        for (size_t i = 0; i < mesh.Lods.size(); i++)
+        {
+            LOG_INFO("LOD {} ... (Triangles: {}, Ratio: {:.3f}, Error: {:.6f})",
+                     i,
+                     mesh.Lods[i].IndexCount / 3,
+                     (f32)mesh.Lods[i].IndexCount / (f32)indexCount,
+                     mesh.Lods[i].Error);
+        }
+
+        LOG_PERF("Mesh simplification took {} ...",
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()));
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include <array>
+#include <cfloat>
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    struct SimplifiedIndices
+    {
+        std::vector<u32> Indices;
+        f32              Error = 0.0f; // Approximate deviation from the input in model space units
+    };
+
+    // Edge collapse simplification guided by quadric error metrics (Garland and Heckbert 1997). Vertices only
+    // collapse onto existing vertices, so simplified index buffers keep referencing the original vertex buffer.
+    class MeshSimplifier
+    {
+    public:
+        MeshSimplifier() = delete;
+
+        // Triangle count of every generated level relative to level 0
+        static constexpr std::array<f32, 3> DEFAULT_LOD_RATIOS = { 0.5f, 0.25f, 0.125f };
+
+        // Stop generating levels once a level removes less than this fraction of the previous one
+        static constexpr f32 MIN_LOD_REDUCTION = 0.1f;
+
+        // Collapses edges until at most 'targetIndexCount' indices are left or the next collapse would exceed
+        // 'maxError' (model space units). Stops early if no valid collapse is left.
+        [[nodiscard]] static SimplifiedIndices Simplify(std::span<const Vertex> vertices,
+                                                        std::span<const u32>    indices,
+                                                        u32                     targetIndexCount,
+                                                        f32                     maxError = FLT_MAX);
+
+        // Appends a chain of simplified levels behind the mesh indices and fills out mesh.Lods.
+        // Every level is vertex cache optimized on its own, so this should run after MeshOptimizer::Optimize.
+        static void GenerateLods(Mesh& mesh, std::span<const f32> ratios = DEFAULT_LOD_RATIOS);
+    };
+}
@@ -0,0 +1,433 @@
+#include "ShaderReflection.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+    using namespace Engine::Graphics;
+
+    constexpr u32 SPIRV_MAGIC        = 0x07230203;
+    constexpr u32 SPIRV_HEADER_WORDS = 5;
+    constexpr u32 SPIRV_UNDEFINED    = std::numeric_limits<u32>::max();
+
+    // Opcodes, decorations and storage classes of the SPIR-V specification, only what the reflection looks at
+    namespace SpirvOp
+    {
+        constexpr u16 TYPE_INT           = 21;
+        constexpr u16 TYPE_FLOAT         = 22;
+        constexpr u16 TYPE_VECTOR        = 23;
+        constexpr u16 TYPE_MATRIX        = 24;
+        constexpr u16 TYPE_IMAGE         = 25;
+        constexpr u16 TYPE_SAMPLER       = 26;
+        constexpr u16 TYPE_SAMPLED_IMAGE = 27;
+        constexpr u16 TYPE_ARRAY         = 28;
+        constexpr u16 TYPE_RUNTIME_ARRAY = 29;
+        constexpr u16 TYPE_STRUCT        = 30;
+        constexpr u16 TYPE_POINTER       = 32;
+        constexpr u16 CONSTANT           = 43;
+        constexpr u16 VARIABLE           = 59;
+        constexpr u16 DECORATE           = 71;
+        constexpr u16 MEMBER_DECORATE    = 72;
+        constexpr u16 TYPE_ACCELERATION  = 5341;
+    }
+
+    namespace SpirvDecoration
+    {
+        constexpr u32 BUFFER_BLOCK   = 3;
+        constexpr u32 ARRAY_STRIDE   = 6;
+        constexpr u32 MATRIX_STRIDE  = 7;
+        constexpr u32 BINDING        = 33;
+        constexpr u32 DESCRIPTOR_SET = 34;
+        constexpr u32 OFFSET         = 35;
+    }
+
+    namespace SpirvStorageClass
+    {
+        constexpr u32 UNIFORM_CONSTANT = 0;
+        constexpr u32 UNIFORM          = 2;
+        constexpr u32 PUSH_CONSTANT    = 9;
+        constexpr u32 STORAGE_BUFFER   = 12;
+    }
+
+    constexpr u32 SPIRV_DIM_BUFFER       = 5;
+    constexpr u32 SPIRV_DIM_SUBPASS_DATA = 6;
+
+    // Everything known about an id after one pass over the module
+    struct SpirvId
+    {
+        u16 Opcode       = 0;
+        u32 Type         = 0; // Component, column, element, pointee or result type
+        u32 StorageClass = 0; // Pointers and variables
+        u32 Value        = 0; // Constant value, array length id, scalar width, vector or column count, image dim
+        u32 Sampled      = 0; // Images: 1 = sampled, 2 = storage
+
+        u32 Set         = SPIRV_UNDEFINED;
+        u32 Binding     = SPIRV_UNDEFINED;
+        u32 ArrayStride = 0;
+        b8  BufferBlock = false;
+
+        std::vector<u32> Members;             // Struct member types
+        std::vector<u32> MemberOffsets;       // Filled by member decorations, which come before the types
+        std::vector<u32> MemberMatrixStrides; // Same
+    };
+
+    void SetMemberDecoration(std::vector<u32>& decorations, u32 member, u32 value)
+    {
+        if (decorations.size() <= member)
+        {
+            decorations.resize(member + 1, 0);
+        }
+
+        decorations[member] = value;
+    }
+
+    std::vector<SpirvId> ParseModule(std::span<const u32> code)
+    {
+        ASSERT(code.size() >= SPIRV_HEADER_WORDS && code[0] == SPIRV_MAGIC, "Shader code isn't valid SPIR-V!");
+
+        std::vector<SpirvId> ids(code[3]); // Id bound from the header
+
+        for (u64 offset = SPIRV_HEADER_WORDS; offset < code.size();)
+        {
+            const u16 opcode    = (u16)(code[offset] & 0xFFFF);
+            const u32 wordCount = code[offset] >> 16;
+            ASSERT(wordCount > 0 && offset + wordCount <= code.size(), "SPIR-V instruction is truncated!");
+
+            const u32* operands = &code[offset + 1];
+            offset += wordCount;
+
+            switch (opcode)
+            {
+                case SpirvOp::DECORATE:
+                {
+                    SpirvId& target = ids[operands[0]];
+                    switch (operands[1])
+                    {
+                        case SpirvDecoration::BUFFER_BLOCK:
+                            target.BufferBlock = true;
+                            break;
+                        case SpirvDecoration::ARRAY_STRIDE:
+                            target.ArrayStride = operands[2];
+                            break;
+                        case SpirvDecoration::BINDING:
+                            target.Binding = operands[2];
+                            break;
+                        case SpirvDecoration::DESCRIPTOR_SET:
+                            target.Set = operands[2];
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+                }
+                case SpirvOp::MEMBER_DECORATE:
+                {
+                    SpirvId& target = ids[operands[0]];
+                    if (operands[2] == SpirvDecoration::OFFSET)
+                    {
+                        SetMemberDecoration(target.MemberOffsets, operands[1], operands[3]);
+                    }
+                    else if (operands[2] == SpirvDecoration::MATRIX_STRIDE)
+                    {
+                        SetMemberDecoration(target.MemberMatrixStrides, operands[1], operands[3]);
+                    }
+                    break;
+                }
+                case SpirvOp::TYPE_INT:
+                case SpirvOp::TYPE_FLOAT:
+                    ids[operands[0]].Opcode = opcode;
+                    ids[operands[0]].Value  = operands[1];
+                    break;
+                case SpirvOp::TYPE_VECTOR:
+                case SpirvOp::TYPE_MATRIX:
+                case SpirvOp::TYPE_ARRAY:
+                    ids[operands[0]].Opcode = opcode;
+                    ids[operands[0]].Type   = operands[1];
+                    ids[operands[0]].Value  = operands[2];
+                    break;
+                case SpirvOp::TYPE_IMAGE:
+                    ids[operands[0]].Opcode  = opcode;
+                    ids[operands[0]].Value   = operands[2];
+                    ids[operands[0]].Sampled = operands[6];
+                    break;
+                case SpirvOp::TYPE_SAMPLER:
+                case SpirvOp::TYPE_ACCELERATION:
+                    ids[operands[0]].Opcode = opcode;
+                    break;
+                case SpirvOp::TYPE_SAMPLED_IMAGE:
+                case SpirvOp::TYPE_RUNTIME_ARRAY:
+                    ids[operands[0]].Opcode = opcode;
+                    ids[operands[0]].Type   = operands[1];
+                    break;
+                case SpirvOp::TYPE_STRUCT:
+                    ids[operands[0]].Opcode = opcode;
+                    ids[operands[0]].Members.assign(operands + 1, operands + wordCount - 1);
+                    break;
+                case SpirvOp::TYPE_POINTER:
+                    ids[operands[0]].Opcode       = opcode;
+                    ids[operands[0]].StorageClass = operands[1];
+                    ids[operands[0]].Type         = operands[2];
+                    break;
+                case SpirvOp::CONSTANT:
+                    ids[operands[1]].Opcode = opcode;
+                    ids[operands[1]].Type   = operands[0];
+                    ids[operands[1]].Value  = operands[2]; // Low word is enough for array lengths
+                    break;
+                case SpirvOp::VARIABLE:
+                    ids[operands[1]].Opcode       = opcode;
+                    ids[operands[1]].Type         = operands[0];
+                    ids[operands[1]].StorageClass = operands[2];
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        return ids;
+    }
+
+    u32 GetStructSize(const std::vector<SpirvId>& ids, const SpirvId& type);
+
+    // Size of a type inside an explicitly laid out block, matrices need the stride of the member they belong to
+    u32 GetTypeSize(const std::vector<SpirvId>& ids, u32 typeId, u32 matrixStride)
+    {
+        const SpirvId& type = ids[typeId];
+
+        switch (type.Opcode)
+        {
+            case SpirvOp::TYPE_INT:
+            case SpirvOp::TYPE_FLOAT:
+                return type.Value / 8;
+            case SpirvOp::TYPE_VECTOR:
+                return type.Value * GetTypeSize(ids, type.Type, 0);
+            case SpirvOp::TYPE_MATRIX:
+                return type.Value * (matrixStride != 0 ? matrixStride : GetTypeSize(ids, type.Type, 0));
+            case SpirvOp::TYPE_ARRAY:
+            {
+                const u32 length = ids[type.Value].Value;
+                return length * (type.ArrayStride != 0 ? type.ArrayStride : GetTypeSize(ids, type.Type, matrixStride));
+            }
+            case SpirvOp::TYPE_STRUCT:
+                return GetStructSize(ids, type);
+            default:
+                return 0; // Runtime arrays take up no fixed space
+        }
+    }
+
+    u32 GetStructSize(const std::vector<SpirvId>& ids, const SpirvId& type)
+    {
+        u32 size = 0;
+
+        for (u32 member = 0; member < type.Members.size(); member++)
+        {
+            const u32 offset = member < type.MemberOffsets.size() ? type.MemberOffsets[member] : 0;
+            const u32 stride = member < type.MemberMatrixStrides.size() ? type.MemberMatrixStrides[member] : 0;
+            size             = std::max(size, offset + GetTypeSize(ids, type.Members[member], stride));
+        }
+
+        return size;
+    }
+
+    vk::DescriptorType GetDescriptorType(const SpirvId& variable, const SpirvId& type)
+    {
+        if (variable.StorageClass == SpirvStorageClass::STORAGE_BUFFER)
+        {
+            return vk::DescriptorType::eStorageBuffer;
+        }
+
+        // Older GLSL versions declare storage buffers as uniform blocks with a different decoration
+        if (variable.StorageClass == SpirvStorageClass::UNIFORM)
+        {
+            return type.BufferBlock ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBuffer;
+        }
+
+        switch (type.Opcode)
+        {
+            case SpirvOp::TYPE_SAMPLED_IMAGE:
+                return vk::DescriptorType::eCombinedImageSampler;
+            case SpirvOp::TYPE_SAMPLER:
+                return vk::DescriptorType::eSampler;
+            case SpirvOp::TYPE_ACCELERATION:
+                return vk::DescriptorType::eAccelerationStructureKHR;
+            case SpirvOp::TYPE_IMAGE:
+                if (type.Value == SPIRV_DIM_BUFFER)
+                {
+                    return type.Sampled == 2 ? vk::DescriptorType::eStorageTexelBuffer
+                                             : vk::DescriptorType::eUniformTexelBuffer;
+                }
+                if (type.Value == SPIRV_DIM_SUBPASS_DATA)
+                {
+                    return vk::DescriptorType::eInputAttachment;
+                }
+                return type.Sampled == 2 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+            default:
+                ASSERT(false, "Unknown descriptor type in SPIR-V (Opcode: {})!", type.Opcode);
+                return vk::DescriptorType::eUniformBuffer;
+        }
+    }
+
+    void AddBinding(ShaderReflection& reflection, u32 set, const vk::DescriptorSetLayoutBinding& binding)
+    {
+        if (reflection.Sets.size() <= set)
+        {
+            reflection.Sets.resize(set + 1);
+        }
+
+        std::vector<vk::DescriptorSetLayoutBinding>& bindings = reflection.Sets[set];
+
+        const auto existing = std::ranges::find(bindings, binding.binding, &vk::DescriptorSetLayoutBinding::binding);
+        if (existing != bindings.end())
+        {
+            ASSERT(existing->descriptorType == binding.descriptorType
+                       && existing->descriptorCount == binding.descriptorCount,
+                   "Stages disagree about set {}, binding {}!",
+                   set,
+                   binding.binding);
+
+            existing->stageFlags |= binding.stageFlags;
+            return;
+        }
+
+        const auto position = std::ranges::upper_bound(
+            bindings, binding.binding, {}, &vk::DescriptorSetLayoutBinding::binding);
+        bindings.insert(position, binding);
+    }
+
+    void AddPushConstantRange(ShaderReflection& reflection, const vk::PushConstantRange& range)
+    {
+        // Stages sharing the exact same block share a range, so one push updates all of them
+        for (vk::PushConstantRange& existing : reflection.PushConstantRanges)
+        {
+            ASSERT(!(existing.stageFlags & range.stageFlags), "Stage declares more than one push constant block!");
+
+            if (existing.offset == range.offset && existing.size == range.size)
+            {
+                existing.stageFlags |= range.stageFlags;
+                return;
+            }
+        }
+
+        reflection.PushConstantRanges.push_back(range);
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    ShaderReflection ShaderReflection::Reflect(std::span<const u32> code, vk::ShaderStageFlagBits stage)
+    {
+        const std::vector<SpirvId> ids = ParseModule(code);
+
+        ShaderReflection reflection;
+
+        for (const SpirvId& variable : ids)
+        {
+            if (variable.Opcode != SpirvOp::VARIABLE)
+            {
+                continue;
+            }
+
+            const SpirvId& pointee = ids[ids[variable.Type].Type];
+
+            if (variable.StorageClass == SpirvStorageClass::PUSH_CONSTANT)
+            {
+                const u32 offset = pointee.MemberOffsets.empty() ? 0 : std::ranges::min(pointee.MemberOffsets);
+                const u32 size   = GetStructSize(ids, pointee) - offset;
+
+                AddPushConstantRange(reflection, { .stageFlags = stage, .offset = offset, .size = size });
+                continue;
+            }
+
+            const b8 isResource = variable.StorageClass == SpirvStorageClass::UNIFORM_CONSTANT
+                                  || variable.StorageClass == SpirvStorageClass::UNIFORM
+                                  || variable.StorageClass == SpirvStorageClass::STORAGE_BUFFER;
+
+            if (!isResource || variable.Binding == SPIRV_UNDEFINED)
+            {
+                continue;
+            }
+
+            // Arrays of descriptors (possibly multidimensional) become a single binding
+            const SpirvId* type  = &pointee;
+            u32            count = 1;
+
+            while (type->Opcode == SpirvOp::TYPE_ARRAY || type->Opcode == SpirvOp::TYPE_RUNTIME_ARRAY)
+            {
+                ASSERT(type->Opcode == SpirvOp::TYPE_ARRAY,
+                       "Unsized descriptor arrays aren't supported (Binding: {})!",
+                       variable.Binding);
+
+                count *= ids[type->Value].Value;
+                type   = &ids[type->Type];
+            }
+
+            AddBinding(reflection,
+                       variable.Set == SPIRV_UNDEFINED ? 0 : variable.Set,
+                       { .binding         = variable.Binding,
+                         .descriptorType  = GetDescriptorType(variable, *type),
+                         .descriptorCount = count,
+                         .stageFlags      = stage });
+        }
+
+        return reflection;
+    }
+
+    void ShaderReflection::Merge(const ShaderReflection& other)
+    {
+        for (u32 set = 0; set < other.Sets.size(); set++)
+        {
+            for (const vk::DescriptorSetLayoutBinding& binding : other.Sets[set])
+            {
+                AddBinding(*this, set, binding);
+            }
+        }
+
+        for (const vk::PushConstantRange& range : other.PushConstantRanges)
+        {
+            AddPushConstantRange(*this, range);
+        }
+    }
+
+    void ShaderReflection::MakeDynamic(u32 set, u32 binding)
+    {
+        if (set >= Sets.size())
+        {
+            return;
+        }
+
+        for (vk::DescriptorSetLayoutBinding& layoutBinding : Sets[set])
+        {
+            if (layoutBinding.binding != binding)
+            {
+                continue;
+            }
+
+            if (layoutBinding.descriptorType == vk::DescriptorType::eUniformBuffer)
+            {
+                layoutBinding.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+            }
+            else if (layoutBinding.descriptorType == vk::DescriptorType::eStorageBuffer)
+            {
+                layoutBinding.descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+            }
+        }
+    }
+
+    const vk::DescriptorSetLayoutBinding* ShaderReflection::FindBinding(u32 set, u32 binding) const
+    {
+        if (set >= Sets.size())
+        {
+            return nullptr;
+        }
+
+        const auto layoutBinding = std::ranges::find(Sets[set], binding, &vk::DescriptorSetLayoutBinding::binding);
+        return layoutBinding != Sets[set].end() ? &*layoutBinding : nullptr;
+    }
+}
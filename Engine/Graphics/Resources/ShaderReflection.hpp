@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Resource interface of one or more shader stages, read straight from their SPIR-V
+    struct ShaderReflection
+    {
+        std::vector<std::vector<vk::DescriptorSetLayoutBinding>> Sets; // Indexed by set number, sorted by binding
+        std::vector<vk::PushConstantRange>                       PushConstantRanges; // At most one per stage
+
+        // Collects descriptor bindings and the push constant block of a single stage. Descriptor arrays keep their
+        // size, buffers come out as non-dynamic uniform or storage buffers.
+        [[nodiscard]] static ShaderReflection Reflect(std::span<const u32> code, vk::ShaderStageFlagBits stage);
+
+        // Adds the interface of other stages, bindings declared by several stages get their stage flags combined
+        void Merge(const ShaderReflection& other);
+
+        // Buffers whose offset gets supplied on binding (e.g. everything living in the frame allocator). Does
+        // nothing if the binding doesn't exist.
+        void MakeDynamic(u32 set, u32 binding);
+
+        [[nodiscard]] const vk::DescriptorSetLayoutBinding* FindBinding(u32 set, u32 binding) const;
+    };
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include "Vendor/glm/glm.hpp"
+#include "Vendor/glm/gtc/packing.hpp"
+#include "Vendor/glm/gtc/type_precision.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Maps encoded positions back into model space: position = Offset + Scale * encoded.
+    // The renderer folds it into the instance transforms, so draws of differently encoded models share all state.
+    struct VertexDequantization
+    {
+        glm::vec4 Offset = glm::vec4(0.0f);
+        glm::vec4 Scale  = glm::vec4(1.0f);
+    };
+
+    // Value range a position encoding can represent. Positions get normalized into it before encoding.
+    enum class PositionRange : u8
+    {
+        eUnbounded = 0, // Stored as is
+        eUnsigned  = 1, // [0, 1] across the bounding box
+        eSigned    = 2  // [-1, 1] around the bounding box center
+    };
+
+    // ----- Attribute encodings -----
+
+    namespace VertexAttribute
+    {
+        struct Float3
+        {
+            using Type = glm::vec3;
+
+            static constexpr vk::Format    FORMAT = vk::Format::eR32G32B32Sfloat;
+            static constexpr PositionRange RANGE  = PositionRange::eUnbounded;
+
+            static Type Encode(const glm::vec3& value) { return value; }
+        };
+
+        struct Float2
+        {
+            using Type = glm::vec2;
+
+            static constexpr vk::Format FORMAT = vk::Format::eR32G32Sfloat;
+
+            static Type Encode(const glm::vec2& value) { return value; }
+        };
+
+        // Fourth component is padding, the shader only reads xyz
+        struct Unorm16x4
+        {
+            using Type = glm::u16vec4;
+
+            static constexpr vk::Format    FORMAT = vk::Format::eR16G16B16A16Unorm;
+            static constexpr PositionRange RANGE  = PositionRange::eUnsigned;
+
+            static Type Encode(const glm::vec3& value)
+            {
+                const glm::vec3 scaled = glm::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f);
+                return { (u16)scaled.x, (u16)scaled.y, (u16)scaled.z, 0 };
+            }
+        };
+
+        struct Half4
+        {
+            using Type = glm::u16vec4;
+
+            static constexpr vk::Format    FORMAT = vk::Format::eR16G16B16A16Sfloat;
+            static constexpr PositionRange RANGE  = PositionRange::eSigned;
+
+            static Type Encode(const glm::vec3& value)
+            {
+                return { glm::packHalf1x16(value.x), glm::packHalf1x16(value.y), glm::packHalf1x16(value.z), 0 };
+            }
+        };
+
+        // Alpha is always opaque
+        struct Unorm8x4
+        {
+            using Type = glm::u8vec4;
+
+            static constexpr vk::Format FORMAT = vk::Format::eR8G8B8A8Unorm;
+
+            static Type Encode(const glm::vec3& value)
+            {
+                const glm::vec3 scaled = glm::round(glm::clamp(value, 0.0f, 1.0f) * 255.0f);
+                return { (u8)scaled.x, (u8)scaled.y, (u8)scaled.z, 255 };
+            }
+        };
+
+        // Half floats keep texture coordinates outside of [0, 1] (repeating textures) intact
+        struct Half2
+        {
+            using Type = glm::u16vec2;
+
+            static constexpr vk::Format FORMAT = vk::Format::eR16G16Sfloat;
+
+            static Type Encode(const glm::vec2& value)
+            {
+                return { glm::packHalf1x16(value.x), glm::packHalf1x16(value.y) };
+            }
+        };
+    }
+
+    // ----- Layouts -----
+
+    // Interleaved vertex layout with constexpr generated Vulkan descriptions. Shader locations stay the same for
+    // every layout (0: position, 1: color, 2: texture coordinate), so shaders work with all of them.
+    template <typename PositionT, typename ColorT, typename TexCoordT>
+    struct VertexLayout
+    {
+        struct Data
+        {
+            typename PositionT::Type Position;
+            typename ColorT::Type    Color;
+            typename TexCoordT::Type TexCoord;
+        };
+
+        static constexpr u32 STRIDE = sizeof(Data);
+
+        static constexpr vk::VertexInputBindingDescription GetBindingDescription()
+        {
+            return { .binding = 0, .stride = STRIDE, .inputRate = vk::VertexInputRate::eVertex };
+        }
+
+        // clang-format off
+        static constexpr std::array<vk::VertexInputAttributeDescription, 3> GetAttributeDescriptions()
+        {
+            return std::to_array<vk::VertexInputAttributeDescription>
+            ({
+                {
+                    .location = 0,
+                    .binding  = 0,
+                    .format   = PositionT::FORMAT,
+                    .offset   = offsetof(Data, Position)
+                },
+                {
+                    .location = 1,
+                    .binding  = 0,
+                    .format   = ColorT::FORMAT,
+                    .offset   = offsetof(Data, Color)
+                },
+                {
+                    .location = 2,
+                    .binding  = 0,
+                    .format   = TexCoordT::FORMAT,
+                    .offset   = offsetof(Data, TexCoord)
+                }
+            });
+        }
+        // clang-format on
+
+        // Normalizes positions into the range of the encoding, based on the bounding box of the vertices
+        static VertexDequantization ComputeDequantization(std::span<const Vertex> vertices)
+        {
+            if constexpr (PositionT::RANGE == PositionRange::eUnbounded)
+            {
+                return {};
+            }
+            else
+            {
+                glm::vec3 min(0.0f);
+                glm::vec3 max(0.0f);
+
+                if (!vertices.empty())
+                {
+                    min = max = vertices.front().Position;
+                }
+
+                for (const auto& vertex : vertices)
+                {
+                    min = glm::min(min, vertex.Position);
+                    max = glm::max(max, vertex.Position);
+                }
+
+                // Avoid division by zero for flat meshes
+                const glm::vec3 extent = glm::max(max - min, glm::vec3(1e-6f));
+
+                if constexpr (PositionT::RANGE == PositionRange::eUnsigned)
+                {
+                    return { .Offset = glm::vec4(min, 0.0f), .Scale = glm::vec4(extent, 1.0f) };
+                }
+                else
+                {
+                    return { .Offset = glm::vec4((min + max) * 0.5f, 0.0f), .Scale = glm::vec4(extent * 0.5f, 1.0f) };
+                }
+            }
+        }
+
+        // Writes STRIDE bytes per vertex into the output
+        static void Encode(std::span<const Vertex> vertices, const VertexDequantization& dequantization, u8* output)
+        {
+            const glm::vec3 offset = dequantization.Offset;
+            const glm::vec3 scale  = dequantization.Scale;
+
+            for (size_t i = 0; i < vertices.size(); i++)
+            {
+                const Data encoded{ .Position = PositionT::Encode((vertices[i].Position - offset) / scale),
+                                    .Color    = ColorT::Encode(vertices[i].Color),
+                                    .TexCoord = TexCoordT::Encode(vertices[i].TexCoord) };
+
+                std::memcpy(output + (i * STRIDE), &encoded, STRIDE);
+            }
+        }
+    };
+
+    // Full precision (32 bytes), bit-identical to Vertex
+    using FullVertexLayout = VertexLayout<VertexAttribute::Float3, VertexAttribute::Float3, VertexAttribute::Float2>;
+
+    // Unorm16 positions inside the bounding box (16 bytes)
+    using CompactVertexLayout =
+        VertexLayout<VertexAttribute::Unorm16x4, VertexAttribute::Unorm8x4, VertexAttribute::Half2>;
+
+    // Half float positions around the bounding box center (16 bytes)
+    using HalfVertexLayout = VertexLayout<VertexAttribute::Half4, VertexAttribute::Unorm8x4, VertexAttribute::Half2>;
+
+    static_assert(FullVertexLayout::STRIDE == sizeof(Vertex));
+    static_assert(CompactVertexLayout::STRIDE == 16);
+    static_assert(HalfVertexLayout::STRIDE == 16);
+
+    // ----- Instancing -----
+
+    // Per-instance data streamed from binding 1. Locations 3 to 6 hold the columns of the model matrix, so shaders
+    // declare it as 'layout(location = 3) in mat4'.
+    struct InstanceLayout
+    {
+        struct Data
+        {
+            glm::mat4 Model;
+        };
+
+        static constexpr u32 BINDING        = 1;
+        static constexpr u32 FIRST_LOCATION = 3;
+        static constexpr u32 STRIDE         = sizeof(Data);
+
+        static constexpr vk::VertexInputBindingDescription GetBindingDescription()
+        {
+            return { .binding = BINDING, .stride = STRIDE, .inputRate = vk::VertexInputRate::eInstance };
+        }
+
+        static constexpr std::array<vk::VertexInputAttributeDescription, 4> GetAttributeDescriptions()
+        {
+            std::array<vk::VertexInputAttributeDescription, 4> attributes = {};
+
+            for (u32 column = 0; column < attributes.size(); column++)
+            {
+                attributes[column] = { .location = FIRST_LOCATION + column,
+                                       .binding  = BINDING,
+                                       .format   = vk::Format::eR32G32B32A32Sfloat,
+                                       .offset   = column * (u32)sizeof(glm::vec4) };
+            }
+
+            return attributes;
+        }
+    };
+
+    static_assert(InstanceLayout::STRIDE == 64);
+
+    // Runtime selector for the layouts above, used by pipelines and models
+    enum class VertexFormat : u8
+    {
+        eFull    = 0,
+        eCompact = 1,
+        eHalf    = 2
+    };
+
+    // Calls fn.template operator()<Layout>() with the layout matching the format
+    template <typename Fn>
+    decltype(auto) VisitVertexLayout(VertexFormat format, Fn&& fn)
+    {
+        switch (format)
+        {
+        case VertexFormat::eCompact:
+            return fn.template operator()<CompactVertexLayout>();
+        case VertexFormat::eHalf:
+            return fn.template operator()<HalfVertexLayout>();
+        case VertexFormat::eFull:
+        default:
+            return fn.template operator()<FullVertexLayout>();
+        }
+    }
+
+    [[nodiscard]] inline u32 GetVertexStride(VertexFormat format)
+    {
+        return VisitVertexLayout(format, []<typename Layout>() { return Layout::STRIDE; });
+    }
+
+    [[nodiscard]] constexpr const char* VertexFormatToString(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::eFull:
+            return "Full";
+        case VertexFormat::eCompact:
+            return "Compact";
+        case VertexFormat::eHalf:
+            return "Half";
+        }
+
+        return "Unknown";
+    }
+
+    struct EncodedVertices
+    {
+        std::vector<u8>      Data;
+        u32                  Stride = 0;
+        VertexDequantization Dequantization;
+    };
+
+    // Converts full precision vertices into the given layout and computes the matching dequantization
+    [[nodiscard]] inline EncodedVertices EncodeVertices(VertexFormat format, std::span<const Vertex> vertices)
+    {
+        return VisitVertexLayout(format,
+                                 [vertices]<typename Layout>()
+                                 {
+                                     EncodedVertices result;
+                                     result.Stride         = Layout::STRIDE;
+                                     result.Dequantization = Layout::ComputeDequantization(vertices);
+
+                                     result.Data.resize(vertices.size() * Layout::STRIDE);
+                                     Layout::Encode(vertices, result.Dequantization, result.Data.data());
+
+                                     return result;
+                                 });
+    }
+}
@@ -86,10 +86,13 @@ namespace Engine::Graphics
         IMGUI_CHECKVERSION();
         ImGui::CreateContext();
 
-        // Dynamic rendering specification
-        const vk::Format                      format = m_Context->GetSwapchain()->GetProperties().SurfaceFormat.format;
-        const vk::PipelineRenderingCreateInfo renderingInfo{ .colorAttachmentCount    = GLOBAL_COLOR_ATTACHMENT_COUNT,
-                                                             .pColorAttachmentFormats = &format };
+        // Dynamic rendering specification, the UI gets drawn inside the main pass which has a depth attachment
+        const SwapchainProperties&            properties = m_Context->GetSwapchain()->GetProperties();
+        const vk::PipelineRenderingCreateInfo renderingInfo{
+            .colorAttachmentCount    = GLOBAL_COLOR_ATTACHMENT_COUNT,
+            .pColorAttachmentFormats = &properties.SurfaceFormat.format,
+            .depthAttachmentFormat   = properties.DepthFormat
+        };
 
         const ImGui_ImplVulkan_PipelineInfo pipelineInfo{
             .RenderPass                  = nullptr,
@@ -112,7 +115,7 @@ namespace Engine::Graphics
                                                 0, // ImGui backend would create an own pool with values > 0
                                             .MinImageCount = m_Context->GetSwapchain()->GetProperties().MinImageCount,
                                             .ImageCount    = m_Context->GetSwapchain()->GetImageCount(),
-                                            .PipelineCache = nullptr,
+                                            .PipelineCache = m_Context->GetPipelineCache()->GetHandle(),
                                             .PipelineInfoMain           = pipelineInfo,
                                             .UseDynamicRendering        = true,
                                             .Allocator                  = nullptr,
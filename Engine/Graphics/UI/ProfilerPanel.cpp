@@ -1,14 +1,21 @@
 #include "ProfilerPanel.hpp"
 
+#include "Core/Utility.hpp"
+
 #include "Platform/Window.hpp"
 
 #include "Vendor/imgui/imgui.h"
 
+#include <algorithm>
+
 namespace Engine::Graphics
 {
     // ----- Public -----
 
-    void ProfilerPanel::Render(const Core::FrameTiming& timing, const Graphics::RenderStats& renderStats)
+    void ProfilerPanel::Render(const Core::FrameTiming&                     timing,
+                               const Graphics::RenderStats&                 renderStats,
+                               const Graphics::GpuTimings&                  gpuTimings,
+                               std::span<const Graphics::GpuPassStatistics> pipelineStatistics)
     {
         // Panel position
         const ImGuiViewport* viewport = ImGui::GetMainViewport();
@@ -36,6 +43,7 @@ namespace Engine::Graphics
         if (timing.TotalMilliseconds - m_LastHistorySample >= sampleInterval)
         {
             m_FrameTimeHistory[m_HistoryOffset] = (f32)timing.DeltaMilliseconds;
+            m_GpuTimeHistory[m_HistoryOffset]   = (f32)gpuTimings.FrameMilliseconds;
             m_HistoryOffset                     = (m_HistoryOffset + 1) % HistorySize;
             m_LastHistorySample                 = timing.TotalMilliseconds;
         }
@@ -72,12 +80,78 @@ namespace Engine::Graphics
                     (ull)timing.Benchmark.HighestDeltaFrame);
         ImGui::NewLine();
 
+        // GPU
+        ImGui::SeparatorText("GPU");
+        if (gpuTimings.IsValid())
+        {
+            // The CPU frame time includes waiting for the GPU, so a GPU busy for most of it is what holds frames back
+            constexpr f64 gpuBoundRatio = 0.9;
+            const b8      gpuBound      = gpuTimings.FrameMilliseconds >= gpuBoundRatio * timing.DeltaMilliseconds;
+
+            ImGui::Text("%2.2f ms/frame (%s bound)", gpuTimings.FrameMilliseconds, gpuBound ? "GPU" : "CPU");
+
+            ImGui::Separator();
+            ImGui::PlotLines("##GpuTime",
+                             m_GpuTimeHistory.data(),
+                             (i32)m_GpuTimeHistory.size(),
+                             (i32)m_HistoryOffset,
+                             "GPU time",
+                             0.0f,
+                             16.67,
+                             ImVec2{ -1.0f, 100.0f });
+            ImGui::Separator();
+
+            for (const Graphics::GpuPassTiming& pass : gpuTimings.Passes)
+            {
+                ImGui::Text("%-9s %2.2f ms", pass.Name.c_str(), pass.Milliseconds);
+            }
+        }
+        else
+        {
+            ImGui::TextUnformatted("No timestamps");
+        }
+        ImGui::NewLine();
+
         // Draw Stats
         ImGui::SeparatorText("Draw Stats");
         ImGui::Text("%-9s %d", "Draws", renderStats.DrawCalls);
+        ImGui::Text("%-9s %d", "Pre-pass", renderStats.PrepassDraws);
+        ImGui::Text("%-9s %d", "Binds", renderStats.BufferBinds);
         ImGui::Text("%-9s %d", "Models", renderStats.Models);
+        ImGui::Text("%-9s %d", "Instances", renderStats.Instances);
+        ImGui::Text("%-9s %d visible, %d culled", "CPU cull", renderStats.Visible, renderStats.Culled);
         ImGui::Text("%-9s %d", "Vertices", renderStats.Vertices);
         ImGui::Text("%-9s %d", "Indices", renderStats.Indices);
+        ImGui::Text("%-9s %d", "LOD saved", renderStats.LodSaved);
+        ImGui::Text("%-9s %d x 16-bit, %d x 32-bit", "Idx width", renderStats.Uint16Models, renderStats.Uint32Models);
+        ImGui::Text("%-9s %s", "Idx bytes", Core::Utility::BytesToString(renderStats.IndexBytes).c_str());
+        ImGui::Text("%-9s %d", "Uploading", renderStats.PendingUploads);
+        ImGui::Text("%-9s %d", "Compiling", renderStats.CompilingPipelines);
+        ImGui::Text("%-9s %s", "Frame mem", Core::Utility::BytesToString(renderStats.FrameBytes).c_str());
+        ImGui::Text("%-9s %d / %d visible", "GPU cull", renderStats.GpuVisible, renderStats.GpuObjects);
+        ImGui::Text("%-9s %d", "Occluded", renderStats.GpuOccluded);
+        ImGui::NewLine();
+
+        // Pipeline Stats
+        ImGui::SeparatorText("Pipeline Stats");
+        ImGui::Checkbox("Enabled", &m_PipelineStatistics);
+
+        const u64 pixels = std::max<u64>((u64)Platform::Window::GetWidth() * Platform::Window::GetHeight(), 1);
+        for (const Graphics::GpuPassStatistics& pass : pipelineStatistics)
+        {
+            // Shaded per fetched vertex shows the vertex reuse, shaded fragments per pixel the overdraw
+            const f64 vertexRatio = (f64)pass.VertexInvocations / (f64)std::max<u64>(pass.InputVertices, 1);
+            const f64 overdraw    = (f64)pass.FragmentInvocations / (f64)pixels;
+
+            ImGui::Text("%-9s %llu vertices, %llu primitives",
+                        pass.Name.c_str(),
+                        (ull)pass.InputVertices,
+                        (ull)pass.InputPrimitives);
+            ImGui::Text("%-9s %llu (%.2f per vertex)", "  VS", (ull)pass.VertexInvocations, vertexRatio);
+            ImGui::Text(
+                "%-9s %llu in, %llu out", "  Clip", (ull)pass.ClippingInvocations, (ull)pass.ClippingPrimitives);
+            ImGui::Text("%-9s %llu (%.2fx overdraw)", "  FS", (ull)pass.FragmentInvocations, overdraw);
+        }
 
         ImGui::End();
     }
@@ -5,6 +5,7 @@
 #include "Graphics/Vulkan/VulkanRendererStructs.hpp"
 
 #include <array>
+#include <span>
 
 namespace Engine::Graphics
 {
@@ -17,13 +18,21 @@ namespace Engine::Graphics
         ProfilerPanel(const ProfilerPanel&)            = delete;
         ProfilerPanel& operator=(const ProfilerPanel&) = delete;
 
-        void Render(const Core::FrameTiming& frameTiming, const Graphics::RenderStats& renderStats);
+        void Render(const Core::FrameTiming&                     frameTiming,
+                    const Graphics::RenderStats&                 renderStats,
+                    const Graphics::GpuTimings&                  gpuTimings,
+                    std::span<const Graphics::GpuPassStatistics> pipelineStatistics);
+
+        // Toggled by the panel's checkbox, statistics cost nothing while off
+        [[nodiscard]] b8 WantsPipelineStatistics() const { return m_PipelineStatistics; }
 
     private:
         static constexpr u8 HistorySize = 240;
 
-        std::array<f32, HistorySize> m_FrameTimeHistory  = {};
-        u8                           m_HistoryOffset     = 0;
-        f64                          m_LastHistorySample = 0.0;
+        std::array<f32, HistorySize> m_FrameTimeHistory   = {};
+        std::array<f32, HistorySize> m_GpuTimeHistory     = {};
+        u8                           m_HistoryOffset      = 0;
+        f64                          m_LastHistorySample  = 0.0;
+        b8                           m_PipelineStatistics = false;
     };
 }
@@ -102,13 +102,21 @@ namespace Engine::Graphics
     {
         ASSERT(spec.Size > 0, "Provided buffer size was less or equal to zero!");
 
-        const vk::BufferCreateInfo bufferInfo{ .size        = spec.Size,
-                                               .usage       = spec.BufferUsageFlags,
-                                               .sharingMode = vk::SharingMode::eExclusive };
+        // Buffers accessed by multiple queue families skip ownership transfers by being shared concurrently
+        const b8 concurrent = spec.QueueFamilies.size() > 1;
+
+        const vk::BufferCreateInfo bufferInfo{
+            .size                  = spec.Size,
+            .usage                 = spec.BufferUsageFlags,
+            .sharingMode           = concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+            .queueFamilyIndexCount = concurrent ? (u32)spec.QueueFamilies.size() : 0,
+            .pQueueFamilyIndices   = concurrent ? spec.QueueFamilies.data() : nullptr
+        };
 
         VmaAllocationCreateInfo allocCreateInfo{};
         allocCreateInfo.requiredFlags = (VkMemoryPropertyFlags)spec.MemoryFlags;
         allocCreateInfo.usage         = MapMemoryUsage(spec.MemoryUsage);
+        allocCreateInfo.flags         = spec.PersistentlyMapped ? VMA_ALLOCATION_CREATE_MAPPED_BIT : 0;
 
         vk::Buffer        buffer;
         VmaAllocation     allocation{};
@@ -128,7 +136,7 @@ namespace Engine::Graphics
                  vk::to_string(spec.BufferUsageFlags),
                  Core::Utility::BytesToString(s_totalMemory));
 
-        return { .Buffer = buffer, .Allocation = allocation };
+        return { .Buffer = buffer, .Allocation = allocation, .MappedData = allocationInfo.pMappedData };
     }
 
     void VulkanAllocator::Shutdown()
@@ -153,6 +161,60 @@ namespace Engine::Graphics
                  Core::Utility::BytesToString(s_totalMemory));
     }
 
+    ImageAllocation VulkanAllocator::AllocateImage(const ImageSpecification& spec)
+    {
+        ASSERT(spec.Extent.width > 0 && spec.Extent.height > 0, "Provided image extent was empty!");
+
+        const vk::ImageCreateInfo imageInfo{ .imageType     = vk::ImageType::e2D,
+                                             .format        = spec.Format,
+                                             .extent        = { .width  = spec.Extent.width,
+                                                                .height = spec.Extent.height,
+                                                                .depth  = 1 },
+                                             .mipLevels     = spec.MipLevels,
+                                             .arrayLayers   = 1,
+                                             .samples       = vk::SampleCountFlagBits::e1,
+                                             .tiling        = vk::ImageTiling::eOptimal,
+                                             .usage         = spec.ImageUsageFlags,
+                                             .sharingMode   = vk::SharingMode::eExclusive,
+                                             .initialLayout = vk::ImageLayout::eUndefined };
+
+        VmaAllocationCreateInfo allocCreateInfo{};
+        allocCreateInfo.usage = MapMemoryUsage(spec.MemoryUsage);
+
+        vk::Image         image;
+        VmaAllocation     allocation{};
+        VmaAllocationInfo allocationInfo{};
+
+        VK_VERIFY((vk::Result)(vmaCreateImage(s_Allocator,
+                                              (const VkImageCreateInfo*)&imageInfo,
+                                              &allocCreateInfo,
+                                              (VkImage*)&image,
+                                              &allocation,
+                                              &allocationInfo)));
+        s_totalMemory += allocationInfo.size;
+
+        LOG_PERF("Allocated {} of '{}' memory as {} image. Total: {} ...",
+                 Core::Utility::BytesToString(allocationInfo.size),
+                 MemoryUsageToString(spec.MemoryUsage),
+                 vk::to_string(spec.Format),
+                 Core::Utility::BytesToString(s_totalMemory));
+
+        return { .Image = image, .Allocation = allocation };
+    }
+
+    void VulkanAllocator::DestroyImage(const ImageAllocation& imageAlloc)
+    {
+        VmaAllocationInfo allocationInfo{};
+        vmaGetAllocationInfo(s_Allocator, imageAlloc.Allocation, &allocationInfo);
+
+        s_totalMemory -= allocationInfo.size;
+        vmaDestroyImage(s_Allocator, (VkImage)imageAlloc.Image, imageAlloc.Allocation);
+
+        LOG_PERF("Freed {} of image memory. Total: {} ...",
+                 Core::Utility::BytesToString(allocationInfo.size),
+                 Core::Utility::BytesToString(s_totalMemory));
+    }
+
     void* VulkanAllocator::MapMemory(VmaAllocation allocation)
     {
         void* dataPtr = nullptr;
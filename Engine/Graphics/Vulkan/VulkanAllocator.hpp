@@ -4,6 +4,8 @@
 
 #include "Graphics/Vulkan/VulkanDevice.hpp"
 
+#include <span>
+
 // Forward-Declaration
 using VmaAllocation = struct VmaAllocation_T*;
 
@@ -28,6 +30,7 @@ namespace Engine::Graphics
     {
         vk::Buffer    Buffer;
         VmaAllocation Allocation;
+        void*         MappedData = nullptr; // Only set for persistently mapped buffers
     };
 
     struct BufferSpecification
@@ -36,6 +39,24 @@ namespace Engine::Graphics
         vk::BufferUsageFlags    BufferUsageFlags;
         MemoryUsage             MemoryUsage;
         vk::MemoryPropertyFlags MemoryFlags;
+        std::span<const u32>    QueueFamilies      = {};    // Shared concurrently if more than one family accesses it
+        b8                      PersistentlyMapped = false; // Mapped for the whole lifetime of the buffer
+    };
+
+    struct ImageAllocation
+    {
+        vk::Image     Image;
+        VmaAllocation Allocation;
+    };
+
+    // Single layer 2D image with optimal tiling
+    struct ImageSpecification
+    {
+        vk::Extent2D        Extent;
+        vk::Format          Format;
+        vk::ImageUsageFlags ImageUsageFlags;
+        MemoryUsage         MemoryUsage;
+        u32                 MipLevels = 1;
     };
 
     class VulkanAllocator
@@ -49,6 +70,9 @@ namespace Engine::Graphics
         static BufferAllocation AllocateBuffer(const BufferSpecification& spec);
         static void             DestroyBuffer(const BufferAllocation& bufferAlloc);
 
+        static ImageAllocation AllocateImage(const ImageSpecification& spec);
+        static void            DestroyImage(const ImageAllocation& imageAlloc);
+
         static void* MapMemory(VmaAllocation allocation);
         static void  UnmapMemory(VmaAllocation allocation);
     };
@@ -0,0 +1,125 @@
+#include "VulkanCommandRecorder.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanCommandRecorder::VulkanCommandRecorder(const VulkanDevice* device) : m_Device(device)
+    {
+        const u32 threadCount = Core::JobSystem::GetWorkerCount();
+
+        // Pools only get reset as a whole, so their buffers don't need to be resettable one by one
+        const vk::CommandPoolCreateInfo poolInfo{ .flags            = vk::CommandPoolCreateFlagBits::eTransient,
+                                                  .queueFamilyIndex = m_Device->GetGraphicsQueueFamily() };
+
+        for (std::vector<ThreadPool>& framePools : m_ThreadPools)
+        {
+            framePools.resize(threadCount);
+
+            for (ThreadPool& threadPool : framePools)
+            {
+                VK_VERIFY(m_Device->GetHandle().createCommandPool(&poolInfo, nullptr, &threadPool.Pool));
+            }
+        }
+
+        LOG_INFO("Created command recorder ... ({} thread(s) x {} frame(s) command pools)",
+                 threadCount,
+                 FRAMES_IN_FLIGHT);
+    }
+
+    VulkanCommandRecorder::~VulkanCommandRecorder()
+    {
+        LOG_INFO("VulkanCommandRecorder::Destructor() ...");
+
+        // Destroying a pool frees its command buffers
+        for (const std::vector<ThreadPool>& framePools : m_ThreadPools)
+        {
+            for (const ThreadPool& threadPool : framePools)
+            {
+                m_Device->GetHandle().destroyCommandPool(threadPool.Pool);
+            }
+        }
+    }
+
+    void VulkanCommandRecorder::BeginFrame(u32 frameIndex)
+    {
+        ASSERT(frameIndex < FRAMES_IN_FLIGHT, "Given frame index surpasses FRAMES_IN_FLIGHT!");
+        m_FrameIndex = frameIndex;
+
+        for (ThreadPool& threadPool : m_ThreadPools[m_FrameIndex])
+        {
+            VK_VERIFY(m_Device->GetHandle().resetCommandPool(threadPool.Pool));
+            threadPool.Used = 0;
+        }
+    }
+
+    std::vector<vk::CommandBuffer> VulkanCommandRecorder::Record(AttachmentFormats     formats,
+                                                                 u32                   partitionCount,
+                                                                 const RecordFunction& record)
+    {
+        std::vector<vk::CommandBuffer> cmdBuffers(partitionCount);
+
+        // Secondaries inherit nothing but the attachment formats, every partition sets its own state
+        const b8                                        hasColor = formats.Color != vk::Format::eUndefined;
+        const vk::CommandBufferInheritanceRenderingInfo renderingInfo{
+            .colorAttachmentCount    = hasColor ? GLOBAL_COLOR_ATTACHMENT_COUNT : 0,
+            .pColorAttachmentFormats = hasColor ? &formats.Color : nullptr,
+            .depthAttachmentFormat   = formats.Depth,
+            .rasterizationSamples    = vk::SampleCountFlagBits::e1
+        };
+        const vk::CommandBufferInheritanceInfo inheritanceInfo{ .pNext = &renderingInfo };
+        const vk::CommandBufferBeginInfo       beginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+                                                                 | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+                                                          .pInheritanceInfo = &inheritanceInfo };
+
+        // Partitions are jobs of their own, a worker only ever touches its own pool
+        Core::JobSystem::ParallelFor(0,
+                                     partitionCount,
+                                     1,
+                                     [&](u64 begin, u64 end)
+                                     {
+                                         const u32 worker = Core::JobSystem::GetWorkerIndex();
+                                         ASSERT(worker < GetThreadCount(),
+                                                "Job system grew after the command recorder got created!");
+
+                                         ThreadPool& threadPool = m_ThreadPools[m_FrameIndex][worker];
+
+                                         for (u64 partition = begin; partition < end; partition++)
+                                         {
+                                             const vk::CommandBuffer cmdBuffer = AcquireBuffer(threadPool);
+                                             VK_VERIFY(cmdBuffer.begin(&beginInfo));
+
+                                             record(cmdBuffer, (u32)partition);
+
+                                             VK_VERIFY(cmdBuffer.end());
+                                             cmdBuffers[partition] = cmdBuffer;
+                                         }
+                                     });
+
+        return cmdBuffers;
+    }
+
+    // ----- Private -----
+
+    vk::CommandBuffer VulkanCommandRecorder::AcquireBuffer(ThreadPool& threadPool)
+    {
+        if (threadPool.Used == threadPool.Buffers.size())
+        {
+            const vk::CommandBufferAllocateInfo allocateInfo{ .commandPool        = threadPool.Pool,
+                                                              .level              = vk::CommandBufferLevel::eSecondary,
+                                                              .commandBufferCount = 1 };
+
+            vk::CommandBuffer cmdBuffer = nullptr;
+            VK_VERIFY(m_Device->GetHandle().allocateCommandBuffers(&allocateInfo, &cmdBuffer));
+            threadPool.Buffers.push_back(cmdBuffer);
+        }
+
+        return threadPool.Buffers[threadPool.Used++];
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanDevice.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Attachment formats of the rendering scope the secondaries continue, an undefined color format leaves out the
+    // color attachment (e.g. for depth only passes)
+    struct AttachmentFormats
+    {
+        vk::Format Color = vk::Format::eUndefined;
+        vk::Format Depth = vk::Format::eUndefined;
+    };
+
+    // Called once per partition, possibly on a worker thread, with a secondary command buffer that is already begun
+    using RecordFunction = std::function<void(vk::CommandBuffer cmdBuffer, u32 partition)>;
+
+    // Records secondary command buffers for the dynamic rendering scope across the job system. Every worker owns
+    // one command pool per frame in flight, so workers never share a pool and a whole frame's pools get reset at
+    // once instead of resetting buffers one by one. Buffers are kept and reused when their slot comes around again.
+    class VulkanCommandRecorder
+    {
+    public:
+        // The pool count is fixed to the job system's worker count at construction
+        explicit VulkanCommandRecorder(const VulkanDevice* device);
+        ~VulkanCommandRecorder();
+
+        VulkanCommandRecorder(const VulkanCommandRecorder&)            = delete;
+        VulkanCommandRecorder& operator=(const VulkanCommandRecorder&) = delete;
+
+        // Resets the pools of the frame slot, so only call it after waiting for the slot's fence
+        void BeginFrame(u32 frameIndex);
+
+        // Records 'partitionCount' secondary command buffers which continue a rendering scope into attachments of the
+        // given formats (the primary has to begin rendering with eContentsSecondaryCommandBuffers). A single
+        // partition gets recorded on the calling thread. Returns the buffers in partition order, they stay valid
+        // until the frame slot comes around again.
+        [[nodiscard]] std::vector<vk::CommandBuffer> Record(AttachmentFormats     formats,
+                                                            u32                   partitionCount,
+                                                            const RecordFunction& record);
+
+        [[nodiscard]] u32 GetThreadCount() const { return (u32)m_ThreadPools[0].size(); }
+
+    private:
+        struct ThreadPool
+        {
+            vk::CommandPool                Pool = nullptr;
+            std::vector<vk::CommandBuffer> Buffers;  // Allocated so far, reused after every reset
+            u32                            Used = 0; // Buffers handed out since the last reset
+        };
+
+        [[nodiscard]] vk::CommandBuffer AcquireBuffer(ThreadPool& threadPool);
+
+        const VulkanDevice* m_Device = nullptr;
+
+        std::array<std::vector<ThreadPool>, FRAMES_IN_FLIGHT> m_ThreadPools; // Frame slot, then worker index
+        u32                                                   m_FrameIndex = 0;
+    };
+}
@@ -27,9 +27,12 @@ namespace Engine::Graphics
 
         m_PhysicalDevice = MakeScope<VulkanPhysicalDevice>(m_Instance, m_Surface);
         m_Device         = MakeScope<VulkanDevice>(m_PhysicalDevice.get());
-        m_Swapchain      = MakeScope<VulkanSwapchain>(m_Device.get(), m_Surface);
+        m_PipelineCache  = MakeScope<VulkanPipelineCache>(m_Device.get());
+        m_LayoutCache    = MakeScope<VulkanLayoutCache>(m_Device.get());
 
+        // The swapchain allocates its depth image
         VulkanAllocator::Init(m_Device.get(), m_Instance, m_ApiVersion);
+        m_Swapchain = MakeScope<VulkanSwapchain>(m_Device.get(), m_Surface);
 
         CreateDispatchLoader(); // For later use in extension functions
     }
@@ -38,9 +41,11 @@ namespace Engine::Graphics
     {
         LOG_INFO("VulkanContext::Destructor() ...");
 
+        m_Swapchain.reset();
         VulkanAllocator::Shutdown();
 
-        m_Swapchain.reset();
+        m_LayoutCache.reset();
+        m_PipelineCache.reset(); // Writes the cache back to disk
         m_Device.reset();
         m_PhysicalDevice.reset();
 
@@ -53,15 +58,6 @@ namespace Engine::Graphics
         m_Instance.destroy();
     }
 
-    void VulkanContext::CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size)
-    {
-        const vk::CommandBuffer commandBuffer = m_Swapchain->CreateTransferCommandBuffer();
-        const vk::BufferCopy    bufferCopy    = { .size = size };
-        commandBuffer.copyBuffer(srcBuffer, dstBuffer, 1, &bufferCopy);
-        m_Swapchain->SubmitTransferCommandBuffer(commandBuffer);
-        LOG_INFO("Copied {} bytes from CPU => GPU ...", size);
-    }
-
     // ----- Private -----
 
     void VulkanContext::CreateInstance()
@@ -3,7 +3,9 @@
 #include "Core/Memory.hpp"
 
 #include "Graphics/Vulkan/VulkanDevice.hpp"
+#include "Graphics/Vulkan/VulkanLayoutCache.hpp"
 #include "Graphics/Vulkan/VulkanPhysicalDevice.hpp"
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
 #include "Graphics/Vulkan/VulkanSwapchain.hpp"
 
 namespace Engine::Graphics
@@ -25,7 +27,9 @@ namespace Engine::Graphics
         [[nodiscard]] VulkanSwapchain*                         GetSwapchain() { return m_Swapchain.get(); }
         [[nodiscard]] const vk::detail::DispatchLoaderDynamic& GetLoader() const { return m_DispatchLoader; }
 
-        void CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
+        // Shared by all pipeline creation
+        [[nodiscard]] const VulkanPipelineCache* GetPipelineCache() const { return m_PipelineCache.get(); }
+        [[nodiscard]] VulkanLayoutCache*         GetLayoutCache() { return m_LayoutCache.get(); }
 
     private:
         void CreateInstance();
@@ -39,6 +43,8 @@ namespace Engine::Graphics
         vk::DebugUtilsMessengerEXT  m_DebugMessenger;
         Scope<VulkanPhysicalDevice> m_PhysicalDevice;
         Scope<VulkanDevice>         m_Device;
+        Scope<VulkanPipelineCache>  m_PipelineCache;
+        Scope<VulkanLayoutCache>    m_LayoutCache;
         Scope<VulkanSwapchain>      m_Swapchain;
 
         vk::detail::DispatchLoaderDynamic m_DispatchLoader;
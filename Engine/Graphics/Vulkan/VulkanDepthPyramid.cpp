@@ -0,0 +1,292 @@
+#include "VulkanDepthPyramid.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+#include "Graphics/Vulkan/VulkanSwapchainUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    constexpr vk::Format PYRAMID_FORMAT = vk::Format::eR32Sfloat;
+
+    void InsertComputeBarrier(vk::CommandBuffer cmdBuffer, vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess)
+    {
+        const vk::MemoryBarrier2 barrier{ .srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                                          .srcAccessMask = srcAccess,
+                                          .dstStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                                          .dstAccessMask = dstAccess };
+        const vk::DependencyInfo dependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier };
+        cmdBuffer.pipelineBarrier2(&dependencyInfo);
+    }
+
+    vk::ImageView CreateLevelView(vk::Device device, vk::Image image, u32 baseLevel, u32 levelCount)
+    {
+        const vk::ImageViewCreateInfo viewCreateInfo = { .image            = image,
+                                                         .viewType         = vk::ImageViewType::e2D,
+                                                         .format           = PYRAMID_FORMAT,
+                                                         .subresourceRange = { .aspectMask =
+                                                                                   vk::ImageAspectFlagBits::eColor,
+                                                                               .baseMipLevel   = baseLevel,
+                                                                               .levelCount     = levelCount,
+                                                                               .baseArrayLayer = 0,
+                                                                               .layerCount     = 1 } };
+
+        vk::ImageView view = nullptr;
+        VK_VERIFY(device.createImageView(&viewCreateInfo, nullptr, &view));
+
+        return view;
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanDepthPyramid::VulkanDepthPyramid(VulkanContext* context, const VulkanShader* reduceShader)
+        : m_Context(context)
+    {
+        ASSERT(reduceShader != nullptr, "Depth pyramid requires a compute shader!");
+
+        CreatePipeline(reduceShader);
+        CreateSampler();
+    }
+
+    VulkanDepthPyramid::~VulkanDepthPyramid()
+    {
+        LOG_INFO("VulkanDepthPyramid::Destructor() ...");
+
+        DestroyPyramid();
+
+        const vk::Device device = m_Context->GetDevice()->GetHandle();
+        device.destroySampler(m_Sampler);
+        device.destroyPipeline(m_Pipeline);
+    }
+
+    b8 VulkanDepthPyramid::Update(vk::CommandBuffer cmdBuffer)
+    {
+        if (m_Context->GetSwapchain()->GetDepthView() == m_DepthView)
+        {
+            return false;
+        }
+
+        // Resizes are rare, waiting beats keeping old pyramids around until the frames using them finished
+        if (m_DepthView != nullptr)
+        {
+            m_Context->GetDevice()->WaitForIdle();
+            DestroyPyramid();
+        }
+
+        CreatePyramid(cmdBuffer);
+        return true;
+    }
+
+    void VulkanDepthPyramid::Build(vk::CommandBuffer cmdBuffer)
+    {
+        const vk::Image depthImage = m_Context->GetSwapchain()->GetDepthImage();
+
+        // The pre-pass depth becomes readable, culling of earlier frames has to be done with the pyramid before it
+        // gets overwritten
+        VulkanSwapchainUtils::TransitionImageLayout(cmdBuffer,
+                                                    depthImage,
+                                                    vk::ImageLayout::eDepthAttachmentOptimal,
+                                                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                                    vk::AccessFlagBits2::eShaderSampledRead,
+                                                    vk::PipelineStageFlagBits2::eLateFragmentTests,
+                                                    vk::PipelineStageFlagBits2::eComputeShader,
+                                                    vk::ImageAspectFlagBits::eDepth);
+        InsertComputeBarrier(cmdBuffer, vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eShaderStorageWrite);
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_Pipeline);
+
+        // Every level reads the one above, so each dispatch waits for the previous one
+        for (u32 level = 0; level < GetLevelCount(); level++)
+        {
+            const u32 width  = std::max(m_Extent.width >> level, 1u);
+            const u32 height = std::max(m_Extent.height >> level, 1u);
+
+            cmdBuffer.bindDescriptorSets(
+                vk::PipelineBindPoint::eCompute, m_Layout, 0, 1, &m_DescriptorSets[level], 0, nullptr);
+            cmdBuffer.dispatch((width + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE,
+                               (height + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE,
+                               1);
+
+            InsertComputeBarrier(
+                cmdBuffer, vk::AccessFlagBits2::eShaderStorageWrite, vk::AccessFlagBits2::eShaderSampledRead);
+        }
+
+        // Following pre-pass draws keep adding to the depth
+        VulkanSwapchainUtils::TransitionImageLayout(cmdBuffer,
+                                                    depthImage,
+                                                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                                                    vk::ImageLayout::eDepthAttachmentOptimal,
+                                                    vk::AccessFlagBits2::eNone,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentRead
+                                                        | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                                    vk::PipelineStageFlagBits2::eComputeShader,
+                                                    vk::PipelineStageFlagBits2::eEarlyFragmentTests
+                                                        | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                                                    vk::ImageAspectFlagBits::eDepth);
+    }
+
+    // ----- Private -----
+
+    void VulkanDepthPyramid::CreatePipeline(const VulkanShader* reduceShader)
+    {
+        const ShaderReflection& reflection = reduceShader->GetReflection();
+        ASSERT(reflection.Sets.size() == 1 && reflection.Sets[0].size() == 2,
+               "Reduction shader doesn't match the depth pyramid descriptor set!");
+
+        m_DescriptorLayout = m_Context->GetLayoutCache()->GetDescriptorSetLayout(
+            { .Flags = {}, .Bindings = reflection.Sets[0] });
+        m_Layout = m_Context->GetLayoutCache()->GetPipelineLayout(reflection);
+
+        const vk::PipelineShaderStageCreateInfo stage = reduceShader->GetPipelineShaderStageCreateInfo();
+        ASSERT(stage.stage == vk::ShaderStageFlagBits::eCompute, "Reduction shader has to be a compute shader!");
+
+        const vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stage, .layout = m_Layout };
+        VK_VERIFY(m_Context->GetDevice()->GetHandle().createComputePipelines(
+            m_Context->GetPipelineCache()->GetHandle(), 1, &pipelineInfo, nullptr, &m_Pipeline));
+
+        LOG_INFO("Created depth pyramid pipeline ...");
+    }
+
+    void VulkanDepthPyramid::CreateSampler()
+    {
+        // Shaders only fetch texels, the sampler is required by the combined image sampler descriptors
+        const vk::SamplerCreateInfo samplerInfo{ .magFilter    = vk::Filter::eNearest,
+                                                 .minFilter    = vk::Filter::eNearest,
+                                                 .mipmapMode   = vk::SamplerMipmapMode::eNearest,
+                                                 .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+                                                 .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+                                                 .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+                                                 .minLod       = 0.0f,
+                                                 .maxLod       = VK_LOD_CLAMP_NONE };
+
+        VK_VERIFY(m_Context->GetDevice()->GetHandle().createSampler(&samplerInfo, nullptr, &m_Sampler));
+    }
+
+    void VulkanDepthPyramid::CreatePyramid(vk::CommandBuffer cmdBuffer)
+    {
+        const vk::Device    device      = m_Context->GetDevice()->GetHandle();
+        const vk::Extent2D  depthExtent = m_Context->GetSwapchain()->GetProperties().Extent;
+        const vk::ImageView depthView   = m_Context->GetSwapchain()->GetDepthView();
+
+        // Power of two levels halve exactly, only level 0 has to cover more than 2x2 texels of its source
+        m_Extent = { .width = std::bit_floor(depthExtent.width), .height = std::bit_floor(depthExtent.height) };
+        const u32 levelCount = std::bit_width(std::max(m_Extent.width, m_Extent.height));
+
+        const ImageSpecification spec{ .Extent          = m_Extent,
+                                       .Format          = PYRAMID_FORMAT,
+                                       .ImageUsageFlags = vk::ImageUsageFlagBits::eStorage
+                                                          | vk::ImageUsageFlagBits::eSampled,
+                                       .MemoryUsage     = MemoryUsage::eAutoPreferDevice,
+                                       .MipLevels       = levelCount };
+        m_Image = VulkanAllocator::AllocateImage(spec);
+
+        m_View = CreateLevelView(device, m_Image.Image, 0, levelCount);
+        for (u32 level = 0; level < levelCount; level++)
+        {
+            m_LevelViews.push_back(CreateLevelView(device, m_Image.Image, level, 1));
+        }
+
+        // One set per level: the source (depth image or previous level) and the level being written
+        const DescriptorPoolSpecification poolSpec{
+            .Flags     = {},
+            .MaxSets   = levelCount,
+            .PoolSizes = { { .type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = levelCount },
+                           { .type = vk::DescriptorType::eStorageImage, .descriptorCount = levelCount } },
+        };
+        m_DescriptorPool = MakeScope<VulkanDescriptorPool>(device, poolSpec);
+
+        const std::vector<vk::DescriptorSetLayout> layouts(levelCount, m_DescriptorLayout->GetHandle());
+        const vk::DescriptorSetAllocateInfo        allocInfo{ .descriptorPool     = m_DescriptorPool->GetHandle(),
+                                                              .descriptorSetCount = levelCount,
+                                                              .pSetLayouts        = layouts.data() };
+        m_DescriptorSets.resize(levelCount);
+        VK_VERIFY(device.allocateDescriptorSets(&allocInfo, m_DescriptorSets.data()));
+
+        for (u32 level = 0; level < levelCount; level++)
+        {
+            const vk::DescriptorImageInfo sourceInfo{
+                .sampler     = m_Sampler,
+                .imageView   = level == 0 ? depthView : m_LevelViews[level - 1],
+                .imageLayout = level == 0 ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral
+            };
+            const vk::DescriptorImageInfo destinationInfo{ .imageView   = m_LevelViews[level],
+                                                           .imageLayout = vk::ImageLayout::eGeneral };
+
+            const std::array<vk::WriteDescriptorSet, 2> writes = {
+                vk::WriteDescriptorSet{ .dstSet          = m_DescriptorSets[level],
+                                        .dstBinding      = 0,
+                                        .descriptorCount = 1,
+                                        .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+                                        .pImageInfo      = &sourceInfo },
+                vk::WriteDescriptorSet{ .dstSet          = m_DescriptorSets[level],
+                                        .dstBinding      = 1,
+                                        .descriptorCount = 1,
+                                        .descriptorType  = vk::DescriptorType::eStorageImage,
+                                        .pImageInfo      = &destinationInfo }
+            };
+            device.updateDescriptorSets((u32)writes.size(), writes.data(), 0, nullptr);
+        }
+
+        // The pyramid stays in general layout, it gets written and sampled by compute shaders only
+        const vk::ImageSubresourceRange levels{ .aspectMask     = vk::ImageAspectFlagBits::eColor,
+                                                .baseMipLevel   = 0,
+                                                .levelCount     = levelCount,
+                                                .baseArrayLayer = 0,
+                                                .layerCount     = 1 };
+        const vk::ImageMemoryBarrier2   barrier{ .srcStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                                 .srcAccessMask       = vk::AccessFlagBits2::eNone,
+                                                 .dstStageMask        = vk::PipelineStageFlagBits2::eComputeShader,
+                                                 .dstAccessMask       = vk::AccessFlagBits2::eShaderStorageWrite
+                                                                        | vk::AccessFlagBits2::eShaderSampledRead,
+                                                 .oldLayout           = vk::ImageLayout::eUndefined,
+                                                 .newLayout           = vk::ImageLayout::eGeneral,
+                                                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                 .image               = m_Image.Image,
+                                                 .subresourceRange    = levels };
+        const vk::DependencyInfo dependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier };
+        cmdBuffer.pipelineBarrier2(&dependencyInfo);
+
+        m_DepthView = depthView;
+
+        LOG_INFO("Created depth pyramid ... ({}x{}, {} levels)", m_Extent.width, m_Extent.height, levelCount);
+    }
+
+    void VulkanDepthPyramid::DestroyPyramid()
+    {
+        const vk::Device device = m_Context->GetDevice()->GetHandle();
+
+        // Sets are freed along with their pool
+        m_DescriptorSets.clear();
+        m_DescriptorPool.reset();
+
+        for (const vk::ImageView view : m_LevelViews)
+        {
+            device.destroyImageView(view);
+        }
+        m_LevelViews.clear();
+
+        device.destroyImageView(m_View);
+        if (m_Image.Image)
+        {
+            VulkanAllocator::DestroyImage(m_Image);
+        }
+
+        m_View      = nullptr;
+        m_Image     = {};
+        m_DepthView = nullptr;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
+#include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanDescriptorPool.hpp"
+#include "Graphics/Vulkan/VulkanDescriptorSetLayout.hpp"
+#include "Graphics/Vulkan/VulkanShader.hpp"
+
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Hierarchical depth (Hi-Z) of the swapchain's depth image: every texel holds the farthest depth of the area it
+    // covers, so a handful of fetches tell whether anything behind a screen rectangle could still be visible. Level 0
+    // is the largest power of two fitting into the depth image, every further level halves it. All frames in flight
+    // share the pyramid like they share the depth image.
+    class VulkanDepthPyramid
+    {
+    public:
+        // The shader module is only needed during construction
+        VulkanDepthPyramid(VulkanContext* context, const VulkanShader* reduceShader);
+        ~VulkanDepthPyramid();
+
+        VulkanDepthPyramid(const VulkanDepthPyramid&)            = delete;
+        VulkanDepthPyramid& operator=(const VulkanDepthPyramid&) = delete;
+
+        // Follows the depth image after the swapchain got recreated, waits for the device to do so. Returns true if
+        // the pyramid was recreated, descriptors referencing its view have to be rewritten then.
+        [[nodiscard]] b8 Update(vk::CommandBuffer cmdBuffer);
+
+        // Reduces the depth image written by the pre-pass into all levels, has to be recorded outside of rendering.
+        // The depth image gets sampled in between and is ready for depth testing again afterwards.
+        void Build(vk::CommandBuffer cmdBuffer);
+
+        // All levels in general layout, for compute shaders fetching texels (the sampler doesn't filter)
+        [[nodiscard]] vk::ImageView GetView() const { return m_View; }
+        [[nodiscard]] vk::Sampler   GetSampler() const { return m_Sampler; }
+
+        [[nodiscard]] vk::Extent2D GetExtent() const { return m_Extent; }
+        [[nodiscard]] u32          GetLevelCount() const { return (u32)m_LevelViews.size(); }
+
+    private:
+        void CreatePipeline(const VulkanShader* reduceShader);
+        void CreateSampler();
+        void CreatePyramid(vk::CommandBuffer cmdBuffer);
+        void DestroyPyramid();
+
+        VulkanContext* m_Context = nullptr;
+
+        const VulkanDescriptorSetLayout* m_DescriptorLayout = nullptr; // Owned by the layout cache
+        vk::PipelineLayout               m_Layout           = nullptr; // Owned by the layout cache
+        vk::Pipeline                     m_Pipeline         = nullptr;
+        vk::Sampler                      m_Sampler          = nullptr;
+
+        // Pyramid of the current depth image, one descriptor set per level reads the level above and writes it
+        ImageAllocation                m_Image     = {};
+        vk::ImageView                  m_View      = nullptr;
+        vk::ImageView                  m_DepthView = nullptr;
+        vk::Extent2D                   m_Extent    = {};
+        std::vector<vk::ImageView>     m_LevelViews;
+        Scope<VulkanDescriptorPool>    m_DescriptorPool;
+        std::vector<vk::DescriptorSet> m_DescriptorSets;
+    };
+}
@@ -51,11 +51,21 @@ namespace Engine::Graphics
             });
         }
 
-        // Define features you want to use (e.g. geometry shaders)
-        const vk::PhysicalDeviceFeatures deviceFeatures{};
+        // Define features you want to use (e.g. geometry shaders), GPU culling emits many draws per indirect call.
+        // Pipeline statistics are optional, the profiler only offers them where supported.
+        const vk::Bool32                 pipelineStatistics = m_PhysicalDevice->GetFeatures().pipelineStatisticsQuery;
+        const vk::PhysicalDeviceFeatures deviceFeatures{ .multiDrawIndirect       = vk::True,
+                                                         .pipelineStatisticsQuery = pipelineStatistics };
+
+        // Activate indirect draw counts (GPU culling), depth-only image layouts (depth attachment without stencil)
+        // and timeline semaphores (used to track uploads)
+        vk::PhysicalDeviceVulkan12Features vulkan12Features{ .pNext                       = nullptr,
+                                                             .drawIndirectCount           = vk::True,
+                                                             .separateDepthStencilLayouts = vk::True,
+                                                             .timelineSemaphore           = vk::True };
 
         // Activate dynamic rendering and synchronization2
-        vk::PhysicalDeviceVulkan13Features vulkan13Features{ .pNext            = nullptr,
+        vk::PhysicalDeviceVulkan13Features vulkan13Features{ .pNext            = &vulkan12Features,
                                                              .synchronization2 = vk::True,
                                                              .dynamicRendering = vk::True };
 
@@ -0,0 +1,90 @@
+#include "VulkanFrameAllocator.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanFrameAllocator::VulkanFrameAllocator(VulkanContext* context, vk::DeviceSize frameCapacity)
+    {
+        const vk::PhysicalDeviceLimits& limits = context->GetDevice()->GetPhysicalDevice()->GetProperties().limits;
+        m_UniformAlignment                     = limits.minUniformBufferOffsetAlignment;
+        m_StorageAlignment                     = limits.minStorageBufferOffsetAlignment;
+
+        // Every region has to start at an offset usable by both descriptor types
+        const vk::DeviceSize alignment = std::max(m_UniformAlignment, m_StorageAlignment);
+        m_FrameCapacity                = ((frameCapacity + alignment - 1) / alignment) * alignment;
+
+        const BufferSpecification spec{ .Size               = m_FrameCapacity * FRAMES_IN_FLIGHT,
+                                        .BufferUsageFlags   = vk::BufferUsageFlagBits::eUniformBuffer
+                                                              | vk::BufferUsageFlagBits::eStorageBuffer
+                                                              | vk::BufferUsageFlagBits::eVertexBuffer,
+                                        .MemoryUsage        = MemoryUsage::eCPUToGPU,
+                                        .MemoryFlags        = vk::MemoryPropertyFlagBits::eHostVisible
+                                                              | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                        .PersistentlyMapped = true };
+        m_BufferAlloc = VulkanAllocator::AllocateBuffer(spec);
+        m_Data        = (u8*)m_BufferAlloc.MappedData;
+
+        LOG_INFO("Created frame allocator ... ({} per frame, Uniform alignment: {}, Storage alignment: {})",
+                 Core::Utility::BytesToString(m_FrameCapacity),
+                 m_UniformAlignment,
+                 m_StorageAlignment);
+    }
+
+    VulkanFrameAllocator::~VulkanFrameAllocator()
+    {
+        LOG_INFO("VulkanFrameAllocator::Destructor() ... (Peak: {} / {})",
+                 Core::Utility::BytesToString(m_PeakSize),
+                 Core::Utility::BytesToString(m_FrameCapacity));
+
+        VulkanAllocator::DestroyBuffer(m_BufferAlloc);
+    }
+
+    void VulkanFrameAllocator::BeginFrame(u32 frameIndex)
+    {
+        ASSERT(frameIndex < FRAMES_IN_FLIGHT, "Given frame index surpasses FRAMES_IN_FLIGHT!");
+
+        m_PeakSize   = std::max(m_PeakSize, GetUsedSize());
+        m_FrameIndex = frameIndex;
+        m_Head       = frameIndex * m_FrameCapacity;
+    }
+
+    FrameAllocation VulkanFrameAllocator::AllocateUniform(vk::DeviceSize size)
+    {
+        return Allocate(size, m_UniformAlignment);
+    }
+
+    FrameAllocation VulkanFrameAllocator::AllocateStorage(vk::DeviceSize size)
+    {
+        return Allocate(size, m_StorageAlignment);
+    }
+
+    FrameAllocation VulkanFrameAllocator::AllocateVertex(vk::DeviceSize size, vk::DeviceSize stride)
+    {
+        return Allocate(size, stride);
+    }
+
+    // ----- Private -----
+
+    FrameAllocation VulkanFrameAllocator::Allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+    {
+        ASSERT(size > 0, "Can't allocate zero bytes!");
+
+        const vk::DeviceSize offset   = ((m_Head + alignment - 1) / alignment) * alignment;
+        const vk::DeviceSize frameEnd = (m_FrameIndex + 1) * m_FrameCapacity;
+
+        ASSERT(offset + size <= frameEnd,
+               "Frame allocator ran out of memory ... ({} requested, {} per frame)",
+               size,
+               m_FrameCapacity);
+
+        m_Head = offset + size;
+        return { .Data = m_Data + offset, .Offset = (u32)offset };
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
+#include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace Engine::Graphics
+{
+    // Suballocation of the current frame, valid until the same frame slot comes around again
+    struct FrameAllocation
+    {
+        void* Data   = nullptr; // Mapped pointer to write the data to
+        u32   Offset = 0;       // Dynamic offset into the frame allocator buffer
+    };
+
+    // One persistently mapped buffer split into a linear region per frame in flight. Uniform and storage data gets
+    // bump allocated from the region of the current frame and bound through dynamic offsets, so descriptor sets
+    // never have to be rewritten. Vertex data (e.g. instance transforms) can be streamed from it as well. A region
+    // gets reset by BeginFrame once the frame's in-flight fence signaled.
+    class VulkanFrameAllocator
+    {
+    public:
+        explicit VulkanFrameAllocator(VulkanContext* context, vk::DeviceSize frameCapacity = FRAME_ALLOCATOR_CAPACITY);
+        ~VulkanFrameAllocator();
+
+        VulkanFrameAllocator(const VulkanFrameAllocator&)            = delete;
+        VulkanFrameAllocator& operator=(const VulkanFrameAllocator&) = delete;
+
+        // Only call after waiting for the frame slot's fence, the GPU may still read the region otherwise
+        void BeginFrame(u32 frameIndex);
+
+        [[nodiscard]] FrameAllocation AllocateUniform(vk::DeviceSize size);
+        [[nodiscard]] FrameAllocation AllocateStorage(vk::DeviceSize size);
+
+        // Aligning to the stride keeps the offset divisible by it, e.g. to address instances through firstInstance
+        [[nodiscard]] FrameAllocation AllocateVertex(vk::DeviceSize size, vk::DeviceSize stride);
+
+        // Allocates and fills uniform data in one go, returns the dynamic offset
+        template <typename T>
+        [[nodiscard]] u32 PushUniform(const T& data)
+        {
+            const FrameAllocation allocation = AllocateUniform(sizeof(T));
+            std::memcpy(allocation.Data, &data, sizeof(T));
+            return allocation.Offset;
+        }
+
+        [[nodiscard]] vk::Buffer     GetBuffer() const { return m_BufferAlloc.Buffer; };
+        [[nodiscard]] vk::DeviceSize GetFrameCapacity() const { return m_FrameCapacity; };
+        [[nodiscard]] vk::DeviceSize GetUsedSize() const { return m_Head - m_FrameIndex * m_FrameCapacity; };
+        [[nodiscard]] vk::DeviceSize GetPeakSize() const { return m_PeakSize; };
+
+    private:
+        [[nodiscard]] FrameAllocation Allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+
+        BufferAllocation m_BufferAlloc = {};
+        u8*              m_Data        = nullptr;
+
+        vk::DeviceSize m_FrameCapacity    = 0;
+        vk::DeviceSize m_UniformAlignment = 0;
+        vk::DeviceSize m_StorageAlignment = 0;
+        vk::DeviceSize m_Head             = 0; // Absolute offset of the next free byte
+        vk::DeviceSize m_PeakSize         = 0; // Largest amount a single frame used so far
+        u32            m_FrameIndex       = 0;
+    };
+}
@@ -0,0 +1,117 @@
+#include "VulkanGeometryArena.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanGeometryArena::VulkanGeometryArena(VulkanContext*       context,
+                                             VulkanUploadBatcher* uploadBatcher,
+                                             vk::DeviceSize       vertexCapacity,
+                                             vk::DeviceSize       indexCapacity)
+        : m_Context(context), m_UploadBatcher(uploadBatcher), m_VertexRanges(vertexCapacity),
+          m_IndexRanges(indexCapacity)
+    {
+        // Written by the transfer queue, read by the graphics queue
+        const VulkanDevice*      device        = m_Context->GetDevice();
+        const std::array<u32, 2> queueFamilies = { device->GetGraphicsQueueFamily(), device->GetTransferQueueFamily() };
+        const std::span<const u32> sharedFamilies =
+            queueFamilies[0] != queueFamilies[1] ? std::span<const u32>(queueFamilies) : std::span<const u32>();
+
+        const BufferSpecification vboSpec{ .Size             = vertexCapacity,
+                                           .BufferUsageFlags = vk::BufferUsageFlagBits::eVertexBuffer
+                                                               | vk::BufferUsageFlagBits::eTransferDst,
+                                           .MemoryUsage      = MemoryUsage::eGPUOnly,
+                                           .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                           .QueueFamilies    = sharedFamilies };
+        m_VertexBufferAlloc = VulkanAllocator::AllocateBuffer(vboSpec);
+
+        const BufferSpecification iboSpec{ .Size             = indexCapacity,
+                                           .BufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer
+                                                               | vk::BufferUsageFlagBits::eTransferDst,
+                                           .MemoryUsage      = MemoryUsage::eGPUOnly,
+                                           .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                           .QueueFamilies    = sharedFamilies };
+        m_IndexBufferAlloc = VulkanAllocator::AllocateBuffer(iboSpec);
+
+        LOG_INFO("Created geometry arena ... (Vertices: {}, Indices: {})",
+                 Core::Utility::BytesToString(vertexCapacity),
+                 Core::Utility::BytesToString(indexCapacity));
+    }
+
+    VulkanGeometryArena::~VulkanGeometryArena()
+    {
+        LOG_INFO("VulkanGeometryArena::Destructor() ...");
+
+        if (m_VertexRanges.GetUsedSize() > 0 || m_IndexRanges.GetUsedSize() > 0)
+        {
+            LOG_WARN("Geometry arena still holds {} of vertices and {} of indices ...",
+                     Core::Utility::BytesToString(m_VertexRanges.GetUsedSize()),
+                     Core::Utility::BytesToString(m_IndexRanges.GetUsedSize()));
+        }
+
+        VulkanAllocator::DestroyBuffer(m_VertexBufferAlloc);
+        VulkanAllocator::DestroyBuffer(m_IndexBufferAlloc);
+    }
+
+    GeometryAllocation VulkanGeometryArena::Upload(std::span<const u8> vertices,
+                                                   u32                 vertexStride,
+                                                   std::span<const u8> indices,
+                                                   IndexFormat         indexFormat)
+    {
+        ASSERT(!vertices.empty() && !indices.empty(), "Can't upload empty geometry!");
+        ASSERT(vertices.size() % vertexStride == 0, "Vertex data isn't a multiple of the vertex stride!");
+
+        const u32 indexSize = GetIndexSize(indexFormat);
+
+        // Aligning to the strides turns the byte offsets into vertexOffset and firstIndex
+        GeometryAllocation allocation{ .Vertices = m_VertexRanges.Allocate(vertices.size(), vertexStride),
+                                       .Indices  = m_IndexRanges.Allocate(indices.size(), indexSize) };
+
+        ASSERT(allocation.Vertices.IsValid(), "Geometry arena is out of vertex memory!");
+        ASSERT(allocation.Indices.IsValid(), "Geometry arena is out of index memory!");
+
+        allocation.VertexOffset = (i32)(allocation.Vertices.Offset / vertexStride);
+        allocation.FirstIndex   = (u32)(allocation.Indices.Offset / indexSize);
+
+        // Both copies usually land in the same batch, a full staging ring can split them up though
+        const UploadTicket vertexTicket =
+            m_UploadBatcher->Upload(m_VertexBufferAlloc.Buffer, allocation.Vertices.Offset, vertices);
+        const UploadTicket indexTicket =
+            m_UploadBatcher->Upload(m_IndexBufferAlloc.Buffer, allocation.Indices.Offset, indices);
+        allocation.Ticket = { .Value = std::max(vertexTicket.Value, indexTicket.Value) };
+
+        LOG_INFO("Queued geometry upload into arena ... (Vertex offset: {}, First index: {}, Size: {}, Arena: {} / {})",
+                 allocation.VertexOffset,
+                 allocation.FirstIndex,
+                 Core::Utility::BytesToString(vertices.size() + indices.size()),
+                 Core::Utility::BytesToString(m_VertexRanges.GetUsedSize() + m_IndexRanges.GetUsedSize()),
+                 Core::Utility::BytesToString(m_VertexRanges.GetCapacity() + m_IndexRanges.GetCapacity()));
+
+        return allocation;
+    }
+
+    void VulkanGeometryArena::Free(const GeometryAllocation& allocation)
+    {
+        m_VertexRanges.Free(allocation.Vertices);
+        m_IndexRanges.Free(allocation.Indices);
+    }
+
+    void VulkanGeometryArena::BindVertexBuffer(vk::CommandBuffer commandBuffer) const
+    {
+        const vk::DeviceSize offset = 0;
+        commandBuffer.bindVertexBuffers(0, 1, &m_VertexBufferAlloc.Buffer, &offset);
+    }
+
+    void VulkanGeometryArena::BindIndexBuffer(vk::CommandBuffer commandBuffer, IndexFormat format) const
+    {
+        const vk::IndexType type = format == IndexFormat::eUint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+        commandBuffer.bindIndexBuffer(m_IndexBufferAlloc.Buffer, 0, type);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Core/RangeAllocator.hpp"
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
+#include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+#include "Graphics/Vulkan/VulkanUploadBatcher.hpp"
+
+#include <span>
+
+namespace Engine::Graphics
+{
+    // Location of a model inside the shared geometry buffers
+    struct GeometryAllocation
+    {
+        Core::RangeAllocation Vertices;
+        Core::RangeAllocation Indices;
+        i32                   VertexOffset = 0; // In vertices of the uploaded stride, passed to drawIndexed
+        u32                   FirstIndex   = 0; // In indices of the uploaded index format, passed to drawIndexed
+        UploadTicket          Ticket;           // Ranges can't be drawn before the upload completed
+    };
+
+    // Owns one device-local vertex buffer and one index buffer, which get suballocated for all models. Draws only
+    // differ in vertexOffset/firstIndex, so the buffers get bound once per pass instead of once per model.
+    class VulkanGeometryArena
+    {
+    public:
+        VulkanGeometryArena(VulkanContext*       context,
+                            VulkanUploadBatcher* uploadBatcher,
+                            vk::DeviceSize       vertexCapacity = GEOMETRY_ARENA_VERTEX_CAPACITY,
+                            vk::DeviceSize       indexCapacity  = GEOMETRY_ARENA_INDEX_CAPACITY);
+        ~VulkanGeometryArena();
+
+        VulkanGeometryArena(const VulkanGeometryArena&)            = delete;
+        VulkanGeometryArena& operator=(const VulkanGeometryArena&) = delete;
+
+        // Suballocates both ranges (aligned to their strides) and queues the copies on the upload batcher
+        [[nodiscard]] GeometryAllocation Upload(std::span<const u8> vertices,
+                                                u32                 vertexStride,
+                                                std::span<const u8> indices,
+                                                IndexFormat         indexFormat);
+
+        // Ranges must not be in use by the GPU anymore
+        void Free(const GeometryAllocation& allocation);
+
+        void BindVertexBuffer(vk::CommandBuffer commandBuffer) const;
+        void BindIndexBuffer(vk::CommandBuffer commandBuffer, IndexFormat format) const;
+
+        [[nodiscard]] vk::Buffer GetVertexBuffer() const { return m_VertexBufferAlloc.Buffer; };
+        [[nodiscard]] vk::Buffer GetIndexBuffer() const { return m_IndexBufferAlloc.Buffer; };
+        [[nodiscard]] u64        GetUsedVertexSize() const { return m_VertexRanges.GetUsedSize(); };
+        [[nodiscard]] u64        GetUsedIndexSize() const { return m_IndexRanges.GetUsedSize(); };
+
+    private:
+        VulkanContext*       m_Context           = nullptr;
+        VulkanUploadBatcher* m_UploadBatcher     = nullptr;
+        BufferAllocation     m_VertexBufferAlloc = {};
+        BufferAllocation     m_IndexBufferAlloc  = {};
+
+        Core::RangeAllocator m_VertexRanges;
+        Core::RangeAllocator m_IndexRanges;
+    };
+}
@@ -6,45 +6,37 @@ namespace Engine::Graphics
 {
     // ----- Public -----
 
-    VulkanGlobalUniforms::VulkanGlobalUniforms(VulkanContext* context) : m_Context(context)
+    VulkanGlobalUniforms::VulkanGlobalUniforms(VulkanContext* context, VulkanFrameAllocator* frameAllocator)
+        : m_Context(context), m_FrameAllocator(frameAllocator)
     {
         CreatePool();
         CreateLayout();
-        AllocateBuffers();
-        AllocateDescriptorSets();
-        WriteDescriptorSets();
+        AllocateDescriptorSet();
+        WriteDescriptorSet();
     }
 
     VulkanGlobalUniforms::~VulkanGlobalUniforms()
     {
         LOG_INFO("VulkanGlobalUniforms::Destructor() ...");
-
-        for (u8 i = 0; i < FRAMES_IN_FLIGHT; i++)
-        {
-            VulkanAllocator::DestroyBuffer(m_BufferAllocs.at(i));
-        }
     }
 
-    void VulkanGlobalUniforms::Update(u32 frameIndex, const GlobalUniformData* data)
+    u32 VulkanGlobalUniforms::Update(const GlobalUniformData* data)
     {
-        ASSERT(frameIndex < FRAMES_IN_FLIGHT, "Given frame index surpasses FRAMES_IN_FLIGHT!");
         ASSERT(data != nullptr, "GlobalUniformData pointer was invalid!");
 
-        auto* dataPtr = VulkanAllocator::MapMemory(m_BufferAllocs.at(frameIndex).Allocation);
-        std::memcpy(dataPtr, data, sizeof(GlobalUniformData));
-        VulkanAllocator::UnmapMemory(m_BufferAllocs.at(frameIndex).Allocation);
+        return m_FrameAllocator->PushUniform(*data);
     }
 
     // ----- Private -----
 
     void VulkanGlobalUniforms::CreatePool()
     {
-        const vk::DescriptorPoolSize poolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                                               .descriptorCount = FRAMES_IN_FLIGHT };
+        const vk::DescriptorPoolSize poolSize{ .type            = vk::DescriptorType::eUniformBufferDynamic,
+                                               .descriptorCount = GLOBAL_UNIFORM_BINDING_DESCRIPTOR_COUNT };
 
         const DescriptorPoolSpecification spec{
             .Flags     = {},
-            .MaxSets   = FRAMES_IN_FLIGHT,
+            .MaxSets   = 1,
             .PoolSizes = { poolSize },
         };
 
@@ -54,60 +46,41 @@ namespace Engine::Graphics
     void VulkanGlobalUniforms::CreateLayout()
     {
         const vk::DescriptorSetLayoutBinding binding{ .binding            = 0,
-                                                      .descriptorType     = vk::DescriptorType::eUniformBuffer,
+                                                      .descriptorType     = vk::DescriptorType::eUniformBufferDynamic,
                                                       .descriptorCount    = GLOBAL_UNIFORM_BINDING_DESCRIPTOR_COUNT,
                                                       .stageFlags         = vk::ShaderStageFlagBits::eVertex,
                                                       .pImmutableSamplers = nullptr };
 
         const DescriptorSetLayoutSpecification spec = { .Flags = {}, .Bindings = { binding } };
 
-        m_DescriptorLayout = MakeScope<VulkanDescriptorSetLayout>(m_Context->GetDevice()->GetHandle(), spec);
+        m_DescriptorLayout = m_Context->GetLayoutCache()->GetDescriptorSetLayout(spec);
     }
 
-    void VulkanGlobalUniforms::AllocateBuffers()
+    void VulkanGlobalUniforms::AllocateDescriptorSet()
     {
-        const BufferSpecification spec{ .Size             = sizeof(GlobalUniformData),
-                                        .BufferUsageFlags = vk::BufferUsageFlagBits::eUniformBuffer,
-                                        .MemoryUsage      = MemoryUsage::eCPUToGPU,
-                                        .MemoryFlags      = vk::MemoryPropertyFlagBits::eHostVisible
-                                                            | vk::MemoryPropertyFlagBits::eHostCoherent };
-
-        for (u8 i = 0; i < FRAMES_IN_FLIGHT; i++)
-        {
-            m_BufferAllocs.at(i) = VulkanAllocator::AllocateBuffer(spec);
-        }
-    }
-
-    void VulkanGlobalUniforms::AllocateDescriptorSets()
-    {
-        std::array<vk::DescriptorSetLayout, FRAMES_IN_FLIGHT> layouts{};
-        layouts.fill(m_DescriptorLayout->GetHandle());
-
+        const vk::DescriptorSetLayout       layout = m_DescriptorLayout->GetHandle();
         const vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool     = m_DescriptorPool->GetHandle(),
-                                                       .descriptorSetCount = FRAMES_IN_FLIGHT,
-                                                       .pSetLayouts        = layouts.data() };
+                                                       .descriptorSetCount = 1,
+                                                       .pSetLayouts        = &layout };
 
-        VK_VERIFY(m_Context->GetDevice()->GetHandle().allocateDescriptorSets(&allocInfo, m_DescriptorSets.data()));
-        LOG_INFO("Created descriptor sets ... {}", FRAMES_IN_FLIGHT);
+        VK_VERIFY(m_Context->GetDevice()->GetHandle().allocateDescriptorSets(&allocInfo, &m_DescriptorSet));
+        LOG_INFO("Created global descriptor set ...");
     }
 
-    void VulkanGlobalUniforms::WriteDescriptorSets()
+    void VulkanGlobalUniforms::WriteDescriptorSet()
     {
-        for (u8 i = 0; i < FRAMES_IN_FLIGHT; i++)
-        {
-            const vk::DescriptorBufferInfo bufferInfo{ .buffer = m_BufferAllocs.at(i).Buffer,
-                                                       .offset = 0,
-                                                       .range  = sizeof(GlobalUniformData) };
-
-            const vk::WriteDescriptorSet descriptorWrite{ .dstSet          = m_DescriptorSets[i],
-                                                          .dstBinding      = 0,
-                                                          .dstArrayElement = 0,
-                                                          .descriptorCount = 1,
-                                                          .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                                          .pImageInfo      = nullptr,
-                                                          .pBufferInfo     = &bufferInfo };
-
-            m_Context->GetDevice()->GetHandle().updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
-        }
+        const vk::DescriptorBufferInfo bufferInfo{ .buffer = m_FrameAllocator->GetBuffer(),
+                                                   .offset = 0,
+                                                   .range  = sizeof(GlobalUniformData) };
+
+        const vk::WriteDescriptorSet descriptorWrite{ .dstSet          = m_DescriptorSet,
+                                                      .dstBinding      = 0,
+                                                      .dstArrayElement = 0,
+                                                      .descriptorCount = 1,
+                                                      .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+                                                      .pImageInfo      = nullptr,
+                                                      .pBufferInfo     = &bufferInfo };
+
+        m_Context->GetDevice()->GetHandle().updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
     }
 }
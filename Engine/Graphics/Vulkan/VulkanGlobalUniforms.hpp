@@ -4,61 +4,63 @@
 #include "Graphics/Vulkan/VulkanContext.hpp"
 #include "Graphics/Vulkan/VulkanDescriptorPool.hpp"
 #include "Graphics/Vulkan/VulkanDescriptorSetLayout.hpp"
+#include "Graphics/Vulkan/VulkanFrameAllocator.hpp"
 
 #include "Vendor/glm/mat4x4.hpp"
 
 namespace Engine::Graphics
 {
+    // Camera of the frame, model matrices are streamed per instance or pushed per draw
     struct GlobalUniformData
     {
-        alignas(16) glm::mat4 Model;
         alignas(16) glm::mat4 View;
         alignas(16) glm::mat4 Projection;
     };
 
+    // Pushed with every draw which needs it, applied on top of the instance transform (identity for instanced draws)
+    struct DrawPushConstants
+    {
+        alignas(16) glm::mat4 Model;
+    };
+
     class VulkanGlobalUniforms
     {
     public:
-        // Owns the per-frame global uniform buffers and the descriptor infrastructure
-        VulkanGlobalUniforms(VulkanContext* context);
+        // Owns the descriptor infrastructure, the uniform data itself lives in the frame allocator
+        VulkanGlobalUniforms(VulkanContext* context, VulkanFrameAllocator* frameAllocator);
 
-        // Releases all per-frame uniform buffers; descriptor layout/pool are released by their RAII wrappers
+        // The descriptor pool is released by its RAII wrapper, the layout belongs to the layout cache
         ~VulkanGlobalUniforms();
 
         VulkanGlobalUniforms(const VulkanGlobalUniforms&)            = delete;
         VulkanGlobalUniforms& operator=(const VulkanGlobalUniforms&) = delete;
 
-        // Copies the current global uniform data into the uniform buffer belonging to the active frame-in-flight
-        void Update(u32 frameIndex, const GlobalUniformData* data);
+        // Copies the current global uniform data into the current frame's region, returns the dynamic offset to bind
+        [[nodiscard]] u32 Update(const GlobalUniformData* data);
 
-        [[nodiscard]] const VulkanDescriptorSetLayout* GetLayout() const { return m_DescriptorLayout.get(); };
-        [[nodiscard]] const vk::DescriptorSet*         GetDescriptorSet(u32 frameIndex) const
-        {
-            return &m_DescriptorSets.at(frameIndex);
-        }
+        [[nodiscard]] const VulkanDescriptorSetLayout* GetLayout() const { return m_DescriptorLayout; };
+        [[nodiscard]] const vk::DescriptorSet*         GetDescriptorSet() const { return &m_DescriptorSet; }
 
     private:
-        // Creates the descriptor pool, which reserves descriptor-set storage for all per-frame global uniform sets
+        // Creates the descriptor pool, which reserves storage for the single global uniform set
         void CreatePool();
 
-        // Creates the descriptor set layout, which declares a vertex-stage uniform buffer
+        // Fetches the descriptor set layout, which declares a vertex-stage dynamic uniform buffer. It's the same one
+        // the layout cache hands out for pipelines reflecting the global uniform block.
         void CreateLayout();
 
-        // Allocates one CPU-updated uniform buffer per frame-in-flight
-        void AllocateBuffers();
-
-        // Allocates one descriptor set per frame-in-flight from the pool using the global uniform layout
-        void AllocateDescriptorSets();
+        // Allocates the descriptor set from the pool using the global uniform layout
+        void AllocateDescriptorSet();
 
-        // Writes each descriptor set so it references the matching frame's uniform buffer
-        void WriteDescriptorSets();
+        // Writes the descriptor set so it references the frame allocator buffer, offsets get supplied on binding
+        void WriteDescriptorSet();
 
-        VulkanContext* m_Context = nullptr;
+        VulkanContext*        m_Context        = nullptr;
+        VulkanFrameAllocator* m_FrameAllocator = nullptr;
 
         Scope<VulkanDescriptorPool>      m_DescriptorPool;
-        Scope<VulkanDescriptorSetLayout> m_DescriptorLayout;
+        const VulkanDescriptorSetLayout* m_DescriptorLayout = nullptr;
 
-        [[maybe_unused]] std::array<BufferAllocation, FRAMES_IN_FLIGHT>  m_BufferAllocs;
-        [[maybe_unused]] std::array<vk::DescriptorSet, FRAMES_IN_FLIGHT> m_DescriptorSets;
+        vk::DescriptorSet m_DescriptorSet;
     };
 }
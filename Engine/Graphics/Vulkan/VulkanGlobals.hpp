@@ -26,12 +26,40 @@ namespace Engine::Graphics
     };
     // clang-format on
 
-    inline static constexpr u32 MAX_SHADER_COUNT   = 2;
-    inline static constexpr u32 MAX_MODEL_COUNT    = 2;
-    inline static constexpr u32 MAX_PIPELINE_COUNT = 1;
-
     inline static constexpr u32 FRAMES_IN_FLIGHT = 3;
 
+    // Capacity of the shared device-local buffers all model geometry gets suballocated from
+    inline static constexpr vk::DeviceSize GEOMETRY_ARENA_VERTEX_CAPACITY = 64 * 1024 * 1024;
+    inline static constexpr vk::DeviceSize GEOMETRY_ARENA_INDEX_CAPACITY  = 32 * 1024 * 1024;
+
+    // Capacity of the persistently mapped ring all uploads get staged in, larger uploads get split into chunks
+    inline static constexpr vk::DeviceSize STAGING_RING_CAPACITY = 32 * 1024 * 1024;
+
+    // Uniform, storage and instance data a single frame can allocate from the frame allocator
+    inline static constexpr vk::DeviceSize FRAME_ALLOCATOR_CAPACITY = 8 * 1024 * 1024;
+
+    // GPU culling limits: objects per frame, levels of detail per object and threads per workgroup (has to match the
+    // culling shader). Every index format gets its own draw group, since an indirect call binds one index buffer.
+    inline static constexpr u32 GPU_CULLING_MAX_OBJECTS    = 32768;
+    inline static constexpr u32 GPU_CULLING_MAX_LODS       = 4;
+    inline static constexpr u32 GPU_CULLING_WORKGROUP_SIZE = 64;
+    inline static constexpr u32 GPU_CULLING_DRAW_GROUPS    = 2;
+
+    // Threads per workgroup along each axis of the depth pyramid reduction (has to match the reduction shader)
+    inline static constexpr u32 DEPTH_PYRAMID_WORKGROUP_SIZE = 8;
+
+    // Draws a thread has to record at least before the scene gets split into another secondary command buffer
+    inline static constexpr u32 RECORDING_MIN_DRAWS_PER_PARTITION = 256;
+
+    // Named GPU timestamp scopes a single frame can record, every scope takes two queries
+    inline static constexpr u32 GPU_PROFILER_MAX_SCOPES = 32;
+
+    // Pipeline statistics queries a single frame can record, every secondary command buffer of a pass takes one
+    inline static constexpr u32 GPU_PROFILER_MAX_STATISTICS = 256;
+
+    // Largest simplification error in pixels a level of detail may show on screen before a finer one gets picked
+    inline static constexpr f32 LOD_ERROR_THRESHOLD = 1.0f;
+
     // Number of color attachments written by the graphics pipeline during dynamic rendering.
     // Currently only the swapchain color image at attachment location 0 is used.
     inline static constexpr u32 GLOBAL_COLOR_ATTACHMENT_COUNT = 1;
@@ -41,6 +69,6 @@ namespace Engine::Graphics
     inline static constexpr u32 GLOBAL_DESCRIPTOR_SET_LAYOUT_COUNT = 1;
 
     // Number of uniform buffer descriptors at set 0, binding 0.
-    // One descriptor references the complete GlobalUniformData buffer for the current frame.
+    // One dynamic descriptor references GlobalUniformData, the frame's copy gets selected by its dynamic offset.
     inline static constexpr u32 GLOBAL_UNIFORM_BINDING_DESCRIPTOR_COUNT = 1;
 }
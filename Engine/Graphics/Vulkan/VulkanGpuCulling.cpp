@@ -0,0 +1,399 @@
+#include "VulkanGpuCulling.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+#include "Graphics/Vulkan/VulkanGlobalUniforms.hpp"
+
+#include <cstring>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    // Every phase has its own command ranges and draw counts, the number of occluded objects follows the counts
+    constexpr u32            PHASE_COUNT    = 2;
+    constexpr u32            OCCLUDED_COUNT = PHASE_COUNT * Graphics::GPU_CULLING_DRAW_GROUPS;
+    constexpr vk::DeviceSize COMMAND_SIZE   = sizeof(vk::DrawIndexedIndirectCommand);
+    constexpr vk::DeviceSize COUNTS_SIZE    = (OCCLUDED_COUNT + 1) * sizeof(u32);
+
+    // Passes of the culling shader
+    constexpr u32 PASS_FRUSTUM = 0;
+    constexpr u32 PASS_EARLY   = 1;
+    constexpr u32 PASS_LATE    = 2;
+
+    void InsertMemoryBarrier(vk::CommandBuffer       cmdBuffer,
+                             vk::PipelineStageFlags2 srcStage,
+                             vk::AccessFlags2        srcAccess,
+                             vk::PipelineStageFlags2 dstStage,
+                             vk::AccessFlags2        dstAccess)
+    {
+        const vk::MemoryBarrier2 barrier{
+            .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess
+        };
+        const vk::DependencyInfo dependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier };
+        cmdBuffer.pipelineBarrier2(&dependencyInfo);
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanGpuCulling::VulkanGpuCulling(VulkanContext*        context,
+                                       VulkanFrameAllocator* frameAllocator,
+                                       const VulkanShader*   cullShader,
+                                       const VulkanShader*   pyramidShader)
+        : m_Context(context), m_FrameAllocator(frameAllocator)
+    {
+        ASSERT(cullShader != nullptr, "GPU culling requires a compute shader!");
+
+        m_Objects.reserve(GPU_CULLING_MAX_OBJECTS);
+        m_DepthPyramid = MakeScope<VulkanDepthPyramid>(context, pyramidShader);
+
+        // Objects and global uniforms live in the frame allocator and get selected by a dynamic offset, the outputs
+        // are fixed
+        ShaderReflection reflection = cullShader->GetReflection();
+        reflection.MakeDynamic(0, 0);
+        reflection.MakeDynamic(0, 3);
+
+        CreateBuffers();
+        CreateDescriptors(reflection);
+        CreatePipeline(cullShader, reflection);
+
+        LOG_INFO("Created GPU culling ... (Objects: {}, Commands: {})",
+                 GPU_CULLING_MAX_OBJECTS,
+                 Core::Utility::BytesToString(PHASE_COUNT * GPU_CULLING_MAX_OBJECTS * COMMAND_SIZE));
+    }
+
+    VulkanGpuCulling::~VulkanGpuCulling()
+    {
+        LOG_INFO("VulkanGpuCulling::Destructor() ...");
+
+        m_Context->GetDevice()->GetHandle().destroyPipeline(m_Pipeline);
+
+        VulkanAllocator::DestroyBuffer(m_CommandBufferAlloc);
+        VulkanAllocator::DestroyBuffer(m_CountBufferAlloc);
+        VulkanAllocator::DestroyBuffer(m_VisibilityBufferAlloc);
+        VulkanAllocator::DestroyBuffer(m_ReadbackBufferAlloc);
+    }
+
+    void VulkanGpuCulling::BeginFrame(u32 frameIndex)
+    {
+        ASSERT(frameIndex < FRAMES_IN_FLIGHT, "Given frame index surpasses FRAMES_IN_FLIGHT!");
+        m_FrameIndex = frameIndex;
+
+        // The fence of this slot signaled, so its copy of the counts arrived
+        if (m_ReadbackPending.at(m_FrameIndex))
+        {
+            const u32* counts = m_ReadbackData + (m_FrameIndex * (OCCLUDED_COUNT + 1));
+
+            m_VisibleCount = 0;
+            for (u32 count = 0; count < OCCLUDED_COUNT; count++)
+            {
+                m_VisibleCount += counts[count];
+            }
+            m_OccludedCount = counts[OCCLUDED_COUNT];
+
+            m_ReadbackPending.at(m_FrameIndex) = false;
+        }
+
+        m_Objects.clear();
+        m_GroupObjectCounts = {};
+    }
+
+    void VulkanGpuCulling::AddObject(const GpuObject& object)
+    {
+        ASSERT(m_Objects.size() < GPU_CULLING_MAX_OBJECTS,
+               "GPU culling can't take more than {} objects!",
+               GPU_CULLING_MAX_OBJECTS);
+        ASSERT(object.DrawGroup < GPU_CULLING_DRAW_GROUPS, "Draw group '{}' doesn't exist!", object.DrawGroup);
+        ASSERT(object.LodCount > 0 && object.LodCount <= GPU_CULLING_MAX_LODS, "Invalid level of detail count!");
+
+        m_Objects.push_back(object);
+        m_GroupObjectCounts.at(object.DrawGroup)++;
+    }
+
+    void VulkanGpuCulling::Cull(vk::CommandBuffer    cmdBuffer,
+                                GpuCullingParameters parameters,
+                                u32                  globalsOffset,
+                                b8                   occlusion)
+    {
+        m_Occlusion = occlusion;
+
+        // Follow swapchain resizes before the descriptor set gets bound
+        if (m_DepthPyramid->Update(cmdBuffer))
+        {
+            WriteDepthPyramidDescriptor();
+        }
+
+        if (m_Objects.empty())
+        {
+            return;
+        }
+
+        // Every group gets a command range large enough for all of its objects
+        u32 offset = 0;
+        for (u32 group = 0; group < GPU_CULLING_DRAW_GROUPS; group++)
+        {
+            m_GroupOffsets.at(group) = offset;
+            offset += m_GroupObjectCounts.at(group);
+        }
+
+        // Write the object buffer of this frame
+        const vk::DeviceSize  objectsSize = m_Objects.size() * sizeof(GpuObject);
+        const FrameAllocation objects     = m_FrameAllocator->AllocateStorage(objectsSize);
+
+        for (GpuObject& object : m_Objects)
+        {
+            object.CommandOffset = m_GroupOffsets.at(object.DrawGroup);
+        }
+
+        std::memcpy(objects.Data, m_Objects.data(), objectsSize);
+
+        // Previous indirect reads and count copies have to finish before the counts get cleared and commands rewritten.
+        // The last frame's shader writes (counts, visibility) have to be visible to the clears and the culling pass.
+        InsertMemoryBarrier(cmdBuffer,
+                            vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eTransfer
+                                | vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eShaderStorageWrite,
+                            vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eShaderStorageRead
+                                | vk::AccessFlagBits2::eShaderStorageWrite);
+
+        cmdBuffer.fillBuffer(m_CountBufferAlloc.Buffer, 0, COUNTS_SIZE, 0);
+
+        // Nothing counts as visible before the first test, the late pass then draws everything which isn't occluded
+        if (!m_VisibilityCleared)
+        {
+            cmdBuffer.fillBuffer(m_VisibilityBufferAlloc.Buffer, 0, vk::WholeSize, 0);
+            m_VisibilityCleared = true;
+        }
+
+        InsertMemoryBarrier(cmdBuffer,
+                            vk::PipelineStageFlagBits2::eTransfer,
+                            vk::AccessFlagBits2::eTransferWrite,
+                            vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+
+        // Cull and compact
+        m_Parameters             = parameters;
+        m_Parameters.ObjectCount = (u32)m_Objects.size();
+        m_DynamicOffsets         = { objects.Offset, globalsOffset };
+
+        Dispatch(cmdBuffer, occlusion ? PASS_EARLY : PASS_FRUSTUM);
+    }
+
+    void VulkanGpuCulling::CullOccluded(vk::CommandBuffer cmdBuffer)
+    {
+        ASSERT(m_Occlusion, "Occlusion culling wasn't requested by Cull!");
+
+        if (m_Objects.empty())
+        {
+            return;
+        }
+
+        // The pyramid build waits for the early pass, which read the visibility the late pass overwrites
+        m_DepthPyramid->Build(cmdBuffer);
+
+        Dispatch(cmdBuffer, PASS_LATE);
+    }
+
+    void VulkanGpuCulling::Draw(vk::CommandBuffer cmdBuffer, u32 drawGroup, CullingPhase phase) const
+    {
+        const u32 objectCount = m_GroupObjectCounts.at(drawGroup);
+        if (objectCount == 0)
+        {
+            return;
+        }
+
+        ASSERT(phase == CullingPhase::eEarly || m_Occlusion, "The late phase only exists with occlusion culling!");
+
+        const u32 commandOffset = ((u32)phase * (u32)m_Objects.size()) + m_GroupOffsets.at(drawGroup);
+        const u32 countIndex    = ((u32)phase * GPU_CULLING_DRAW_GROUPS) + drawGroup;
+
+        cmdBuffer.drawIndexedIndirectCount(m_CommandBufferAlloc.Buffer,
+                                           commandOffset * COMMAND_SIZE,
+                                           m_CountBufferAlloc.Buffer,
+                                           countIndex * sizeof(u32),
+                                           objectCount,
+                                           (u32)COMMAND_SIZE);
+    }
+
+    void VulkanGpuCulling::CopyVisibleCounts(vk::CommandBuffer cmdBuffer)
+    {
+        if (m_Objects.empty())
+        {
+            return;
+        }
+
+        const vk::BufferCopy region{ .srcOffset = 0, .dstOffset = m_FrameIndex * COUNTS_SIZE, .size = COUNTS_SIZE };
+        cmdBuffer.copyBuffer(m_CountBufferAlloc.Buffer, m_ReadbackBufferAlloc.Buffer, 1, &region);
+
+        // Make the copy visible to the host once the frame's fence signaled
+        InsertMemoryBarrier(cmdBuffer,
+                            vk::PipelineStageFlagBits2::eCopy,
+                            vk::AccessFlagBits2::eTransferWrite,
+                            vk::PipelineStageFlagBits2::eHost,
+                            vk::AccessFlagBits2::eHostRead);
+
+        m_ReadbackPending.at(m_FrameIndex) = true;
+    }
+
+    // ----- Private -----
+
+    void VulkanGpuCulling::CreateBuffers()
+    {
+        const BufferSpecification commandSpec{ .Size             = PHASE_COUNT * GPU_CULLING_MAX_OBJECTS * COMMAND_SIZE,
+                                               .BufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer
+                                                                   | vk::BufferUsageFlagBits::eIndirectBuffer,
+                                               .MemoryUsage      = MemoryUsage::eGPUOnly,
+                                               .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal };
+        m_CommandBufferAlloc = VulkanAllocator::AllocateBuffer(commandSpec);
+
+        const BufferSpecification countSpec{ .Size             = COUNTS_SIZE,
+                                             .BufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer
+                                                                 | vk::BufferUsageFlagBits::eIndirectBuffer
+                                                                 | vk::BufferUsageFlagBits::eTransferSrc
+                                                                 | vk::BufferUsageFlagBits::eTransferDst,
+                                             .MemoryUsage      = MemoryUsage::eGPUOnly,
+                                             .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal };
+        m_CountBufferAlloc = VulkanAllocator::AllocateBuffer(countSpec);
+
+        const BufferSpecification visibilitySpec{ .Size             = GPU_CULLING_MAX_OBJECTS * sizeof(u32),
+                                                  .BufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer
+                                                                      | vk::BufferUsageFlagBits::eTransferDst,
+                                                  .MemoryUsage      = MemoryUsage::eGPUOnly,
+                                                  .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal };
+        m_VisibilityBufferAlloc = VulkanAllocator::AllocateBuffer(visibilitySpec);
+
+        const BufferSpecification readbackSpec{ .Size               = FRAMES_IN_FLIGHT * COUNTS_SIZE,
+                                                .BufferUsageFlags   = vk::BufferUsageFlagBits::eTransferDst,
+                                                .MemoryUsage        = MemoryUsage::eGPUToCPU,
+                                                .MemoryFlags        = vk::MemoryPropertyFlagBits::eHostVisible
+                                                                      | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                .PersistentlyMapped = true };
+        m_ReadbackBufferAlloc = VulkanAllocator::AllocateBuffer(readbackSpec);
+        m_ReadbackData        = (const u32*)m_ReadbackBufferAlloc.MappedData;
+    }
+
+    void VulkanGpuCulling::CreateDescriptors(const ShaderReflection& reflection)
+    {
+        const vk::Device device = m_Context->GetDevice()->GetHandle();
+
+        const DescriptorPoolSpecification poolSpec{
+            .Flags     = {},
+            .MaxSets   = 1,
+            .PoolSizes = { { .type = vk::DescriptorType::eStorageBufferDynamic, .descriptorCount = 1 },
+                           { .type = vk::DescriptorType::eStorageBuffer, .descriptorCount = 3 },
+                           { .type = vk::DescriptorType::eUniformBufferDynamic, .descriptorCount = 1 },
+                           { .type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 1 } },
+        };
+        m_DescriptorPool = MakeScope<VulkanDescriptorPool>(device, poolSpec);
+
+        ASSERT(reflection.Sets.size() == 1 && reflection.Sets[0].size() == 6,
+               "Culling shader doesn't match the culling descriptor set!");
+        const DescriptorSetLayoutSpecification layoutSpec = { .Flags = {}, .Bindings = reflection.Sets[0] };
+        m_DescriptorLayout = m_Context->GetLayoutCache()->GetDescriptorSetLayout(layoutSpec);
+
+        const vk::DescriptorSetLayout       layout = m_DescriptorLayout->GetHandle();
+        const vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool     = m_DescriptorPool->GetHandle(),
+                                                       .descriptorSetCount = 1,
+                                                       .pSetLayouts        = &layout };
+        VK_VERIFY(device.allocateDescriptorSets(&allocInfo, &m_DescriptorSet));
+
+        // The object count varies per frame, so the object range reaches up to the end of the frame allocator buffer.
+        // The depth pyramid gets written once it exists.
+        const std::array<vk::DescriptorBufferInfo, 5> bufferInfos = {
+            vk::DescriptorBufferInfo{ .buffer = m_FrameAllocator->GetBuffer(), .offset = 0, .range = vk::WholeSize },
+            vk::DescriptorBufferInfo{ .buffer = m_CommandBufferAlloc.Buffer, .offset = 0, .range = vk::WholeSize },
+            vk::DescriptorBufferInfo{ .buffer = m_CountBufferAlloc.Buffer, .offset = 0, .range = vk::WholeSize },
+            vk::DescriptorBufferInfo{ .buffer = m_FrameAllocator->GetBuffer(),
+                                      .offset = 0,
+                                      .range  = sizeof(GlobalUniformData) },
+            vk::DescriptorBufferInfo{ .buffer = m_VisibilityBufferAlloc.Buffer, .offset = 0, .range = vk::WholeSize }
+        };
+        const std::array<vk::DescriptorType, 5> bufferTypes = {
+            vk::DescriptorType::eStorageBufferDynamic, vk::DescriptorType::eStorageBuffer,
+            vk::DescriptorType::eStorageBuffer,        vk::DescriptorType::eUniformBufferDynamic,
+            vk::DescriptorType::eStorageBuffer
+        };
+
+        std::array<vk::WriteDescriptorSet, 5> writes = {};
+        for (u32 binding = 0; binding < writes.size(); binding++)
+        {
+            writes[binding] = { .dstSet          = m_DescriptorSet,
+                                .dstBinding      = binding,
+                                .dstArrayElement = 0,
+                                .descriptorCount = 1,
+                                .descriptorType  = bufferTypes[binding],
+                                .pBufferInfo     = &bufferInfos[binding] };
+        }
+
+        device.updateDescriptorSets((u32)writes.size(), writes.data(), 0, nullptr);
+    }
+
+    void VulkanGpuCulling::CreatePipeline(const VulkanShader* cullShader, const ShaderReflection& reflection)
+    {
+        const vk::Device device = m_Context->GetDevice()->GetHandle();
+
+        ASSERT(reflection.PushConstantRanges.size() == 1
+                   && reflection.PushConstantRanges[0].size == sizeof(GpuCullingParameters),
+               "Culling shader parameters don't match GpuCullingParameters!");
+        m_Layout = m_Context->GetLayoutCache()->GetPipelineLayout(reflection);
+
+        const vk::PipelineShaderStageCreateInfo stage = cullShader->GetPipelineShaderStageCreateInfo();
+        ASSERT(stage.stage == vk::ShaderStageFlagBits::eCompute, "Culling shader has to be a compute shader!");
+
+        const vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stage, .layout = m_Layout };
+        VK_VERIFY(device.createComputePipelines(
+            m_Context->GetPipelineCache()->GetHandle(), 1, &pipelineInfo, nullptr, &m_Pipeline));
+
+        LOG_INFO("Created culling pipeline ...");
+    }
+
+    void VulkanGpuCulling::WriteDepthPyramidDescriptor()
+    {
+        const vk::DescriptorImageInfo imageInfo{ .sampler     = m_DepthPyramid->GetSampler(),
+                                                 .imageView   = m_DepthPyramid->GetView(),
+                                                 .imageLayout = vk::ImageLayout::eGeneral };
+        const vk::WriteDescriptorSet  write{ .dstSet          = m_DescriptorSet,
+                                             .dstBinding      = 5,
+                                             .dstArrayElement = 0,
+                                             .descriptorCount = 1,
+                                             .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+                                             .pImageInfo      = &imageInfo };
+
+        m_Context->GetDevice()->GetHandle().updateDescriptorSets(1, &write, 0, nullptr);
+    }
+
+    void VulkanGpuCulling::Dispatch(vk::CommandBuffer cmdBuffer, u32 pass)
+    {
+        m_Parameters.Pass = pass;
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_Pipeline);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_Layout,
+                                     0,
+                                     1,
+                                     &m_DescriptorSet,
+                                     (u32)m_DynamicOffsets.size(),
+                                     m_DynamicOffsets.data());
+        cmdBuffer.pushConstants(
+            m_Layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(GpuCullingParameters), &m_Parameters);
+
+        const u32 groupCount = (m_Parameters.ObjectCount + GPU_CULLING_WORKGROUP_SIZE - 1) / GPU_CULLING_WORKGROUP_SIZE;
+        cmdBuffer.dispatch(groupCount, 1, 1);
+
+        // Commands and counts get consumed by the indirect draws and the readback copy
+        InsertMemoryBarrier(cmdBuffer,
+                            vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eShaderStorageWrite,
+                            vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eCopy,
+                            vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eTransferRead);
+    }
+}
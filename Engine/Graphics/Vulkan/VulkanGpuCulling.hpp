@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
+#include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanDepthPyramid.hpp"
+#include "Graphics/Vulkan/VulkanDescriptorPool.hpp"
+#include "Graphics/Vulkan/VulkanDescriptorSetLayout.hpp"
+#include "Graphics/Vulkan/VulkanFrameAllocator.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+#include "Graphics/Vulkan/VulkanShader.hpp"
+
+#include "Math/Frustum.hpp"
+
+#include "Vendor/glm/glm.hpp"
+
+#include <array>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Objects visible last frame get drawn early, the depth they leave behind decides which of the others are
+    // occluded and which get drawn late. Without occlusion culling every object ends up in the early phase.
+    enum class CullingPhase : u8
+    {
+        eEarly = 0,
+        eLate  = 1
+    };
+
+    // Index range of one level of detail (std430, mirrored by the culling shader)
+    struct GpuLod
+    {
+        u32 IndexOffset = 0;
+        u32 IndexCount  = 0;
+        f32 Error       = 0.0f;
+        u32 Padding     = 0;
+    };
+
+    // Entry of the scene-wide object buffer (std430, mirrored by the culling shader)
+    struct GpuObject
+    {
+        glm::vec4 Sphere        = glm::vec4(0.0f); // World space bounding sphere (xyz: center, w: radius)
+        u32       FirstIndex    = 0;
+        i32       VertexOffset  = 0;
+        u32       Instance      = 0; // firstInstance of the emitted draw, selects the transform in the instance stream
+        u32       LodCount      = 0;
+        u32       DrawGroup     = 0; // Objects of a group are drawn by the same indirect call
+        u32       CommandOffset = 0; // First command of the draw group, filled in by Cull
+
+        std::array<u32, 2>                       Padding = {};
+        std::array<GpuLod, GPU_CULLING_MAX_LODS> Lods    = {};
+    };
+
+    // Push constants of the culling shader
+    struct GpuCullingParameters
+    {
+        std::array<glm::vec4, Math::Frustum::PLANE_COUNT> FrustumPlanes = {};
+
+        glm::vec4 CameraPosition    = glm::vec4(0.0f); // xyz: position, w: pixels per world unit at distance 1
+        u32       ObjectCount       = 0;               // Filled in by Cull
+        f32       CameraNear        = 0.0f;
+        f32       LodErrorThreshold = 0.0f;
+        u32       Pass              = 0; // Filled in by Cull and CullOccluded
+    };
+
+    static_assert(sizeof(GpuObject) == 112);
+    static_assert(sizeof(GpuCullingParameters) == 128, "Has to fit the guaranteed push constant size");
+
+    // GPU-driven submission: the objects of a frame get written into a storage buffer, a compute pass frustum culls
+    // them, picks their level of detail and compacts the survivors into one indirect command range per draw group.
+    // Every group then gets drawn by a single drawIndexedIndirectCount, no matter how many objects it holds.
+    //
+    // With occlusion culling the pass runs twice. The early one only emits objects which were visible last frame,
+    // once their depth is rendered it gets reduced into a depth pyramid. The late one tests every object against
+    // it, draws the newly visible ones and remembers the result for the next frame. Objects are matched across frames
+    // by the order they were added in, a changing order only costs some overdraw for a frame.
+    class VulkanGpuCulling
+    {
+    public:
+        // The shader modules are only needed during construction
+        VulkanGpuCulling(VulkanContext*        context,
+                         VulkanFrameAllocator* frameAllocator,
+                         const VulkanShader*   cullShader,
+                         const VulkanShader*   pyramidShader);
+        ~VulkanGpuCulling();
+
+        VulkanGpuCulling(const VulkanGpuCulling&)            = delete;
+        VulkanGpuCulling& operator=(const VulkanGpuCulling&) = delete;
+
+        // Clears the objects and reads back the visible count the slot recorded the last time, so only call it after
+        // waiting for the frame slot's fence
+        void BeginFrame(u32 frameIndex);
+
+        void AddObject(const GpuObject& object);
+
+        // Writes the objects into the frame allocator and records the (early) culling pass, has to be recorded outside
+        // of rendering. Indirect reads of the draw groups are synchronized with it afterwards. Occlusion culling needs
+        // a CullOccluded call after the early draws wrote their depth.
+        void Cull(vk::CommandBuffer cmdBuffer, GpuCullingParameters parameters, u32 globalsOffset, b8 occlusion);
+
+        // Builds the depth pyramid from the depth image and records the late culling pass, has to be recorded outside
+        // of rendering with the depth image ready for depth testing
+        void CullOccluded(vk::CommandBuffer cmdBuffer);
+
+        // Draws the survivors of a group and phase, pipeline, vertex and matching index buffer have to be bound
+        void Draw(vk::CommandBuffer cmdBuffer, u32 drawGroup, CullingPhase phase) const;
+
+        // Records the copy of the visible counts for BeginFrame, has to be recorded outside of rendering
+        void CopyVisibleCounts(vk::CommandBuffer cmdBuffer);
+
+        [[nodiscard]] u32 GetObjectCount() const { return (u32)m_Objects.size(); }
+        [[nodiscard]] u32 GetObjectCount(u32 drawGroup) const { return m_GroupObjectCounts.at(drawGroup); }
+
+        // Results of the frame which last used the current slot, FRAMES_IN_FLIGHT frames old
+        [[nodiscard]] u32 GetVisibleCount() const { return m_VisibleCount; }
+        [[nodiscard]] u32 GetOccludedCount() const { return m_OccludedCount; }
+
+    private:
+        void CreateBuffers();
+        void CreateDescriptors(const ShaderReflection& reflection);
+        void CreatePipeline(const VulkanShader* cullShader, const ShaderReflection& reflection);
+        void WriteDepthPyramidDescriptor();
+        void Dispatch(vk::CommandBuffer cmdBuffer, u32 pass);
+
+        VulkanContext*        m_Context        = nullptr;
+        VulkanFrameAllocator* m_FrameAllocator = nullptr;
+
+        // Compaction targets and visibility of the last occlusion test (GPU only), per-frame copies of the counts
+        // (mapped)
+        BufferAllocation m_CommandBufferAlloc    = {};
+        BufferAllocation m_CountBufferAlloc      = {};
+        BufferAllocation m_VisibilityBufferAlloc = {};
+        BufferAllocation m_ReadbackBufferAlloc   = {};
+        const u32*       m_ReadbackData          = nullptr;
+        b8               m_VisibilityCleared     = false;
+
+        Scope<VulkanDepthPyramid> m_DepthPyramid;
+
+        Scope<VulkanDescriptorPool>      m_DescriptorPool;
+        const VulkanDescriptorSetLayout* m_DescriptorLayout = nullptr; // Owned by the layout cache
+        vk::DescriptorSet                m_DescriptorSet;
+
+        vk::PipelineLayout m_Layout   = nullptr; // Owned by the layout cache
+        vk::Pipeline       m_Pipeline = nullptr;
+
+        // Objects of the current frame, the late pass reuses the parameters and offsets of the early one
+        std::vector<GpuObject>                   m_Objects;
+        std::array<u32, GPU_CULLING_DRAW_GROUPS> m_GroupObjectCounts = {};
+        std::array<u32, GPU_CULLING_DRAW_GROUPS> m_GroupOffsets      = {};
+        GpuCullingParameters                     m_Parameters        = {};
+        std::array<u32, 2>                       m_DynamicOffsets    = {}; // Objects and global uniforms
+        b8                                       m_Occlusion         = false;
+
+        std::array<b8, FRAMES_IN_FLIGHT> m_ReadbackPending = {};
+        u32                              m_FrameIndex      = 0;
+        u32                              m_VisibleCount    = 0;
+        u32                              m_OccludedCount   = 0;
+    };
+}
@@ -0,0 +1,344 @@
+#include "VulkanGpuProfiler.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    // Begin and end of the frame range plus a pair for every scope
+    constexpr u32 QUERY_COUNT = 2 * (1 + Graphics::GPU_PROFILER_MAX_SCOPES);
+
+    constexpr u32 FRAME_QUERY = 0;
+
+    u32 GetScopeQuery(u32 scope)
+    {
+        return 2 * (1 + scope);
+    }
+
+    // Get written in the order of their bits, followed by the availability
+    constexpr vk::QueryPipelineStatisticFlags STATISTICS_FLAGS =
+        vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices
+        | vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives
+        | vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations
+        | vk::QueryPipelineStatisticFlagBits::eClippingInvocations
+        | vk::QueryPipelineStatisticFlagBits::eClippingPrimitives
+        | vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+    constexpr u32 STATISTICS_STRIDE = 7; // Values per query
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanGpuProfiler::VulkanGpuProfiler(const VulkanDevice* device) : m_Device(device)
+    {
+        const VulkanPhysicalDevice* physicalDevice = m_Device->GetPhysicalDevice();
+        const f32                   period         = physicalDevice->GetProperties().limits.timestampPeriod;
+        const u32                   validBits      = physicalDevice->GetHandle()
+                                      .getQueueFamilyProperties()
+                                      .at(m_Device->GetGraphicsQueueFamily())
+                                      .timestampValidBits;
+
+        m_StatisticsSupported = physicalDevice->GetFeatures().pipelineStatisticsQuery;
+
+        if (validBits == 0 || period <= 0.0f)
+        {
+            LOG_WARN("Graphics queue doesn't support timestamps, GPU timings stay empty ...");
+            return;
+        }
+
+        m_NanosecondsPerTick = period;
+        m_TimestampMask      = validBits >= 64 ? std::numeric_limits<u64>::max() : (1ull << validBits) - 1;
+
+        const vk::QueryPoolCreateInfo poolInfo{ .queryType = vk::QueryType::eTimestamp, .queryCount = QUERY_COUNT };
+        for (vk::QueryPool& pool : m_QueryPools)
+        {
+            VK_VERIFY(m_Device->GetHandle().createQueryPool(&poolInfo, nullptr, &pool));
+        }
+
+        LOG_INFO("Created GPU profiler ... (Timestamp period: {} ns, Valid bits: {}, Pipeline statistics: {})",
+                 period,
+                 validBits,
+                 m_StatisticsSupported ? "supported" : "unsupported");
+    }
+
+    VulkanGpuProfiler::~VulkanGpuProfiler()
+    {
+        LOG_INFO("VulkanGpuProfiler::Destructor() ...");
+
+        for (const vk::QueryPool pool : m_QueryPools)
+        {
+            m_Device->GetHandle().destroyQueryPool(pool);
+        }
+
+        for (const vk::QueryPool pool : m_StatisticsPools)
+        {
+            m_Device->GetHandle().destroyQueryPool(pool);
+        }
+    }
+
+    void VulkanGpuProfiler::BeginFrame(u32 frameIndex)
+    {
+        ASSERT(frameIndex < FRAMES_IN_FLIGHT, "Given frame index surpasses FRAMES_IN_FLIGHT!");
+        m_FrameIndex = frameIndex;
+
+        // The fence of this slot signaled, so its timestamps got written
+        if (m_ReadbackPending.at(m_FrameIndex))
+        {
+            ReadTimings();
+            m_ReadbackPending.at(m_FrameIndex) = false;
+        }
+
+        // Statistics recorded before they got disabled are dropped
+        if (m_StatisticsEnabled && !m_StatisticsNames.at(m_FrameIndex).empty())
+        {
+            ReadStatistics();
+        }
+
+        m_ScopeNames.at(m_FrameIndex).clear();
+        m_StatisticsNames.at(m_FrameIndex).clear();
+    }
+
+    void VulkanGpuProfiler::BeginRecording(vk::CommandBuffer cmdBuffer)
+    {
+        if (m_StatisticsEnabled)
+        {
+            cmdBuffer.resetQueryPool(m_StatisticsPools.at(m_FrameIndex), 0, GPU_PROFILER_MAX_STATISTICS);
+        }
+
+        if (IsSupported())
+        {
+            cmdBuffer.resetQueryPool(m_QueryPools.at(m_FrameIndex), 0, QUERY_COUNT);
+            WriteTimestamp(cmdBuffer, FRAME_QUERY);
+        }
+    }
+
+    void VulkanGpuProfiler::EndRecording(vk::CommandBuffer cmdBuffer)
+    {
+        if (!IsSupported())
+        {
+            return;
+        }
+
+        WriteTimestamp(cmdBuffer, FRAME_QUERY + 1);
+        m_ReadbackPending.at(m_FrameIndex) = true;
+    }
+
+    GpuScope VulkanGpuProfiler::CreateScope(std::string_view name)
+    {
+        if (!IsSupported())
+        {
+            return {};
+        }
+
+        std::vector<std::string>& names = m_ScopeNames.at(m_FrameIndex);
+        ASSERT(names.size() < GPU_PROFILER_MAX_SCOPES,
+               "GPU profiler can't take more than {} scopes per frame!",
+               GPU_PROFILER_MAX_SCOPES);
+
+        names.emplace_back(name);
+        return { .Index = (u32)names.size() - 1 };
+    }
+
+    void VulkanGpuProfiler::Begin(vk::CommandBuffer cmdBuffer, GpuScope scope) const
+    {
+        if (scope.IsValid())
+        {
+            WriteTimestamp(cmdBuffer, GetScopeQuery(scope.Index));
+        }
+    }
+
+    void VulkanGpuProfiler::End(vk::CommandBuffer cmdBuffer, GpuScope scope) const
+    {
+        if (scope.IsValid())
+        {
+            WriteTimestamp(cmdBuffer, GetScopeQuery(scope.Index) + 1);
+        }
+    }
+
+    void VulkanGpuProfiler::SetPipelineStatisticsEnabled(b8 enabled)
+    {
+        enabled = enabled && m_StatisticsSupported;
+        if (enabled == m_StatisticsEnabled)
+        {
+            return;
+        }
+
+        if (enabled && !m_StatisticsPools.front())
+        {
+            CreateStatisticsPools();
+        }
+
+        if (!enabled)
+        {
+            m_Statistics.clear();
+        }
+
+        m_StatisticsEnabled = enabled;
+        LOG_INFO("{} pipeline statistics ...", enabled ? "Enabled" : "Disabled");
+    }
+
+    GpuScope VulkanGpuProfiler::CreateStatisticsScope(std::string_view name)
+    {
+        if (!m_StatisticsEnabled)
+        {
+            return {};
+        }
+
+        std::vector<std::string>& names = m_StatisticsNames.at(m_FrameIndex);
+        ASSERT(names.size() < GPU_PROFILER_MAX_STATISTICS,
+               "GPU profiler can't take more than {} pipeline statistics per frame!",
+               GPU_PROFILER_MAX_STATISTICS);
+
+        names.emplace_back(name);
+        return { .Index = (u32)names.size() - 1 };
+    }
+
+    void VulkanGpuProfiler::BeginStatistics(vk::CommandBuffer cmdBuffer, GpuScope scope) const
+    {
+        if (scope.IsValid())
+        {
+            cmdBuffer.beginQuery(m_StatisticsPools.at(m_FrameIndex), scope.Index, {});
+        }
+    }
+
+    void VulkanGpuProfiler::EndStatistics(vk::CommandBuffer cmdBuffer, GpuScope scope) const
+    {
+        if (scope.IsValid())
+        {
+            cmdBuffer.endQuery(m_StatisticsPools.at(m_FrameIndex), scope.Index);
+        }
+    }
+
+    // ----- Private -----
+
+    void VulkanGpuProfiler::CreateStatisticsPools()
+    {
+        const vk::QueryPoolCreateInfo poolInfo{ .queryType          = vk::QueryType::ePipelineStatistics,
+                                                .queryCount         = GPU_PROFILER_MAX_STATISTICS,
+                                                .pipelineStatistics = STATISTICS_FLAGS };
+        for (vk::QueryPool& pool : m_StatisticsPools)
+        {
+            VK_VERIFY(m_Device->GetHandle().createQueryPool(&poolInfo, nullptr, &pool));
+        }
+
+        m_StatisticsResults.resize(GPU_PROFILER_MAX_STATISTICS * STATISTICS_STRIDE);
+    }
+
+    void VulkanGpuProfiler::ReadTimings()
+    {
+        const std::vector<std::string>& names      = m_ScopeNames.at(m_FrameIndex);
+        const u32                       queryCount = GetScopeQuery((u32)names.size());
+
+        // Every timestamp is followed by its availability, scopes whose pass got skipped never became available
+        std::array<u64, 2 * QUERY_COUNT> results = {};
+        const vk::Result                 result  = m_Device->GetHandle().getQueryPoolResults(
+            m_QueryPools.at(m_FrameIndex),
+            0,
+            queryCount,
+            queryCount * 2 * sizeof(u64),
+            results.data(),
+            2 * sizeof(u64),
+            vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+
+        if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+        {
+            LOG_WARN("Reading GPU timestamps failed ... ({})", vk::to_string(result));
+            return;
+        }
+
+        const auto elapsedMilliseconds = [&](u32 beginQuery) -> std::optional<f64>
+        {
+            if (results.at(2 * beginQuery + 1) == 0 || results.at(2 * beginQuery + 3) == 0)
+            {
+                return std::nullopt;
+            }
+
+            // Counters may wrap around within their valid bits
+            const u64 ticks = (results.at(2 * beginQuery + 2) - results.at(2 * beginQuery)) & m_TimestampMask;
+            return (f64)ticks * m_NanosecondsPerTick / 1'000'000.0;
+        };
+
+        m_Timings.Passes.clear();
+        m_Timings.FrameMilliseconds = elapsedMilliseconds(FRAME_QUERY).value_or(0.0);
+
+        for (u32 scope = 0; scope < (u32)names.size(); scope++)
+        {
+            const std::optional<f64> milliseconds = elapsedMilliseconds(GetScopeQuery(scope));
+            if (!milliseconds.has_value())
+            {
+                continue;
+            }
+
+            auto pass = std::ranges::find(m_Timings.Passes, names[scope], &GpuPassTiming::Name);
+            if (pass == m_Timings.Passes.end())
+            {
+                m_Timings.Passes.push_back({ .Name = names[scope], .Milliseconds = 0.0 });
+                pass = std::prev(m_Timings.Passes.end());
+            }
+
+            pass->Milliseconds += *milliseconds;
+        }
+    }
+
+    void VulkanGpuProfiler::ReadStatistics()
+    {
+        const std::vector<std::string>& names = m_StatisticsNames.at(m_FrameIndex);
+
+        const vk::Result result = m_Device->GetHandle().getQueryPoolResults(
+            m_StatisticsPools.at(m_FrameIndex),
+            0,
+            (u32)names.size(),
+            names.size() * STATISTICS_STRIDE * sizeof(u64),
+            m_StatisticsResults.data(),
+            STATISTICS_STRIDE * sizeof(u64),
+            vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+
+        if (result != vk::Result::eSuccess && result != vk::Result::eNotReady)
+        {
+            LOG_WARN("Reading pipeline statistics failed ... ({})", vk::to_string(result));
+            return;
+        }
+
+        m_Statistics.clear();
+
+        for (u32 query = 0; query < (u32)names.size(); query++)
+        {
+            const u64* values = m_StatisticsResults.data() + (query * STATISTICS_STRIDE);
+            if (values[STATISTICS_STRIDE - 1] == 0)
+            {
+                continue;
+            }
+
+            auto pass = std::ranges::find(m_Statistics, names[query], &GpuPassStatistics::Name);
+            if (pass == m_Statistics.end())
+            {
+                m_Statistics.push_back({ .Name = names[query] });
+                pass = std::prev(m_Statistics.end());
+            }
+
+            pass->InputVertices       += values[0];
+            pass->InputPrimitives     += values[1];
+            pass->VertexInvocations   += values[2];
+            pass->ClippingInvocations += values[3];
+            pass->ClippingPrimitives  += values[4];
+            pass->FragmentInvocations += values[5];
+        }
+    }
+
+    void VulkanGpuProfiler::WriteTimestamp(vk::CommandBuffer cmdBuffer, u32 query) const
+    {
+        // Waiting for all earlier commands keeps overlapping passes from blurring into each other
+        cmdBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, m_QueryPools.at(m_FrameIndex), query);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanDevice.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+#include "Graphics/Vulkan/VulkanRendererStructs.hpp"
+
+#include <array>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Queries of a scope in the current frame, invalid without support (or enabled statistics) and ignored then
+    struct GpuScope
+    {
+        u32 Index = std::numeric_limits<u32>::max();
+
+        [[nodiscard]] bool IsValid() const { return Index != std::numeric_limits<u32>::max(); }
+    };
+
+    // Measures how long the GPU spends on named parts of a frame with timestamp queries. Every frame slot has a query
+    // pool of its own, which only gets read after the slot's fence signaled, so the results never stall the CPU but
+    // are FRAMES_IN_FLIGHT frames old.
+    //
+    // Pipeline statistics count the vertices, primitives and shader invocations of a pass. They're off by default and
+    // cost nothing then, their query pools only get created once they're enabled for the first time.
+    class VulkanGpuProfiler
+    {
+    public:
+        explicit VulkanGpuProfiler(const VulkanDevice* device);
+        ~VulkanGpuProfiler();
+
+        VulkanGpuProfiler(const VulkanGpuProfiler&)            = delete;
+        VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+
+        // Reads the timestamps the slot recorded the last time, so only call it after waiting for the frame slot's
+        // fence
+        void BeginFrame(u32 frameIndex);
+
+        // Reset the slot's queries and bracket the whole frame, have to be the first and last commands recorded into
+        // the primary command buffer
+        void BeginRecording(vk::CommandBuffer cmdBuffer);
+        void EndRecording(vk::CommandBuffer cmdBuffer);
+
+        // Reserves the queries of a scope for the current frame, main thread only. The name gets copied.
+        [[nodiscard]] GpuScope CreateScope(std::string_view name);
+
+        // Can be recorded into any command buffer of the frame, also by workers, as long as the begin gets executed
+        // before the end. Both are allowed inside of rendering.
+        void Begin(vk::CommandBuffer cmdBuffer, GpuScope scope) const;
+        void End(vk::CommandBuffer cmdBuffer, GpuScope scope) const;
+
+        // Ignored without device support, only call it before BeginRecording
+        void SetPipelineStatisticsEnabled(b8 enabled);
+
+        // Reserves a pipeline statistics query for the current frame, main thread only. Statistics of the same name
+        // add up, so a pass split across several command buffers can take one per buffer.
+        [[nodiscard]] GpuScope CreateStatisticsScope(std::string_view name);
+
+        // Have to be recorded into the same command buffer, inside of the same rendering scope if within one
+        void BeginStatistics(vk::CommandBuffer cmdBuffer, GpuScope scope) const;
+        void EndStatistics(vk::CommandBuffer cmdBuffer, GpuScope scope) const;
+
+        [[nodiscard]] b8                IsSupported() const { return m_TimestampMask != 0; }
+        [[nodiscard]] b8                IsPipelineStatisticsSupported() const { return m_StatisticsSupported; }
+        [[nodiscard]] const GpuTimings& GetTimings() const { return m_Timings; }
+
+        // Empty while pipeline statistics are disabled
+        [[nodiscard]] const std::vector<GpuPassStatistics>& GetPipelineStatistics() const { return m_Statistics; }
+
+    private:
+        void CreateStatisticsPools();
+        void ReadTimings();
+        void ReadStatistics();
+        void WriteTimestamp(vk::CommandBuffer cmdBuffer, u32 query) const;
+
+        const VulkanDevice* m_Device = nullptr;
+
+        f64 m_NanosecondsPerTick = 0.0;
+        u64 m_TimestampMask      = 0; // Valid bits of the graphics queue's timestamps, zero without support
+
+        // Scope names recorded by every slot, the frame range takes the first two queries
+        std::array<vk::QueryPool, FRAMES_IN_FLIGHT>            m_QueryPools = {};
+        std::array<std::vector<std::string>, FRAMES_IN_FLIGHT> m_ScopeNames;
+        std::array<b8, FRAMES_IN_FLIGHT>                       m_ReadbackPending = {};
+        u32                                                    m_FrameIndex      = 0;
+
+        GpuTimings m_Timings;
+
+        // Pipeline statistics, the pools only exist once they got enabled
+        std::array<vk::QueryPool, FRAMES_IN_FLIGHT>            m_StatisticsPools = {};
+        std::array<std::vector<std::string>, FRAMES_IN_FLIGHT> m_StatisticsNames;
+        std::vector<u64>                                       m_StatisticsResults;
+        std::vector<GpuPassStatistics>                         m_Statistics;
+        b8                                                     m_StatisticsSupported = false;
+        b8                                                     m_StatisticsEnabled   = false;
+    };
+}
@@ -0,0 +1,140 @@
+#include "VulkanLayoutCache.hpp"
+
+#include "Core/Hash.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    u64 HashSetLayout(const Graphics::DescriptorSetLayoutSpecification& spec)
+    {
+        u64 hash = Core::HashBytes(&spec.Flags, sizeof(spec.Flags));
+
+        for (const vk::DescriptorSetLayoutBinding& binding : spec.Bindings)
+        {
+            const std::array<u32, 4> fields = { binding.binding,
+                                                (u32)binding.descriptorType,
+                                                binding.descriptorCount,
+                                                (u32)(VkShaderStageFlags)binding.stageFlags };
+            hash = Core::HashBytes(fields.data(), sizeof(fields), hash);
+        }
+
+        return hash;
+    }
+
+    u64 HashPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts,
+                           std::span<const vk::PushConstantRange>   pushConstantRanges)
+    {
+        u64 hash = Core::HashBytes(setLayouts.data(), setLayouts.size_bytes(), setLayouts.size());
+
+        for (const vk::PushConstantRange& range : pushConstantRanges)
+        {
+            const std::array<u32, 3> fields = { (u32)(VkShaderStageFlags)range.stageFlags, range.offset, range.size };
+            hash = Core::HashBytes(fields.data(), sizeof(fields), hash);
+        }
+
+        return hash;
+    }
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanLayoutCache::VulkanLayoutCache(const VulkanDevice* device) : m_Device(device)
+    {
+    }
+
+    VulkanLayoutCache::~VulkanLayoutCache()
+    {
+        LOG_INFO("VulkanLayoutCache::Destructor() ... ({} set layouts, {} pipeline layouts)",
+                 m_SetLayouts.size(),
+                 m_PipelineLayouts.size());
+
+        for (const PipelineLayoutEntry& entry : m_PipelineLayouts)
+        {
+            m_Device->GetHandle().destroyPipelineLayout(entry.Layout);
+        }
+    }
+
+    const VulkanDescriptorSetLayout* VulkanLayoutCache::GetDescriptorSetLayout(DescriptorSetLayoutSpecification spec)
+    {
+        ASSERT(std::ranges::none_of(spec.Bindings, [](const auto& binding) { return binding.pImmutableSamplers; }),
+               "Immutable samplers can't be cached!");
+
+        // Binding order doesn't change the layout
+        std::ranges::sort(spec.Bindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+
+        const auto [index, inserted] = m_SetLayoutIndices.FindOrInsert(HashSetLayout(spec), (u32)m_SetLayouts.size());
+        if (!inserted)
+        {
+            const SetLayoutEntry& entry = m_SetLayouts[index];
+            ASSERT(entry.Spec.Flags == spec.Flags && entry.Spec.Bindings == spec.Bindings,
+                   "Descriptor set layout hash collision!");
+
+            return entry.Layout.get();
+        }
+
+        auto layout = MakeScope<VulkanDescriptorSetLayout>(m_Device->GetHandle(), spec);
+        m_SetLayouts.push_back({ .Spec = std::move(spec), .Layout = std::move(layout) });
+
+        return m_SetLayouts.back().Layout.get();
+    }
+
+    vk::PipelineLayout VulkanLayoutCache::GetPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts,
+                                                            std::span<const vk::PushConstantRange>   pushConstantRanges)
+    {
+        const auto [index, inserted] = m_PipelineLayoutIndices.FindOrInsert(
+            HashPipelineLayout(setLayouts, pushConstantRanges), (u32)m_PipelineLayouts.size());
+
+        if (!inserted)
+        {
+            const PipelineLayoutEntry& entry = m_PipelineLayouts[index];
+            ASSERT(std::ranges::equal(entry.SetLayouts, setLayouts)
+                       && std::ranges::equal(entry.PushConstantRanges, pushConstantRanges),
+                   "Pipeline layout hash collision!");
+
+            return entry.Layout;
+        }
+
+        const vk::PipelineLayoutCreateInfo layoutInfo{ .setLayoutCount         = (u32)setLayouts.size(),
+                                                       .pSetLayouts            = setLayouts.data(),
+                                                       .pushConstantRangeCount = (u32)pushConstantRanges.size(),
+                                                       .pPushConstantRanges    = pushConstantRanges.data() };
+
+        vk::PipelineLayout layout = nullptr;
+        VK_VERIFY(m_Device->GetHandle().createPipelineLayout(&layoutInfo, nullptr, &layout));
+
+        m_PipelineLayouts.push_back({ .SetLayouts         = { setLayouts.begin(), setLayouts.end() },
+                                      .PushConstantRanges = { pushConstantRanges.begin(), pushConstantRanges.end() },
+                                      .Layout             = layout });
+
+        LOG_INFO("Created pipeline layout ... (Sets: {}, Push constant ranges: {})",
+                 setLayouts.size(),
+                 pushConstantRanges.size());
+
+        return layout;
+    }
+
+    vk::PipelineLayout VulkanLayoutCache::GetPipelineLayout(const ShaderReflection& reflection)
+    {
+        std::vector<vk::DescriptorSetLayout> setLayouts;
+        setLayouts.reserve(reflection.Sets.size());
+
+        for (const std::vector<vk::DescriptorSetLayoutBinding>& bindings : reflection.Sets)
+        {
+            setLayouts.push_back(GetDescriptorSetLayout({ .Flags = {}, .Bindings = bindings })->GetHandle());
+        }
+
+        return GetPipelineLayout(setLayouts, reflection.PushConstantRanges);
+    }
+}
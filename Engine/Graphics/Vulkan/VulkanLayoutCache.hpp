@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Core/FlatHashMap.hpp"
+#include "Core/Memory.hpp"
+
+#include "Graphics/Resources/ShaderReflection.hpp"
+
+#include "Graphics/Vulkan/VulkanDescriptorSetLayout.hpp"
+#include "Graphics/Vulkan/VulkanDevice.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Deduplicates descriptor set and pipeline layouts by their contents. Equal specifications return the same
+    // handle, so pipelines built from the same shader interface share layouts and descriptor sets stay bound when
+    // switching between them. Layouts live as long as the cache, which is only meant for the main thread.
+    class VulkanLayoutCache
+    {
+    public:
+        explicit VulkanLayoutCache(const VulkanDevice* device);
+        ~VulkanLayoutCache();
+
+        VulkanLayoutCache(const VulkanLayoutCache&)            = delete;
+        VulkanLayoutCache& operator=(const VulkanLayoutCache&) = delete;
+
+        [[nodiscard]] const VulkanDescriptorSetLayout* GetDescriptorSetLayout(DescriptorSetLayoutSpecification spec);
+
+        [[nodiscard]] vk::PipelineLayout GetPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts,
+                                                           std::span<const vk::PushConstantRange>   pushConstantRanges);
+
+        // Set layouts for every set of the interface (gaps get empty sets) and the pipeline layout using them
+        [[nodiscard]] vk::PipelineLayout GetPipelineLayout(const ShaderReflection& reflection);
+
+        [[nodiscard]] u32 GetDescriptorSetLayoutCount() const { return (u32)m_SetLayouts.size(); }
+        [[nodiscard]] u32 GetPipelineLayoutCount() const { return (u32)m_PipelineLayouts.size(); }
+
+    private:
+        struct SetLayoutEntry
+        {
+            DescriptorSetLayoutSpecification Spec;
+            Scope<VulkanDescriptorSetLayout> Layout;
+        };
+
+        struct PipelineLayoutEntry
+        {
+            std::vector<vk::DescriptorSetLayout> SetLayouts;
+            std::vector<vk::PushConstantRange>   PushConstantRanges;
+            vk::PipelineLayout                   Layout = nullptr;
+        };
+
+        const VulkanDevice* m_Device = nullptr;
+
+        // Content hash to entry index, the entries keep their contents to tell hash collisions apart
+        Core::FlatHashMap<u64, u32>      m_SetLayoutIndices;
+        Core::FlatHashMap<u64, u32>      m_PipelineLayoutIndices;
+        std::vector<SetLayoutEntry>      m_SetLayouts;
+        std::vector<PipelineLayoutEntry> m_PipelineLayouts;
+    };
+}
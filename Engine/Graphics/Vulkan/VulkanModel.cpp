@@ -1,98 +1,62 @@
 #include "VulkanModel.hpp"
 
+#include "Core/Utility.hpp"
+
 #include "Debug/Log.hpp"
 
 namespace Engine::Graphics
 {
     // ----- Public -----
 
-    VulkanModel::VulkanModel(VulkanContext* context, const Mesh* mesh) : m_Context(context), m_Mesh(mesh)
+    VulkanModel::VulkanModel(VulkanGeometryArena* arena, const MeshView& mesh, VertexFormat format)
+        : m_Arena(arena), m_VerticeCount(mesh.Vertices.size()), m_IndexCount(mesh.GetIndexCount()),
+          m_IndexFormat(Graphics::GetIndexFormat(mesh.Vertices.size())), m_VertexFormat(format),
+          m_Lods(mesh.Lods.begin(), mesh.Lods.end()), m_Bounds(mesh.ComputeBounds())
     {
-        CreateVertexBuffer();
-        CreateIndexBuffer();
+        if (m_Lods.empty())
+        {
+            m_Lods.push_back({ .IndexOffset = 0, .IndexCount = m_IndexCount, .Error = 0.0f });
+        }
+
+        // Mesh data only needs to live until it's uploaded
+        Upload(mesh);
     }
 
     VulkanModel::~VulkanModel()
     {
         LOG_INFO("VulkanModel::Destructor() ...");
-        VulkanAllocator::DestroyBuffer(m_VertexBufferAlloc);
-        VulkanAllocator::DestroyBuffer(m_IndexBufferAlloc);
-    }
-
-    void VulkanModel::Bind(vk::CommandBuffer commandBuffer) const
-    {
-        const vk::DeviceSize offset = 0;
-        commandBuffer.bindVertexBuffers(0, 1, &m_VertexBufferAlloc.Buffer, &offset);
-        commandBuffer.bindIndexBuffer(m_IndexBufferAlloc.Buffer, 0, vk::IndexType::eUint32);
+        m_Arena->Free(m_Geometry);
     }
 
     // ----- Private -----
 
-    void VulkanModel::CreateVertexBuffer()
-    {
-        ASSERT(!m_Mesh->Vertices.empty(), "Model has no vertex data!");
-
-        // Create vertex buffer
-        const BufferSpecification vboSpec{ .Size             = m_Mesh->GetVerticeSize(),
-                                           .BufferUsageFlags = vk::BufferUsageFlagBits::eVertexBuffer
-                                                               | vk::BufferUsageFlagBits::eTransferDst,
-                                           .MemoryUsage      = MemoryUsage::eGPUOnly,
-                                           .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal };
-        m_VertexBufferAlloc = VulkanAllocator::AllocateBuffer(vboSpec);
-
-        // Create staging buffer
-        const BufferSpecification stagingSpec{ .Size             = m_Mesh->GetVerticeSize(),
-                                               .BufferUsageFlags = vk::BufferUsageFlagBits::eTransferSrc,
-                                               .MemoryUsage      = MemoryUsage::eCPUOnly,
-                                               .MemoryFlags      = vk::MemoryPropertyFlagBits::eHostVisible
-                                                                   | vk::MemoryPropertyFlagBits::eHostCoherent };
-        const BufferAllocation    stagingBufferAlloc = VulkanAllocator::AllocateBuffer(stagingSpec);
-
-        // Fill out staging buffer
-        void* dataPtr = VulkanAllocator::MapMemory(stagingBufferAlloc.Allocation);
-        std::memcpy(dataPtr, m_Mesh->Vertices.data(), m_Mesh->GetVerticeSize());
-        VulkanAllocator::UnmapMemory(stagingBufferAlloc.Allocation);
-
-        // Transfer data from CPU to GPU
-        m_Context->CopyBuffer(stagingBufferAlloc.Buffer, m_VertexBufferAlloc.Buffer, m_Mesh->GetVerticeSize());
-
-        // Destroy staging buffer
-        VulkanAllocator::DestroyBuffer(stagingBufferAlloc);
-
-        LOG_INFO("Created and uploaded vertex buffer ...");
-    }
-
-    void VulkanModel::CreateIndexBuffer()
+    void VulkanModel::Upload(const MeshView& mesh)
     {
-        ASSERT(!m_Mesh->Indices.empty(), "Model has no index data!");
-
-        // Create index buffer
-        const BufferSpecification iboSpec{ .Size             = m_Mesh->GetIndiceSize(),
-                                           .BufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer
-                                                               | vk::BufferUsageFlagBits::eTransferDst,
-                                           .MemoryUsage      = MemoryUsage::eGPUOnly,
-                                           .MemoryFlags      = vk::MemoryPropertyFlagBits::eDeviceLocal };
-        m_IndexBufferAlloc = VulkanAllocator::AllocateBuffer(iboSpec);
-
-        // Create staging buffer
-        const BufferSpecification stagingSpec{ .Size             = m_Mesh->GetIndiceSize(),
-                                               .BufferUsageFlags = vk::BufferUsageFlagBits::eTransferSrc,
-                                               .MemoryUsage      = MemoryUsage::eCPUOnly,
-                                               .MemoryFlags      = vk::MemoryPropertyFlagBits::eHostVisible
-                                                                   | vk::MemoryPropertyFlagBits::eHostCoherent };
-        const BufferAllocation    stagingBufferAlloc = VulkanAllocator::AllocateBuffer(stagingSpec);
-
-        // Fill out staging buffer
-        void* dataPtr = VulkanAllocator::MapMemory(stagingBufferAlloc.Allocation);
-        std::memcpy(dataPtr, m_Mesh->Indices.data(), m_Mesh->GetIndiceSize());
-        VulkanAllocator::UnmapMemory(stagingBufferAlloc.Allocation);
-
-        // Transfer data from CPU to GPU
-        m_Context->CopyBuffer(stagingBufferAlloc.Buffer, m_IndexBufferAlloc.Buffer, m_Mesh->GetIndiceSize());
-
-        // Destroy staging buffer
-        VulkanAllocator::DestroyBuffer(stagingBufferAlloc);
-
-        LOG_INFO("Created and uploaded index buffer ...");
+        ASSERT(!mesh.Vertices.empty(), "Model has no vertex data!");
+        ASSERT(!mesh.Indices.empty(), "Model has no index data!");
+        ASSERT(mesh.IndexEncoding == m_IndexFormat || mesh.IndexEncoding == IndexFormat::eUint32,
+               "16-bit indices can't address all vertices of the model!");
+
+        // Convert into the vertex layout of the model
+        const EncodedVertices encoded = EncodeVertices(m_VertexFormat, mesh.Vertices);
+        m_Dequantization              = encoded.Dequantization;
+
+        // Narrow 32-bit indices if the vertex count allows it, cached meshes already come with 16-bit indices
+        std::vector<u16>    narrowed;
+        std::span<const u8> indices = mesh.Indices;
+
+        if (mesh.IndexEncoding != m_IndexFormat)
+        {
+            narrowed = NarrowIndices({ (const u32*)mesh.Indices.data(), mesh.GetIndexCount() });
+            indices  = { (const u8*)narrowed.data(), narrowed.size() * sizeof(u16) };
+        }
+
+        m_Geometry = m_Arena->Upload(encoded.Data, encoded.Stride, indices, m_IndexFormat);
+
+        LOG_INFO("Uploaded model ... (Vertex format: {}, Index format: {}, LODs: {}, Size: {})",
+                 VertexFormatToString(m_VertexFormat),
+                 IndexFormatToString(m_IndexFormat),
+                 m_Lods.size(),
+                 Core::Utility::BytesToString(encoded.Data.size() + indices.size()));
     }
 }
@@ -1,39 +1,55 @@
 #pragma once
 
 #include "Graphics/Resources/Mesh.hpp"
+#include "Graphics/Resources/VertexLayout.hpp"
 
-#include "Graphics/Vulkan/VulkanAllocator.hpp"
-#include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanGeometryArena.hpp"
+#include "Graphics/Vulkan/VulkanRendererStructs.hpp"
+
+#include <vector>
 
 namespace Engine::Graphics
 {
     class VulkanModel
     {
     public:
-        VulkanModel(VulkanContext* context, const Mesh* mesh);
+        VulkanModel(VulkanGeometryArena* arena, const MeshView& mesh, VertexFormat format);
         ~VulkanModel();
 
         VulkanModel(const VulkanModel&)            = delete;
         VulkanModel& operator=(const VulkanModel&) = delete;
 
-        void Bind(vk::CommandBuffer commandBuffer) const;
-
-        [[nodiscard]] vk::Buffer GetVertexBuffer() const { return m_VertexBufferAlloc.Buffer; };
-        [[nodiscard]] vk::Buffer GetIndexBuffer() const { return m_IndexBufferAlloc.Buffer; };
-        [[nodiscard]] u32        GetVerticeCount() const { return m_Mesh->Vertices.size(); };
-        [[nodiscard]] u32        GetIndexCount() const { return m_Mesh->Indices.size(); };
-        [[nodiscard]] u32        GetPipelineID() const { return m_PipelineID; };
+        [[nodiscard]] i32                         GetVertexOffset() const { return m_Geometry.VertexOffset; };
+        [[nodiscard]] u32                         GetFirstIndex() const { return m_Geometry.FirstIndex; };
+        [[nodiscard]] u32                         GetVerticeCount() const { return m_VerticeCount; };
+        [[nodiscard]] u32                         GetIndexCount() const { return m_IndexCount; };
+        [[nodiscard]] IndexFormat                 GetIndexFormat() const { return m_IndexFormat; };
+        [[nodiscard]] PipelineHandle              GetPipeline() const { return m_Pipeline; };
+        [[nodiscard]] VertexFormat                GetVertexFormat() const { return m_VertexFormat; };
+        [[nodiscard]] const VertexDequantization& GetDequantization() const { return m_Dequantization; };
+        [[nodiscard]] const std::vector<MeshLod>& GetLods() const { return m_Lods; };
+        [[nodiscard]] const MeshBounds&           GetBounds() const { return m_Bounds; };
+        [[nodiscard]] UploadTicket                GetUploadTicket() const { return m_Geometry.Ticket; };
 
-        void AssignPipeline(u32 id) { m_PipelineID = id; };
+        void AssignPipeline(PipelineHandle pipeline) { m_Pipeline = pipeline; };
 
     private:
-        void CreateVertexBuffer();
-        void CreateIndexBuffer();
-
-        VulkanContext*   m_Context           = nullptr;
-        BufferAllocation m_VertexBufferAlloc = {};
-        BufferAllocation m_IndexBufferAlloc  = {};
-        const Mesh*      m_Mesh              = nullptr;
-        u32              m_PipelineID        = UINT32_MAX;
+        void Upload(const MeshView& mesh);
+
+        VulkanGeometryArena* m_Arena        = nullptr;
+        GeometryAllocation   m_Geometry     = {};
+        u32                  m_VerticeCount = 0;
+        u32                  m_IndexCount   = 0;
+        IndexFormat          m_IndexFormat  = IndexFormat::eUint32;
+        PipelineHandle       m_Pipeline     = {};
+
+        VertexFormat         m_VertexFormat = VertexFormat::eFull;
+        VertexDequantization m_Dequantization;
+
+        // Level 0 always exists, so the renderer doesn't need to special case meshes without levels of detail
+        std::vector<MeshLod> m_Lods;
+
+        // Model space, computed from the unquantized vertices
+        MeshBounds m_Bounds;
     };
 }
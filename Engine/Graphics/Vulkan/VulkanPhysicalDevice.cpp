@@ -67,6 +67,7 @@ namespace Engine::Graphics
             {
                 m_PhysicalDevice = device;
                 m_Properties     = device.getProperties();
+                m_Features       = device.getFeatures();
                 LOG_INFO("Found suitable device ... (GPU: {}, Driver: {})",
                          (const char*)m_Properties.deviceName,
                          GetDriverVersionString(m_Properties));
@@ -28,6 +28,7 @@ namespace Engine::Graphics
         [[nodiscard]] const vk::PhysicalDevice&           GetHandle() const { return m_PhysicalDevice; };
         [[nodiscard]] const QueueFamilyIndices&           GetQueueFamilies() const { return m_QueueFamilyIndices; };
         [[nodiscard]] const vk::PhysicalDeviceProperties& GetProperties() const { return m_Properties; };
+        [[nodiscard]] const vk::PhysicalDeviceFeatures&   GetFeatures() const { return m_Features; };
 
         [[nodiscard]] SwapchainSupport GetSwapchainSupport() const { return QuerySwapchainSupport(m_PhysicalDevice); };
 
@@ -44,5 +45,6 @@ namespace Engine::Graphics
         vk::PhysicalDevice           m_PhysicalDevice;
         QueueFamilyIndices           m_QueueFamilyIndices;
         vk::PhysicalDeviceProperties m_Properties;
+        vk::PhysicalDeviceFeatures   m_Features; // Supported, not necessarily enabled
     };
 }
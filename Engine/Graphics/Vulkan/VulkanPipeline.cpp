@@ -1,9 +1,11 @@
 #include "VulkanPipeline.hpp"
 
-#include "Graphics/Resources/Mesh.hpp"
+#include "Core/Utility.hpp"
 
 #include "Graphics/Vulkan/VulkanAssert.hpp"
 
+#include <chrono>
+
 namespace Engine::Graphics
 {
     // ----- Public -----
@@ -11,61 +13,135 @@ namespace Engine::Graphics
     VulkanPipeline::VulkanPipeline(VulkanContext* context, const PipelineSpecification& spec)
         : m_Context(context), m_Spec(spec)
     {
+        ASSERT(m_Spec.VertexShader && m_Spec.FragmentShader, "Pipeline requires a vertex and a fragment shader!");
+
+        m_ShaderStages = { m_Spec.VertexShader->GetPipelineShaderStageCreateInfo(),
+                           m_Spec.FragmentShader->GetPipelineShaderStageCreateInfo() };
+        m_ColorFormat  = m_Context->GetSwapchain()->GetProperties().SurfaceFormat.format;
+        m_DepthFormat  = m_Context->GetSwapchain()->GetProperties().DepthFormat;
+
+        if (m_Spec.DepthShader)
+        {
+            m_DepthStage = m_Spec.DepthShader->GetPipelineShaderStageCreateInfo();
+            ASSERT(m_DepthStage.stage == vk::ShaderStageFlagBits::eVertex, "Depth shader has to be a vertex shader!");
+        }
+
         CreatePipelineLayout();
-        CreatePipeline();
+
+        // Drivers compile the shaders here, which is what takes long
+        Core::JobSystem::ExecuteBackground([this] { CreatePipelines(); }, &m_Compilation);
     }
 
     VulkanPipeline::~VulkanPipeline()
     {
         LOG_INFO("VulkanPipeline::Destructor() ...");
-        m_Context->GetDevice()->GetHandle().destroyPipelineLayout(m_Layout);
+
+        WaitUntilReady();
         m_Context->GetDevice()->GetHandle().destroyPipeline(m_Pipeline);
+        m_Context->GetDevice()->GetHandle().destroyPipeline(m_DepthPipeline);
     }
 
-    void VulkanPipeline::Bind(vk::CommandBuffer commandBuffer) const
+    void VulkanPipeline::WaitUntilReady() const
     {
-        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_Pipeline);
+        Core::JobSystem::Wait(m_Compilation);
+    }
+
+    void VulkanPipeline::Bind(vk::CommandBuffer commandBuffer, ScenePass pass) const
+    {
+        ASSERT(IsReady(), "Tried to bind a pipeline which is still compiling!");
+        ASSERT(pass == ScenePass::eMain || HasDepthPrepass(), "Pipeline has no depth pre-pass variant!");
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                                   pass == ScenePass::eMain ? m_Pipeline : m_DepthPipeline);
     }
 
     // ----- Private -----
 
     void VulkanPipeline::CreatePipelineLayout()
     {
-        ASSERT(m_Spec.DescriptorSetLayoutCount == 0 || m_Spec.DescriptorSetLayout, "Pipeline requires a valid layout!");
+        // Both variants share one layout, so pre-pass and main pass can keep their descriptor sets bound
+        ShaderReflection reflection = m_Spec.VertexShader->GetReflection();
+        reflection.Merge(m_Spec.FragmentShader->GetReflection());
+
+        if (m_Spec.DepthShader)
+        {
+            reflection.Merge(m_Spec.DepthShader->GetReflection());
+        }
 
-        const vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = m_Spec.DescriptorSetLayoutCount,
-                                                               .pSetLayouts    = &m_Spec.DescriptorSetLayout,
-                                                               .pushConstantRangeCount = 0,
-                                                               .pPushConstantRanges    = nullptr };
+        // Global uniforms live in the frame allocator and get bound with an offset
+        reflection.MakeDynamic(0, 0);
 
-        VK_VERIFY(m_Context->GetDevice()->GetHandle().createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_Layout));
-        LOG_INFO("Created pipeline layout ...");
+        m_Layout = m_Context->GetLayoutCache()->GetPipelineLayout(reflection);
     }
 
-    void VulkanPipeline::CreatePipeline()
+    void VulkanPipeline::CreatePipelines()
     {
+        // Warm caches skip the shader compilation in the driver
+        const auto startClock = std::chrono::high_resolution_clock::now();
+
+        if (HasDepthPrepass())
+        {
+            m_DepthPipeline = CreatePipeline(ScenePass::eDepthPrepass);
+        }
+
+        m_Pipeline = CreatePipeline(ScenePass::eMain);
+        m_Ready.store(true, std::memory_order_release);
+
+        const auto endClock = std::chrono::high_resolution_clock::now();
+
+        LOG_INFO("Created graphics pipeline ... (Vertex format: {}, Depth pre-pass: {})",
+                 VertexFormatToString(m_Spec.VertexEncoding),
+                 HasDepthPrepass() ? "Yes" : "No");
+        LOG_PERF("Graphics pipeline creation took {} ... ({} cache)",
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()),
+                 m_Context->GetPipelineCache()->IsWarm() ? "Warm" : "Cold");
+    }
+
+    vk::Pipeline VulkanPipeline::CreatePipeline(ScenePass pass) const
+    {
+        // The depth variant only runs the position only vertex shader and writes no color
+        const b8 depthOnly = pass == ScenePass::eDepthPrepass;
+
         // ----- Construct the different states making up the pipeline (using dynamic rendering) -----
 
         // Dynamic rendering specification
-        const vk::Format                      format = m_Context->GetSwapchain()->GetProperties().SurfaceFormat.format;
-        const vk::PipelineRenderingCreateInfo renderingInfo{ .colorAttachmentCount    = GLOBAL_COLOR_ATTACHMENT_COUNT,
-                                                             .pColorAttachmentFormats = &format };
-
-        // Shader stages
-        std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = {
-            m_Spec.VertexShader->GetPipelineShaderStageCreateInfo(),
-            m_Spec.FragmentShader->GetPipelineShaderStageCreateInfo()
+        const vk::PipelineRenderingCreateInfo renderingInfo{
+            .colorAttachmentCount    = depthOnly ? 0 : GLOBAL_COLOR_ATTACHMENT_COUNT,
+            .pColorAttachmentFormats = depthOnly ? nullptr : &m_ColorFormat,
+            .depthAttachmentFormat   = m_DepthFormat
+        };
+
+        // Vertex input state (descriptions of the selected vertex layout are generated at compile time), per
+        // instance transforms get streamed from a second binding
+        const std::array<vk::VertexInputBindingDescription, 2> bindingDescriptions = {
+            VisitVertexLayout(m_Spec.VertexEncoding, []<typename Layout>() { return Layout::GetBindingDescription(); }),
+            InstanceLayout::GetBindingDescription()
         };
 
-        // Vertex input state
-        auto                                         bindingDescription    = Vertex::GetBindingDescription();
-        auto                                         attributeDescriptions = Vertex::GetAttributeDescriptions();
-        const vk::PipelineVertexInputStateCreateInfo vertexState{ .vertexBindingDescriptionCount = 1,
-                                                                  .pVertexBindingDescriptions    = &bindingDescription,
-                                                                  .vertexAttributeDescriptionCount =
-                                                                      (u32)(attributeDescriptions.size()),
-                                                                  .pVertexAttributeDescriptions =
-                                                                      attributeDescriptions.data() };
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions;
+        VisitVertexLayout(m_Spec.VertexEncoding,
+                          [&attributeDescriptions]<typename Layout>()
+                          {
+                              const auto vertexAttributes = Layout::GetAttributeDescriptions();
+                              attributeDescriptions.assign(vertexAttributes.begin(), vertexAttributes.end());
+                          });
+
+        // Only the position (location 0) gets fetched for the pre-pass
+        if (depthOnly)
+        {
+            std::erase_if(attributeDescriptions, [](const auto& attribute) { return attribute.location != 0; });
+        }
+
+        const auto instanceAttributes = InstanceLayout::GetAttributeDescriptions();
+        attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributes.begin(), instanceAttributes.end());
+
+        const vk::PipelineVertexInputStateCreateInfo vertexState{
+            .vertexBindingDescriptionCount   = (u32)(bindingDescriptions.size()),
+            .pVertexBindingDescriptions      = bindingDescriptions.data(),
+            .vertexAttributeDescriptionCount = (u32)(attributeDescriptions.size()),
+            .pVertexAttributeDescriptions    = attributeDescriptions.data()
+        };
 
         // Input assembly state
         const vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{ .topology =
@@ -86,10 +162,10 @@ namespace Engine::Graphics
                                                                            vk::SampleCountFlagBits::e1,
                                                                        .sampleShadingEnable = vk::False };
 
-        // Depth stencil state
-        const vk::PipelineDepthStencilStateCreateInfo depthStencilState{ .depthTestEnable       = m_Spec.DepthTest,
-                                                                         .depthWriteEnable      = m_Spec.DepthWrite,
-                                                                         .depthCompareOp        = m_Spec.DepthOperator,
+        // Depth stencil state (test, write and compare op get set dynamically)
+        const vk::PipelineDepthStencilStateCreateInfo depthStencilState{ .depthTestEnable       = vk::True,
+                                                                         .depthWriteEnable      = vk::True,
+                                                                         .depthCompareOp        = vk::CompareOp::eLess,
                                                                          .depthBoundsTestEnable = vk::False,
                                                                          .stencilTestEnable     = vk::False };
 
@@ -100,21 +176,25 @@ namespace Engine::Graphics
         };
 
         // Color blend state
-        const vk::PipelineColorBlendStateCreateInfo colorBlendState{ .attachmentCount = GLOBAL_COLOR_ATTACHMENT_COUNT,
-                                                                     .pAttachments    = &blendAttachment };
+        const vk::PipelineColorBlendStateCreateInfo colorBlendState{
+            .attachmentCount = renderingInfo.colorAttachmentCount, .pAttachments = &blendAttachment
+        };
 
         // Specify dynamic states (can be changed without recreating the whole pipeline)
         std::vector<vk::DynamicState> dynamicStates = {
-            vk::DynamicState::eViewport,          vk::DynamicState::eScissor,  vk::DynamicState::ePolygonModeEXT,
-            vk::DynamicState::ePrimitiveTopology, vk::DynamicState::eCullMode, vk::DynamicState::eFrontFace
+            vk::DynamicState::eViewport,          vk::DynamicState::eScissor,         vk::DynamicState::ePolygonModeEXT,
+            vk::DynamicState::ePrimitiveTopology, vk::DynamicState::eCullMode,        vk::DynamicState::eFrontFace,
+            vk::DynamicState::eDepthTestEnable,   vk::DynamicState::eDepthWriteEnable, vk::DynamicState::eDepthCompareOp
         };
         const vk::PipelineDynamicStateCreateInfo dynamicState{ .dynamicStateCount = (u32)(dynamicStates.size()),
                                                                .pDynamicStates    = dynamicStates.data() };
 
         // ----- Finally: Create the pipeline -----
+        const vk::PipelineShaderStageCreateInfo* stages = depthOnly ? &m_DepthStage : m_ShaderStages.data();
+
         const vk::GraphicsPipelineCreateInfo pipelineInfo{ .pNext               = &renderingInfo,
-                                                           .stageCount          = 2,
-                                                           .pStages             = shaderStages.data(),
+                                                           .stageCount          = depthOnly ? 1u : 2u,
+                                                           .pStages             = stages,
                                                            .pVertexInputState   = &vertexState,
                                                            .pInputAssemblyState = &inputAssemblyState,
                                                            .pViewportState      = &viewportState,
@@ -125,9 +205,10 @@ namespace Engine::Graphics
                                                            .pDynamicState       = &dynamicState,
                                                            .layout              = m_Layout };
 
-        auto [res, pipeline] = m_Context->GetDevice()->GetHandle().createGraphicsPipeline(nullptr, pipelineInfo);
+        auto [res, pipeline] = m_Context->GetDevice()->GetHandle().createGraphicsPipeline(
+            m_Context->GetPipelineCache()->GetHandle(), pipelineInfo);
         VK_VERIFY(res);
-        m_Pipeline = pipeline;
-        LOG_INFO("Created graphics pipeline ...");
+
+        return pipeline;
     }
 }
@@ -1,41 +1,74 @@
 #pragma once
 
+#include "Core/JobSystem.hpp"
+
+#include "Graphics/Resources/VertexLayout.hpp"
+
 #include "Graphics/Vulkan/VulkanContext.hpp"
 #include "Graphics/Vulkan/VulkanShader.hpp"
 
+#include <array>
+#include <atomic>
+
 namespace Engine::Graphics
 {
+    // Variants of a pipeline, one per pass drawing the scene
+    enum class ScenePass : u8
+    {
+        eDepthPrepass = 0, // Depth only, no color attachment
+        eMain         = 1
+    };
+
+    // Depth test, write and compare op are dynamic state, so the main variant works with and without a pre-pass
     struct PipelineSpecification
     {
-        VulkanShader*           VertexShader             = nullptr;
-        VulkanShader*           FragmentShader           = nullptr;
-        vk::DescriptorSetLayout DescriptorSetLayout      = nullptr;
-        u32                     DescriptorSetLayoutCount = GLOBAL_DESCRIPTOR_SET_LAYOUT_COUNT;
-        vk::Bool32              DepthTest                = vk::False;
-        vk::Bool32              DepthWrite               = vk::False;
-        vk::CompareOp           DepthOperator            = vk::CompareOp::eLessOrEqual;
+        VulkanShader* VertexShader   = nullptr;
+        VulkanShader* FragmentShader = nullptr;
+        VulkanShader* DepthShader    = nullptr; // Position only vertex shader, adds the depth pre-pass variant
+        VertexFormat  VertexEncoding = VertexFormat::eFull;
     };
 
+    // The layout gets reflected from the shaders and shared through the layout cache, the variants compile on the job
+    // system's background thread (inline if it isn't running), so frames waiting for their own jobs never pick up a
+    // compilation. Shader modules only need to live until the compilation finished.
     class VulkanPipeline
     {
     public:
         explicit VulkanPipeline(VulkanContext* context, const PipelineSpecification& spec);
-        ~VulkanPipeline();
+        ~VulkanPipeline(); // Waits for the compilation
 
         VulkanPipeline(const VulkanPipeline&)            = delete;
         VulkanPipeline& operator=(const VulkanPipeline&) = delete;
 
         [[nodiscard]] vk::PipelineLayout GetLayout() const { return m_Layout; }
+        [[nodiscard]] VertexFormat       GetVertexFormat() const { return m_Spec.VertexEncoding; }
+        [[nodiscard]] b8                 HasDepthPrepass() const { return m_Spec.DepthShader != nullptr; }
+
+        // Pipelines can only be bound once they're ready
+        [[nodiscard]] b8 IsReady() const { return m_Ready.load(std::memory_order_acquire); }
+        void             WaitUntilReady() const;
 
-        void Bind(vk::CommandBuffer commandBuffer) const;
+        void Bind(vk::CommandBuffer commandBuffer, ScenePass pass = ScenePass::eMain) const;
 
     private:
         void CreatePipelineLayout();
-        void CreatePipeline();
+        void CreatePipelines();
+
+        [[nodiscard]] vk::Pipeline CreatePipeline(ScenePass pass) const;
 
-        VulkanContext*        m_Context  = nullptr;
-        vk::PipelineLayout    m_Layout   = nullptr;
-        vk::Pipeline          m_Pipeline = nullptr;
+        VulkanContext*        m_Context       = nullptr;
+        vk::PipelineLayout    m_Layout        = nullptr; // Owned by the layout cache, shared by both variants
+        vk::Pipeline          m_Pipeline      = nullptr;
+        vk::Pipeline          m_DepthPipeline = nullptr;
         PipelineSpecification m_Spec;
+
+        // Resolved on the creating thread, the compilation job doesn't touch the shader objects or the swapchain
+        std::array<vk::PipelineShaderStageCreateInfo, 2> m_ShaderStages = {};
+        vk::PipelineShaderStageCreateInfo                m_DepthStage   = {};
+        vk::Format                                       m_ColorFormat  = vk::Format::eUndefined;
+        vk::Format                                       m_DepthFormat  = vk::Format::eUndefined;
+
+        Core::JobCounter m_Compilation;
+        std::atomic<b8>  m_Ready = false;
     };
 }
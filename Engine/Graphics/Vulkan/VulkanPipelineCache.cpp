@@ -0,0 +1,148 @@
+#include "VulkanPipelineCache.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    // ----- Internal -----
+
+    constexpr std::string_view PIPELINE_CACHE_PATH = "Cache/Pipelines.vkcache";
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanPipelineCache::VulkanPipelineCache(const VulkanDevice* device) : m_Device(device)
+    {
+        const auto startClock = std::chrono::high_resolution_clock::now();
+
+        // Blobs of another device or driver version get dropped, drivers differ in how well they reject them
+        std::vector<u8> blob = LoadBlob();
+        if (!blob.empty() && !IsCompatible(blob))
+        {
+            LOG_WARN("Pipeline cache '{}' belongs to another device or driver, starting cold ...", PIPELINE_CACHE_PATH);
+            blob.clear();
+        }
+
+        const vk::PipelineCacheCreateInfo cacheInfo{ .initialDataSize = blob.size(), .pInitialData = blob.data() };
+        VK_VERIFY(m_Device->GetHandle().createPipelineCache(&cacheInfo, nullptr, &m_Cache));
+        m_Warm = !blob.empty();
+
+        const auto endClock = std::chrono::high_resolution_clock::now();
+
+        LOG_INFO("Created pipeline cache ... ({}, {})",
+                 m_Warm ? "Warm" : "Cold",
+                 Core::Utility::BytesToString(blob.size()));
+        LOG_PERF("Pipeline cache creation took {} ...",
+                 Core::Utility::MillisecondsToString(
+                     std::chrono::duration<f64, std::milli>(endClock - startClock).count()));
+    }
+
+    VulkanPipelineCache::~VulkanPipelineCache()
+    {
+        LOG_INFO("VulkanPipelineCache::Destructor() ...");
+
+        Save();
+        m_Device->GetHandle().destroyPipelineCache(m_Cache);
+    }
+
+    b8 VulkanPipelineCache::Save() const
+    {
+        auto [result, data] = m_Device->GetHandle().getPipelineCacheData(m_Cache);
+        if (result != vk::Result::eSuccess || data.empty())
+        {
+            LOG_WARN("Can't retrieve pipeline cache data ... ({})", vk::to_string(result));
+            return false;
+        }
+
+        const std::filesystem::path cachePath = PIPELINE_CACHE_PATH;
+        std::filesystem::path       tempPath  = cachePath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                LOG_WARN("Can't write pipeline cache '{}' ...", tempPath.string());
+                return false;
+            }
+
+            file.write((const char*)data.data(), (std::streamsize)data.size());
+
+            if (!file.good())
+            {
+                LOG_WARN("Failed writing pipeline cache '{}' ...", tempPath.string());
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        // Replace the old blob in one step, so a crash never leaves a half written cache behind
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+        {
+            LOG_WARN("Can't move pipeline cache to '{}' ... ({})", cachePath.string(), ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        LOG_INFO("Wrote pipeline cache '{}' ... ({})", cachePath.string(), Core::Utility::BytesToString(data.size()));
+        return true;
+    }
+
+    // ----- Private -----
+
+    std::vector<u8> VulkanPipelineCache::LoadBlob() const
+    {
+        std::ifstream file(std::filesystem::path(PIPELINE_CACHE_PATH), std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        std::vector<u8> blob((size_t)file.tellg());
+        file.seekg(0);
+        file.read((char*)blob.data(), (std::streamsize)blob.size());
+
+        if (!file.good())
+        {
+            LOG_WARN("Failed reading pipeline cache '{}' ...", PIPELINE_CACHE_PATH);
+            return {};
+        }
+
+        return blob;
+    }
+
+    b8 VulkanPipelineCache::IsCompatible(std::span<const u8> blob) const
+    {
+        if (blob.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+        {
+            return false;
+        }
+
+        VkPipelineCacheHeaderVersionOne header;
+        std::memcpy(&header, blob.data(), sizeof(header));
+
+        const vk::PhysicalDeviceProperties& properties = m_Device->GetPhysicalDevice()->GetProperties();
+
+        // The UUID changes with the driver version, so updated drivers don't get fed stale binaries
+        return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+               && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+               && header.vendorID == properties.vendorID && header.deviceID == properties.deviceID
+               && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Graphics/Vulkan/VulkanDevice.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Driver pipeline cache persisted between runs. The blob from the last run gets loaded on creation if its header
+    // matches the current device and driver, otherwise the cache starts out empty. All pipeline creation shares it
+    // (the driver synchronizes access internally) and it gets written back atomically on destruction.
+    class VulkanPipelineCache
+    {
+    public:
+        explicit VulkanPipelineCache(const VulkanDevice* device);
+        ~VulkanPipelineCache();
+
+        VulkanPipelineCache(const VulkanPipelineCache&)            = delete;
+        VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+        // Writes the current cache data to disk, returns false if it couldn't be written
+        b8 Save() const;
+
+        [[nodiscard]] vk::PipelineCache GetHandle() const { return m_Cache; }
+
+        // Whether a valid blob from a previous run was loaded, i.e. pipelines can skip compilation
+        [[nodiscard]] b8 IsWarm() const { return m_Warm; }
+
+    private:
+        [[nodiscard]] std::vector<u8> LoadBlob() const;
+        [[nodiscard]] b8              IsCompatible(std::span<const u8> blob) const;
+
+        const VulkanDevice* m_Device = nullptr;
+        vk::PipelineCache   m_Cache  = nullptr;
+        b8                  m_Warm   = false;
+    };
+}
@@ -2,6 +2,56 @@
 
 #include "Debug/Log.hpp"
 
+#include "Math/Frustum.hpp"
+
+#include "Vendor/glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    // Instance transforms get written straight into the instance stream
+    static_assert(sizeof(glm::mat4) == Graphics::InstanceLayout::STRIDE);
+
+    // Maps compressed positions back into model space
+    glm::mat4 GetDecodeTransform(const Graphics::VertexDequantization& dequantization)
+    {
+        return glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(dequantization.Offset)),
+                          glm::vec3(dequantization.Scale));
+    }
+
+    // World space bounding sphere (xyz: center, w: radius), non-uniform scales use the largest axis
+    glm::vec4 TransformBounds(const Graphics::MeshBounds& bounds, const glm::mat4& transform)
+    {
+        const glm::vec3 center = transform * glm::vec4(bounds.Center, 1.0f);
+        const f32       scale  = std::max({ glm::length(glm::vec3(transform[0])),
+                                            glm::length(glm::vec3(transform[1])),
+                                            glm::length(glm::vec3(transform[2])) });
+
+        return glm::vec4(center, bounds.Radius * scale);
+    }
+
+    // Culling phases recorded by the scopes of a frame
+    constexpr std::array<Graphics::CullingPhase, 1> EARLY_PHASE = { Graphics::CullingPhase::eEarly };
+    constexpr std::array<Graphics::CullingPhase, 1> LATE_PHASE  = { Graphics::CullingPhase::eLate };
+    constexpr std::array<Graphics::CullingPhase, 2> ALL_PHASES  = { Graphics::CullingPhase::eEarly,
+                                                                    Graphics::CullingPhase::eLate };
+
+    void PushDrawConstants(vk::CommandBuffer cmdBuffer, vk::PipelineLayout layout, const glm::mat4& model)
+    {
+        const Graphics::DrawPushConstants constants{ .Model = model };
+        cmdBuffer.pushConstants(layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(constants), &constants);
+    }
+}
+
 namespace Engine::Graphics
 {
     // ----- Public -----
@@ -11,7 +61,13 @@ namespace Engine::Graphics
         m_Context              = MakeScope<VulkanContext>();
         m_ImGuiLayer           = MakeScope<ImGuiLayer>(m_Context.get());
         m_ProfilerPanel        = MakeScope<ProfilerPanel>();
-        m_VulkanGlobalUniforms = MakeScope<VulkanGlobalUniforms>(m_Context.get());
+        m_FrameAllocator       = MakeScope<VulkanFrameAllocator>(m_Context.get());
+        m_VulkanGlobalUniforms = MakeScope<VulkanGlobalUniforms>(m_Context.get(), m_FrameAllocator.get());
+        m_UploadBatcher        = MakeScope<VulkanUploadBatcher>(m_Context->GetDevice());
+        m_GeometryArena        = MakeScope<VulkanGeometryArena>(m_Context.get(), m_UploadBatcher.get());
+        m_CommandRecorder      = MakeScope<VulkanCommandRecorder>(m_Context->GetDevice());
+        m_GpuProfiler          = MakeScope<VulkanGpuProfiler>(m_Context->GetDevice());
+        m_ShaderWatcher        = MakeScope<Platform::FileWatcher>();
 
         m_Swapchain = m_Context->GetSwapchain();
     }
@@ -19,54 +75,211 @@ namespace Engine::Graphics
     VulkanRenderer::~VulkanRenderer()
     {
         LOG_INFO("VulkanRenderer::Destructor() ...");
+
+        // Pipelines and shaders get destroyed in no particular order
+        WaitForPipelineCompilations();
+
+        // Destroyed models free their geometry ranges, which the transfer queue mustn't copy into anymore
+        for (const DeletionQueue& deletionQueue : m_DeletionQueues)
+        {
+            for (const Scope<VulkanModel>& model : deletionQueue.Models)
+            {
+                m_UploadBatcher->Wait(model->GetUploadTicket());
+            }
+        }
+    }
+
+    [[nodiscard]] ShaderHandle VulkanRenderer::LoadShader(vk::ShaderStageFlagBits      stage,
+                                                          const std::filesystem::path& path,
+                                                          std::vector<std::string>     defines)
+    {
+        const ShaderSource     source{ .Path = path, .Stage = stage, .Defines = std::move(defines) };
+        const std::vector<u32> code = ShaderCache::LoadOrCompile(source);
+        ASSERT(!code.empty(), "Can't load shader: {}", path.string());
+
+        m_ShaderWatcher->Watch(path);
+        return m_Shaders.Create(MakeScope<VulkanShader>(m_Context->GetDevice()->GetHandle(), source, code));
+    }
+
+    [[nodiscard]] ModelHandle VulkanRenderer::CreateModel(const MeshView& mesh, VertexFormat format)
+    {
+        return m_Models.Create(MakeScope<VulkanModel>(m_GeometryArena.get(), mesh, format));
+    }
+
+    [[nodiscard]] PipelineHandle VulkanRenderer::CreatePipeline(ShaderHandle          vertex,
+                                                                ShaderHandle          fragment,
+                                                                VertexFormat          format,
+                                                                PipelineReadyCallback onReady)
+    {
+        const PipelineHandle pipeline = m_Pipelines.Create(BuildPipeline(vertex, fragment, format));
+        m_PipelineSources.push_back({ .Pipeline = pipeline, .Vertex = vertex, .Fragment = fragment, .Format = format });
+
+        if (onReady)
+        {
+            m_PendingPipelines.push_back({ .Pipeline = pipeline, .OnReady = std::move(onReady) });
+        }
+
+        return pipeline;
+    }
+
+    [[nodiscard]] b8 VulkanRenderer::IsPipelineReady(PipelineHandle pipeline)
+    {
+        return GetPipeline(pipeline)->IsReady();
+    }
+
+    void VulkanRenderer::WaitForPipeline(PipelineHandle pipeline)
+    {
+        GetPipeline(pipeline)->WaitUntilReady();
     }
 
-    [[nodiscard]] u32 VulkanRenderer::LoadShader(vk::ShaderStageFlagBits stage, const std::filesystem::path& path)
+    void VulkanRenderer::DestroyShader(ShaderHandle shader)
     {
-        ASSERT(m_ShaderIndex != MAX_SHADER_COUNT, "Reached capacity ... Can't load any more shaders!");
+        ASSERT(m_Shaders.Contains(shader), "Shader '{}' was already destroyed!", shader.Index);
+        m_DeletionQueues.at(m_FrameIndex).Shaders.push_back(m_Shaders.Remove(shader));
+    }
+
+    void VulkanRenderer::DestroyModel(ModelHandle model)
+    {
+        ASSERT(m_Models.Contains(model), "Model '{}' was already destroyed!", model.Index);
+        m_DeletionQueues.at(m_FrameIndex).Models.push_back(m_Models.Remove(model));
+    }
 
-        const u32 currentIndex     = m_ShaderIndex;
-        m_Shaders.at(currentIndex) = MakeScope<VulkanShader>(m_Context->GetDevice()->GetHandle(), stage, path);
-        m_ShaderIndex++;
+    void VulkanRenderer::DestroyPipeline(PipelineHandle pipeline)
+    {
+        ASSERT(m_Pipelines.Contains(pipeline), "Pipeline '{}' was already destroyed!", pipeline.Index);
+        m_DeletionQueues.at(m_FrameIndex).Pipelines.push_back(m_Pipelines.Remove(pipeline));
 
-        return currentIndex;
+        std::erase_if(m_PipelineSources,
+                      [pipeline](const PipelineSource& source) { return source.Pipeline == pipeline; });
     }
 
-    [[nodiscard]] u32 VulkanRenderer::CreateModel(const Mesh* mesh)
+    void VulkanRenderer::AssignModelToPipeline(ModelHandle model, PipelineHandle pipeline)
     {
-        ASSERT(m_ModelIndex != MAX_MODEL_COUNT, "Reached capacity ... Can't load any more models!");
+        VulkanModel* vulkanModel = GetModel(model);
 
-        const u32 currentIndex    = m_ModelIndex;
-        m_Models.at(currentIndex) = MakeScope<VulkanModel>(m_Context.get(), mesh);
-        m_ModelIndex++;
+        ASSERT(vulkanModel->GetVertexFormat() == GetPipeline(pipeline)->GetVertexFormat(),
+               "Vertex format of model '{}' doesn't match pipeline '{}'!",
+               model.Index,
+               pipeline.Index);
 
-        return currentIndex;
+        vulkanModel->AssignPipeline(pipeline);
+        LOG_INFO("Bound model '{}' to pipeline '{}' ...", model.Index, pipeline.Index);
     }
 
-    [[nodiscard]] u32 VulkanRenderer::CreatePipeline(u32 vertexID, u32 fragmentID)
+    void VulkanRenderer::DrawInstances(ModelHandle model, std::span<const glm::mat4> transforms)
     {
-        ASSERT(m_PipelineIndex != MAX_PIPELINE_COUNT, "Reached capacity ... Can't create any more pipelines!");
+        if (transforms.empty())
+        {
+            return;
+        }
+
+        const VulkanModel* vulkanModel = GetModel(model);
+        const MeshBounds&  bounds      = vulkanModel->GetBounds();
+
+        // Folding the dequantization into the transforms leaves no per-model state, so any models can share a draw
+        const glm::mat4 decode = GetDecodeTransform(vulkanModel->GetDequantization());
 
-        const u32                   currentIndex = m_PipelineIndex;
-        const PipelineSpecification spec{ .VertexShader        = m_Shaders.at(vertexID).get(),
-                                          .FragmentShader      = m_Shaders.at(fragmentID).get(),
-                                          .DescriptorSetLayout = m_VulkanGlobalUniforms->GetLayout()->GetHandle() };
+        m_InstanceBatches.push_back({ .Model          = model,
+                                      .FirstTransform = (u32)m_InstanceTransforms.size(),
+                                      .InstanceCount  = (u32)transforms.size() });
 
-        m_Pipelines[currentIndex] = MakeScope<VulkanPipeline>(m_Context.get(), spec);
-        m_PipelineIndex++;
+        // World space bounds stay on the CPU for culling and level of detail
+        for (const glm::mat4& transform : transforms)
+        {
+            m_InstanceTransforms.push_back(transform * decode);
 
-        return currentIndex;
+            const glm::vec4 sphere = TransformBounds(bounds, transform);
+            m_InstanceBounds.Add(glm::vec3(sphere), sphere.w);
+        }
     }
 
-    void VulkanRenderer::AssignModelToPipeline(u32 modelID, u32 pipelineID)
+    void VulkanRenderer::DrawModel(ModelHandle model, const glm::mat4& transform)
     {
-        m_Models.at(modelID)->AssignPipeline(pipelineID);
-        LOG_INFO("Bound model '{}' to pipeline '{}' ...", modelID, pipelineID);
+        const VulkanModel* vulkanModel = GetModel(model);
+
+        m_SingleDraws.push_back({ .Model     = model,
+                                  .Transform = transform * GetDecodeTransform(vulkanModel->GetDequantization()),
+                                  .Sphere    = TransformBounds(vulkanModel->GetBounds(), transform) });
     }
 
-    [[nodiscard]] RenderPacket VulkanRenderer::BeginFrame(u32 pipelineID)
+    void VulkanRenderer::EnableGpuCulling(ShaderHandle cullShader, ShaderHandle pyramidShader)
     {
-        return { .Frame = m_Swapchain->BeginFrame(), .PipelineID = pipelineID };
+        // Frames in flight might still use the old command and count buffers
+        if (m_GpuCulling)
+        {
+            WaitForDevice();
+        }
+
+        m_GpuCulling = MakeScope<VulkanGpuCulling>(
+            m_Context.get(), m_FrameAllocator.get(), GetShader(cullShader), GetShader(pyramidShader));
+        LOG_INFO("Enabled GPU culling ...");
+    }
+
+    void VulkanRenderer::EnableDepthPrepass(ShaderHandle depthShader)
+    {
+        ASSERT(GetShader(depthShader)->GetSource().Stage == vk::ShaderStageFlagBits::eVertex,
+               "Depth pre-pass requires a vertex shader!");
+
+        m_DepthShader = depthShader;
+
+        for (const PipelineSource& source : m_PipelineSources)
+        {
+            RebuildPipeline(source.Pipeline, source.Vertex, source.Fragment, source.Format);
+        }
+
+        LOG_INFO("Enabled depth pre-pass ... (Rebuilding {} pipeline(s))", m_PipelineSources.size());
+    }
+
+    [[nodiscard]] RenderPacket VulkanRenderer::BeginFrame(PipelineHandle pipeline)
+    {
+        const std::optional<SwapchainFrame> frame = m_Swapchain->BeginFrame();
+
+        // The swapchain waited for the frame slot's fence, so its per-frame data can be overwritten and resources
+        // destroyed while this slot was recorded the last time aren't in use anymore
+        if (frame.has_value())
+        {
+            m_FrameIndex = frame->FrameIndex;
+            m_FrameAllocator->BeginFrame(m_FrameIndex);
+            m_CommandRecorder->BeginFrame(m_FrameIndex);
+            m_GpuProfiler->SetPipelineStatisticsEnabled(m_ProfilerPanel->WantsPipelineStatistics());
+            m_GpuProfiler->BeginFrame(m_FrameIndex);
+
+            // Compilations read the shader modules, so they have to finish before any shader gets destroyed
+            if (!m_DeletionQueues.at(m_FrameIndex).Shaders.empty())
+            {
+                WaitForPipelineCompilations();
+            }
+
+            // The graphics queue is done with the slot's models, but a model destroyed right after it got created can
+            // still have its copies in flight on the transfer queue, so it keeps its geometry range until they landed
+            DeletionQueue&                  deletionQueue = m_DeletionQueues.at(m_FrameIndex);
+            std::vector<Scope<VulkanModel>> uploadingModels;
+            for (Scope<VulkanModel>& model : deletionQueue.Models)
+            {
+                if (!m_UploadBatcher->IsComplete(model->GetUploadTicket()))
+                {
+                    uploadingModels.push_back(std::move(model));
+                }
+            }
+
+            deletionQueue        = {};
+            deletionQueue.Models = std::move(uploadingModels);
+            ReloadChangedShaders();
+
+            m_InstanceBatches.clear();
+            m_InstanceTransforms.clear();
+            m_InstanceBounds.Clear();
+            m_SingleDraws.clear();
+
+            if (m_GpuCulling)
+            {
+                m_GpuCulling->BeginFrame(m_FrameIndex);
+            }
+        }
+
+        UpdatePendingPipelines();
+
+        return { .Frame = frame, .Pipeline = pipeline };
     }
 
     void VulkanRenderer::DrawFrame(RenderPacket renderPacket, const Core::FrameTiming& frameTiming)
@@ -77,15 +290,80 @@ namespace Engine::Graphics
         // Reset draw stats
         m_RenderStats = {};
 
-        m_Swapchain->BeginRendering(frame, glm::vec4(0.5, 0.5, 0.5, 1.0));
+        // Submit all uploads queued since the last frame at once
+        m_UploadBatcher->Flush();
+
+        m_Swapchain->BeginRecording(frame);
+        m_GpuProfiler->BeginRecording(frame.Resources->CommandBuffer);
+
+        const u32 globalsOffset = UpdateGlobalUniforms(frame.Extent);
+
+        // Needs the camera of this frame
+        StreamInstances();
 
-        SetDynamicStates(frame.Resources->CommandBuffer, frame.Extent);
-        UpdateGlobalUniforms(frame.Extent, frame.FrameIndex, frameTiming);
-        RenderScene(frame.Resources->CommandBuffer, renderPacket.PipelineID, frame.FrameIndex);
-        RenderUI(frame.Resources->CommandBuffer, frameTiming);
+        const VulkanPipeline* scenePipeline = GetPipeline(renderPacket.Pipeline);
+        m_DepthPrepassActive = scenePipeline->IsReady() && scenePipeline->HasDepthPrepass();
 
+        // Occlusion culling tests against the pre-pass depth, without it the GPU only frustum culls
+        const b8 occlusion = m_GpuCulling && m_DepthPrepassActive;
+
+        // The culling pass has to run outside of rendering
+        if (m_GpuCulling)
+        {
+            CullScene(frame.Resources->CommandBuffer, renderPacket.Pipeline, globalsOffset, occlusion);
+        }
+
+        // Scene partitions and the UI get recorded into secondary command buffers, the primary only executes them.
+        // The scene waits for its pipeline, so the UI keeps running while it compiles in the background.
+        std::vector<vk::CommandBuffer> secondaries;
+        if (scenePipeline->IsReady())
+        {
+            BuildDrawList(renderPacket.Pipeline);
+
+            if (m_DepthPrepassActive)
+            {
+                RenderDepthPrepass(frame, renderPacket.Pipeline, globalsOffset, occlusion);
+            }
+
+            secondaries = RecordScene(renderPacket.Pipeline,
+                                      ScenePass::eMain,
+                                      occlusion ? std::span<const CullingPhase>(ALL_PHASES) : EARLY_PHASE,
+                                      globalsOffset,
+                                      frame.Extent);
+        }
+
+        for (const Scope<VulkanPipeline>& pipeline : m_Pipelines)
+        {
+            m_RenderStats.CompilingPipelines += !pipeline->IsReady();
+        }
+
+        for (const ReloadingPipeline& reloading : m_ReloadingPipelines)
+        {
+            m_RenderStats.CompilingPipelines += !reloading.Replacement->IsReady();
+        }
+
+        m_RenderStats.FrameBytes = m_FrameAllocator->GetUsedSize();
+        secondaries.push_back(RecordUI(frameTiming));
+
+        m_Swapchain->BeginRendering(frame,
+                                    glm::vec4(0.5, 0.5, 0.5, 1.0),
+                                    vk::RenderingFlagBits::eContentsSecondaryCommandBuffers,
+                                    m_DepthPrepassActive ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear);
+        frame.Resources->CommandBuffer.executeCommands((u32)secondaries.size(), secondaries.data());
         m_Swapchain->EndRendering(frame);
-        m_Swapchain->SubmitAndPresent(frame);
+
+        if (m_GpuCulling)
+        {
+            m_GpuCulling->CopyVisibleCounts(frame.Resources->CommandBuffer);
+        }
+
+        m_GpuProfiler->EndRecording(frame.Resources->CommandBuffer);
+        m_Swapchain->EndRecording(frame);
+
+        // Only models with completed uploads got drawn, so this wait never stalls but orders the reads after the copies
+        m_Swapchain->SubmitAndPresent(frame,
+                                      TimelineWait{ .Semaphore = m_UploadBatcher->GetTimeline(),
+                                                    .Value     = m_UploadBatcher->GetCompletedValue() });
     }
 
     void VulkanRenderer::WaitForDevice()
@@ -95,7 +373,7 @@ namespace Engine::Graphics
 
     // ----- Private -----
 
-    void VulkanRenderer::SetDynamicStates(vk::CommandBuffer cmdBuffer, vk::Extent2D extent)
+    void VulkanRenderer::SetDynamicStates(vk::CommandBuffer cmdBuffer, vk::Extent2D extent) const
     {
         const vk::Viewport viewport = {
             .width = (f32)extent.width, .height = (f32)extent.height, .minDepth = 0.0f, .maxDepth = 1.0f
@@ -111,63 +389,736 @@ namespace Engine::Graphics
         cmdBuffer.setFrontFace(vk::FrontFace::eCounterClockwise);
     }
 
-    void VulkanRenderer::UpdateGlobalUniforms(vk::Extent2D extent, u32 frameIndex, const Core::FrameTiming& frameTiming)
+    void VulkanRenderer::UpdatePendingPipelines()
+    {
+        // Rebuilt pipelines take over once they're ready, frames in flight might still use the old ones
+        for (auto reloading = m_ReloadingPipelines.begin(); reloading != m_ReloadingPipelines.end();)
+        {
+            Scope<VulkanPipeline>* resource = m_Pipelines.Get(reloading->Pipeline);
+            if (resource != nullptr && !reloading->Replacement->IsReady())
+            {
+                ++reloading;
+                continue;
+            }
+
+            if (resource != nullptr)
+            {
+                std::swap(*resource, reloading->Replacement);
+                LOG_INFO("Reloaded pipeline '{}' ...", reloading->Pipeline.Index);
+            }
+
+            m_DeletionQueues.at(m_FrameIndex).Pipelines.push_back(std::move(reloading->Replacement));
+            reloading = m_ReloadingPipelines.erase(reloading);
+        }
+
+        std::erase_if(m_PendingPipelines,
+                      [this](const PendingPipeline& pending)
+                      {
+                          // Destroyed before it got ready, nobody is interested anymore
+                          Scope<VulkanPipeline>* resource = m_Pipelines.Get(pending.Pipeline);
+                          if (resource == nullptr)
+                          {
+                              return true;
+                          }
+
+                          if (!(*resource)->IsReady())
+                          {
+                              return false;
+                          }
+
+                          pending.OnReady(pending.Pipeline);
+                          return true;
+                      });
+    }
+
+    void VulkanRenderer::WaitForPipelineCompilations()
+    {
+        for (const Scope<VulkanPipeline>& pipeline : m_Pipelines)
+        {
+            pipeline->WaitUntilReady();
+        }
+
+        for (const ReloadingPipeline& reloading : m_ReloadingPipelines)
+        {
+            reloading.Replacement->WaitUntilReady();
+        }
+
+        for (const DeletionQueue& deletionQueue : m_DeletionQueues)
+        {
+            for (const Scope<VulkanPipeline>& pipeline : deletionQueue.Pipelines)
+            {
+                pipeline->WaitUntilReady();
+            }
+        }
+    }
+
+    void VulkanRenderer::ReloadChangedShaders()
+    {
+        const std::vector<std::filesystem::path> changedPaths = m_ShaderWatcher->Poll();
+        if (changedPaths.empty())
+        {
+            return;
+        }
+
+        std::vector<ShaderHandle> reloadedShaders;
+
+        for (u32 i = 0; i < m_Shaders.GetSize(); i++)
+        {
+            const ShaderHandle   shader   = m_Shaders.GetHandle(i);
+            Scope<VulkanShader>& resource = *m_Shaders.Get(shader);
+            const ShaderSource&  source   = resource->GetSource();
+
+            if (std::ranges::find(changedPaths, source.Path) == changedPaths.end())
+            {
+                continue;
+            }
+
+            // Broken edits keep the last working shader, the next save gets another chance
+            const std::vector<u32> code = ShaderCache::LoadOrCompile(source);
+            if (code.empty())
+            {
+                LOG_WARN("Keeping previous version of shader '{}' ...", source.Path.string());
+                continue;
+            }
+
+            Scope<VulkanShader> reloaded = MakeScope<VulkanShader>(m_Context->GetDevice()->GetHandle(), source, code);
+            m_DeletionQueues.at(m_FrameIndex).Shaders.push_back(std::exchange(resource, std::move(reloaded)));
+            reloadedShaders.push_back(shader);
+        }
+
+        // Only graphics pipelines get rebuilt, compute pipelines don't keep a reference to their shader. The depth
+        // shader is part of all of them.
+        const b8 depthReloaded = std::ranges::find(reloadedShaders, m_DepthShader) != reloadedShaders.end();
+
+        for (const PipelineSource& source : m_PipelineSources)
+        {
+            if (!depthReloaded && std::ranges::find(reloadedShaders, source.Vertex) == reloadedShaders.end()
+                && std::ranges::find(reloadedShaders, source.Fragment) == reloadedShaders.end())
+            {
+                continue;
+            }
+
+            RebuildPipeline(source.Pipeline, source.Vertex, source.Fragment, source.Format);
+        }
+    }
+
+    Scope<VulkanPipeline> VulkanRenderer::BuildPipeline(ShaderHandle vertex, ShaderHandle fragment, VertexFormat format)
+    {
+        // Without its shader the pre-pass variant is left out, the pre-pass then gets skipped
+        const Scope<VulkanShader>*  depthShader = m_Shaders.Get(m_DepthShader);
+        const PipelineSpecification spec{ .VertexShader   = GetShader(vertex),
+                                          .FragmentShader = GetShader(fragment),
+                                          .DepthShader    = depthShader ? depthShader->get() : nullptr,
+                                          .VertexEncoding = format };
+
+        return MakeScope<VulkanPipeline>(m_Context.get(), spec);
+    }
+
+    void VulkanRenderer::RebuildPipeline(PipelineHandle pipeline,
+                                         ShaderHandle   vertex,
+                                         ShaderHandle   fragment,
+                                         VertexFormat   format)
+    {
+        // Pipelines whose shaders were destroyed in the meantime can't be rebuilt
+        if (!m_Shaders.Contains(vertex) || !m_Shaders.Contains(fragment))
+        {
+            LOG_WARN("Can't rebuild pipeline '{}', one of its shaders was destroyed ...", pipeline.Index);
+            return;
+        }
+
+        // A rebuild still compiling from an earlier edit is outdated now
+        const auto previous = std::ranges::find(m_ReloadingPipelines, pipeline, &ReloadingPipeline::Pipeline);
+        if (previous != m_ReloadingPipelines.end())
+        {
+            m_DeletionQueues.at(m_FrameIndex).Pipelines.push_back(std::move(previous->Replacement));
+            m_ReloadingPipelines.erase(previous);
+        }
+
+        Scope<VulkanPipeline> replacement = BuildPipeline(vertex, fragment, format);
+        m_ReloadingPipelines.push_back({ .Pipeline = pipeline, .Replacement = std::move(replacement) });
+    }
+
+    u32 VulkanRenderer::UpdateGlobalUniforms(vk::Extent2D extent)
     {
         // Update uniform data (later with real camera information)
-        m_GlobalUniformData.Model = glm::rotate(
-            glm::mat4(1.0f), (f32)frameTiming.TotalSeconds * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        const f32 fieldOfView = glm::radians(45.0f);
+        m_CameraPosition      = glm::vec3(0.0f, 15.0f, 10.0f);
+        m_CameraNear          = 0.1f;
+        m_LodScale            = (f32)extent.height / (2.0f * std::tan(fieldOfView * 0.5f));
+
         m_GlobalUniformData.View =
-            glm::lookAt(glm::vec3(0.0f, 15.0f, 10.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+            glm::lookAt(m_CameraPosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         m_GlobalUniformData.Projection =
-            glm::perspective(glm::radians(45.0f), (f32)extent.width / (f32)extent.height, 0.1f, 100.0f);
+            glm::perspective(fieldOfView, (f32)extent.width / (f32)extent.height, m_CameraNear, 100.0f);
         m_GlobalUniformData.Projection[1][1] *= -1; // Flip Y-Coordinate of clip coordinates because of legacy OpenGL
 
-        // Inform global uniforms that the data has changed
-        m_VulkanGlobalUniforms->Update(frameIndex, &m_GlobalUniformData);
+        // Copy into the current frame's region of the frame allocator
+        return m_VulkanGlobalUniforms->Update(&m_GlobalUniformData);
+    }
+
+    void VulkanRenderer::StreamInstances()
+    {
+        // Single draws get their transform pushed, the instance stream only holds one identity for all of them
+        if (!m_SingleDraws.empty())
+        {
+            const FrameAllocation identity =
+                m_FrameAllocator->AllocateVertex(sizeof(glm::mat4), InstanceLayout::STRIDE);
+
+            *(glm::mat4*)identity.Data = glm::mat4(1.0f);
+            m_IdentityInstance         = identity.Offset / InstanceLayout::STRIDE;
+        }
+
+        if (m_InstanceBatches.empty())
+        {
+            return;
+        }
+
+        // The GPU culls by itself, otherwise only the instances inside the frustum get streamed
+        u32 visibleCount = m_InstanceBounds.GetSize();
+        if (!m_GpuCulling)
+        {
+            const Math::Frustum frustum(m_GlobalUniformData.Projection * m_GlobalUniformData.View);
+            visibleCount = m_InstanceBounds.Cull(frustum, m_InstanceVisibility);
+
+            m_RenderStats.Visible = visibleCount;
+            m_RenderStats.Culled  = m_InstanceBounds.GetSize() - visibleCount;
+        }
+
+        if (visibleCount == 0)
+        {
+            return;
+        }
+
+        // One allocation for the whole frame, its offset is a multiple of the stride
+        const FrameAllocation allocation =
+            m_FrameAllocator->AllocateVertex(visibleCount * sizeof(glm::mat4), InstanceLayout::STRIDE);
+        const u32  baseInstance = allocation.Offset / InstanceLayout::STRIDE;
+        glm::mat4* instances    = (glm::mat4*)allocation.Data;
+        u32        written      = 0;
+
+        // Batches stay contiguous, the mapped memory is write-combined and only gets written sequentially
+        for (InstanceBatch& batch : m_InstanceBatches)
+        {
+            const u32 batchBegin = written;
+
+            if (m_GpuCulling)
+            {
+                std::copy_n(&m_InstanceTransforms[batch.FirstTransform], batch.InstanceCount, instances + written);
+                written += batch.InstanceCount;
+            }
+            else
+            {
+                for (u32 i = batch.FirstTransform; i < batch.FirstTransform + batch.InstanceCount; i++)
+                {
+                    if (Math::BoundingSpheres::IsVisible(m_InstanceVisibility, i))
+                    {
+                        instances[written++] = m_InstanceTransforms[i];
+                    }
+                }
+            }
+
+            batch.FirstInstance = baseInstance + batchBegin;
+            batch.VisibleCount  = written - batchBegin;
+        }
+    }
+
+    void VulkanRenderer::CullScene(vk::CommandBuffer cmdBuffer,
+                                   PipelineHandle    pipelineHandle,
+                                   u32               globalsOffset,
+                                   b8                occlusion)
+    {
+        // Every instance of a model assigned to this pipeline becomes an object
+        for (const InstanceBatch& batch : m_InstanceBatches)
+        {
+            const Scope<VulkanModel>* resource = m_Models.Get(batch.Model);
+            if (resource == nullptr || (*resource)->GetPipeline() != pipelineHandle)
+            {
+                continue;
+            }
+
+            const VulkanModel* model = resource->get();
+
+            // Skip models until their geometry arrived instead of waiting for the transfer queue
+            if (!m_UploadBatcher->IsComplete(model->GetUploadTicket()))
+            {
+                m_RenderStats.PendingUploads++;
+                continue;
+            }
+
+            // Index formats need different index buffer bindings, so each one is a draw group of its own
+            GpuObject object{ .FirstIndex   = model->GetFirstIndex(),
+                              .VertexOffset = model->GetVertexOffset(),
+                              .LodCount     = std::min((u32)model->GetLods().size(), GPU_CULLING_MAX_LODS),
+                              .DrawGroup    = (u32)model->GetIndexFormat() };
+
+            for (u32 lod = 0; lod < object.LodCount; lod++)
+            {
+                const MeshLod& meshLod = model->GetLods()[lod];
+                object.Lods[lod] = { .IndexOffset = meshLod.IndexOffset,
+                                     .IndexCount  = meshLod.IndexCount,
+                                     .Error       = meshLod.Error };
+            }
+
+            for (u32 i = 0; i < batch.InstanceCount; i++)
+            {
+                object.Sphere   = m_InstanceBounds.Get(batch.FirstTransform + i);
+                object.Instance = batch.FirstInstance + i;
+                m_GpuCulling->AddObject(object);
+            }
+
+            m_RenderStats.Models++;
+            m_RenderStats.Instances += batch.InstanceCount;
+        }
+
+        const Math::Frustum        frustum(m_GlobalUniformData.Projection * m_GlobalUniformData.View);
+        const GpuCullingParameters parameters{ .FrustumPlanes     = frustum.GetPlanes(),
+                                               .CameraPosition    = glm::vec4(m_CameraPosition, m_LodScale),
+                                               .CameraNear        = m_CameraNear,
+                                               .LodErrorThreshold = LOD_ERROR_THRESHOLD };
+
+        const GpuScope scope = m_GpuProfiler->CreateScope("Culling");
+        m_GpuProfiler->Begin(cmdBuffer, scope);
+        m_GpuCulling->Cull(cmdBuffer, parameters, globalsOffset, occlusion);
+        m_GpuProfiler->End(cmdBuffer, scope);
+
+        m_RenderStats.GpuObjects  = m_GpuCulling->GetObjectCount();
+        m_RenderStats.GpuVisible  = m_GpuCulling->GetVisibleCount();
+        m_RenderStats.GpuOccluded = m_GpuCulling->GetOccludedCount();
+    }
+
+    void VulkanRenderer::RenderDepthPrepass(const SwapchainFrame& frame,
+                                            PipelineHandle        pipelineHandle,
+                                            u32                   globalsOffset,
+                                            b8                    occlusion)
+    {
+        const vk::CommandBuffer  cmdBuffer = frame.Resources->CommandBuffer;
+        const vk::RenderingFlags flags     = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+
+        // Indirect commands get read at execution, so the late phase can be recorded before it got culled
+        const std::vector<vk::CommandBuffer> early =
+            RecordScene(pipelineHandle, ScenePass::eDepthPrepass, EARLY_PHASE, globalsOffset, frame.Extent);
+        const std::vector<vk::CommandBuffer> late =
+            occlusion ? RecordScene(pipelineHandle, ScenePass::eDepthPrepass, LATE_PHASE, globalsOffset, frame.Extent)
+                      : std::vector<vk::CommandBuffer>();
+
+        // Both phases add up to the pre-pass time
+        const GpuScope earlyScope = m_GpuProfiler->CreateScope("Pre-pass");
+        m_GpuProfiler->Begin(cmdBuffer, earlyScope);
+        m_Swapchain->BeginDepthPrepass(frame, flags);
+        if (!early.empty())
+        {
+            cmdBuffer.executeCommands((u32)early.size(), early.data());
+        }
+        m_Swapchain->EndDepthPrepass(frame);
+        m_GpuProfiler->End(cmdBuffer, earlyScope);
+
+        if (!occlusion)
+        {
+            return;
+        }
+
+        // What the early draws left behind decides which of the remaining objects get drawn
+        const GpuScope occlusionScope = m_GpuProfiler->CreateScope("Occlusion");
+        m_GpuProfiler->Begin(cmdBuffer, occlusionScope);
+        m_GpuCulling->CullOccluded(cmdBuffer);
+        m_GpuProfiler->End(cmdBuffer, occlusionScope);
+
+        const GpuScope lateScope = m_GpuProfiler->CreateScope("Pre-pass");
+        m_GpuProfiler->Begin(cmdBuffer, lateScope);
+        m_Swapchain->BeginDepthPrepass(frame, flags, vk::AttachmentLoadOp::eLoad);
+        if (!late.empty())
+        {
+            cmdBuffer.executeCommands((u32)late.size(), late.data());
+        }
+        m_Swapchain->EndDepthPrepass(frame);
+        m_GpuProfiler->End(cmdBuffer, lateScope);
+    }
+
+    std::vector<vk::CommandBuffer> VulkanRenderer::RecordScene(PipelineHandle                pipelineHandle,
+                                                               ScenePass                     pass,
+                                                               std::span<const CullingPhase> phases,
+                                                               u32                           globalsOffset,
+                                                               vk::Extent2D                  extent)
+    {
+        // Single draws and CPU culled batches are drawn along with the early phase
+        const b8                           earlyPhase = std::ranges::find(phases, CullingPhase::eEarly) != phases.end();
+        const std::span<const DrawCommand> drawList   = earlyPhase ? std::span<const DrawCommand>(m_DrawList)
+                                                                   : std::span<const DrawCommand>();
+
+        const VulkanPipeline*      pipeline   = GetPipeline(pipelineHandle);
+        const SwapchainProperties& properties = m_Swapchain->GetProperties();
+
+        // The pre-pass renders without color attachment
+        const AttachmentFormats formats{ .Color = pass == ScenePass::eMain ? properties.SurfaceFormat.format
+                                                                             : vk::Format::eUndefined,
+                                         .Depth = properties.DepthFormat };
+
+        // The main pass shares its rendering scope with the UI, so it gets timed from within its secondaries
+        const char*    passName = pass == ScenePass::eMain ? "Scene" : "Pre-pass";
+        const GpuScope scope    = pass == ScenePass::eMain ? m_GpuProfiler->CreateScope(passName) : GpuScope();
+
+        // Objects were culled on the GPU already, a handful of indirect calls isn't worth splitting. The draw list
+        // only holds the single draws then.
+        if (m_GpuCulling)
+        {
+            m_RenderStats.BufferBinds += 2;
+
+            const GpuScope statistics = m_GpuProfiler->CreateStatisticsScope(passName);
+            return m_CommandRecorder->Record(formats,
+                                             1,
+                                             [&](vk::CommandBuffer cmdBuffer, u32)
+                                             {
+                                                 m_GpuProfiler->Begin(cmdBuffer, scope);
+                                                 m_GpuProfiler->BeginStatistics(cmdBuffer, statistics);
+                                                 BindSceneState(cmdBuffer, *pipeline, pass, globalsOffset, extent);
+                                                 const u32 indirect = DrawGpuCulled(cmdBuffer, phases);
+                                                 const u32 binds    = RecordDraws(cmdBuffer, *pipeline, drawList);
+                                                 m_GpuProfiler->EndStatistics(cmdBuffer, statistics);
+                                                 m_GpuProfiler->End(cmdBuffer, scope);
+
+                                                 m_RenderStats.BufferBinds += indirect + binds;
+                                                 if (pass == ScenePass::eMain)
+                                                 {
+                                                     m_RenderStats.DrawCalls += indirect;
+                                                 }
+                                                 else
+                                                 {
+                                                     m_RenderStats.PrepassDraws += indirect + (u32)drawList.size();
+                                                 }
+                                             });
+        }
+
+        if (drawList.empty())
+        {
+            return {};
+        }
+
+        // Only split once every thread gets enough draws to make up for setting up its command buffer
+        const u32 partitionCount = std::clamp(
+            (u32)drawList.size() / RECORDING_MIN_DRAWS_PER_PARTITION, 1u, m_CommandRecorder->GetThreadCount());
+        const u32 partitionSize = ((u32)drawList.size() + partitionCount - 1) / partitionCount;
+
+        // Every partition counts its own binds, stats aren't touched from workers. Statistics queries can't span
+        // command buffers, so each partition gets one of its own.
+        std::vector<u32>      partitionBinds(partitionCount, 0);
+        std::vector<GpuScope> partitionStatistics(partitionCount);
+        for (GpuScope& statistics : partitionStatistics)
+        {
+            statistics = m_GpuProfiler->CreateStatisticsScope(passName);
+        }
+
+        std::vector<vk::CommandBuffer> cmdBuffers = m_CommandRecorder->Record(
+            formats,
+            partitionCount,
+            [&](vk::CommandBuffer cmdBuffer, u32 partition)
+            {
+                const u32 first = partition * partitionSize;
+                const u32 count = std::min(partitionSize, (u32)drawList.size() - first);
+
+                // Partitions get executed in order, the scope spans from the first to the last
+                if (partition == 0)
+                {
+                    m_GpuProfiler->Begin(cmdBuffer, scope);
+                }
+
+                m_GpuProfiler->BeginStatistics(cmdBuffer, partitionStatistics[partition]);
+                BindSceneState(cmdBuffer, *pipeline, pass, globalsOffset, extent);
+                partitionBinds[partition] =
+                    2 + RecordDraws(cmdBuffer, *pipeline, drawList.subspan(first, count));
+                m_GpuProfiler->EndStatistics(cmdBuffer, partitionStatistics[partition]);
+
+                if (partition == partitionCount - 1)
+                {
+                    m_GpuProfiler->End(cmdBuffer, scope);
+                }
+            });
+
+        for (const u32 binds : partitionBinds)
+        {
+            m_RenderStats.BufferBinds += binds;
+        }
+
+        if (pass == ScenePass::eDepthPrepass)
+        {
+            m_RenderStats.PrepassDraws += (u32)drawList.size();
+        }
+
+        return cmdBuffers;
     }
 
-    void VulkanRenderer::RenderScene(vk::CommandBuffer cmdBuffer, u32 pipelineID, u32 frameIndex)
+    void VulkanRenderer::BindSceneState(vk::CommandBuffer     cmdBuffer,
+                                        const VulkanPipeline& pipeline,
+                                        ScenePass             pass,
+                                        u32                   globalsOffset,
+                                        vk::Extent2D          extent) const
     {
+        // Secondary command buffers inherit no state, every one of them sets up everything
+        SetDynamicStates(cmdBuffer, extent);
+
+        // After a pre-pass only the fragments which made it into the depth image get shaded
+        const b8 shadeVisibleOnly = pass == ScenePass::eMain && m_DepthPrepassActive;
+        cmdBuffer.setDepthTestEnable(vk::True);
+        cmdBuffer.setDepthWriteEnable(shadeVisibleOnly ? vk::False : vk::True);
+        cmdBuffer.setDepthCompareOp(shadeVisibleOnly ? vk::CompareOp::eEqual : vk::CompareOp::eLess);
+
         // Bind pipeline
-        m_Pipelines.at(pipelineID)->Bind(cmdBuffer);
+        pipeline.Bind(cmdBuffer, pass);
 
-        // Bind global descriptor set for current frame
+        // Bind global descriptor set, the dynamic offset selects the current frame's uniform data
         cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-                                     m_Pipelines.at(pipelineID)->GetLayout(),
+                                     pipeline.GetLayout(),
                                      0,
                                      GLOBAL_DESCRIPTOR_SET_LAYOUT_COUNT,
-                                     m_VulkanGlobalUniforms->GetDescriptorSet(frameIndex),
-                                     0,
-                                     nullptr);
+                                     m_VulkanGlobalUniforms->GetDescriptorSet(),
+                                     1,
+                                     &globalsOffset);
+
+        // All models share the arena buffers, the index buffer only needs a rebind when the index format changes.
+        // Instance transforms of the whole frame live in one buffer, batches get selected through firstInstance.
+        const vk::Buffer     instanceBuffer = m_FrameAllocator->GetBuffer();
+        const vk::DeviceSize instanceOffset = 0;
+        m_GeometryArena->BindVertexBuffer(cmdBuffer);
+        cmdBuffer.bindVertexBuffers(InstanceLayout::BINDING, 1, &instanceBuffer, &instanceOffset);
+
+        // Instanced draws carry their whole transform in the instance stream
+        PushDrawConstants(cmdBuffer, pipeline.GetLayout(), glm::mat4(1.0f));
+    }
 
-        // Draw all models assigned to this pipeline
-        for (u32 i = 0; i < m_ModelIndex; i++)
+    u32 VulkanRenderer::DrawGpuCulled(vk::CommandBuffer cmdBuffer, std::span<const CullingPhase> phases) const
+    {
+        u32 draws = 0;
+
+        // Each draw group only needs its index buffer and one indirect call per phase
+        for (u32 group = 0; group < GPU_CULLING_DRAW_GROUPS; group++)
         {
-            // Get model
-            const VulkanModel* model = m_Models.at(i).get();
+            if (m_GpuCulling->GetObjectCount(group) == 0)
+            {
+                continue;
+            }
 
-            // Check for pipeline
-            if (model->GetPipelineID() == pipelineID)
+            m_GeometryArena->BindIndexBuffer(cmdBuffer, (IndexFormat)group);
+            for (const CullingPhase phase : phases)
             {
-                // Bind and draw
-                model->Bind(cmdBuffer);
-                cmdBuffer.drawIndexed(model->GetIndexCount(), 1, 0, 0, 0);
+                m_GpuCulling->Draw(cmdBuffer, group, phase);
+                draws++;
+            }
+        }
 
-                // Save stats
-                m_RenderStats.DrawCalls++;
-                m_RenderStats.Models++;
-                m_RenderStats.Vertices += model->GetVerticeCount();
-                m_RenderStats.Indices += model->GetIndexCount();
+        return draws;
+    }
+
+    void VulkanRenderer::BuildDrawList(PipelineHandle pipelineHandle)
+    {
+        m_DrawList.clear();
+
+        // One draw per instance batch of a model assigned to this pipeline, the GPU takes care of them if it culls
+        for (const InstanceBatch& batch : m_GpuCulling ? std::span<const InstanceBatch>() : m_InstanceBatches)
+        {
+            // Models destroyed after submitting their instances are gone already
+            const Scope<VulkanModel>* resource = m_Models.Get(batch.Model);
+            if (resource == nullptr)
+            {
+                continue;
             }
+
+            const VulkanModel* model = resource->get();
+
+            // Check for pipeline, batches without visible instances don't need a draw
+            if (model->GetPipeline() != pipelineHandle || batch.VisibleCount == 0)
+            {
+                continue;
+            }
+
+            // Skip models until their geometry arrived instead of waiting for the transfer queue
+            if (!m_UploadBatcher->IsComplete(model->GetUploadTicket()))
+            {
+                m_RenderStats.PendingUploads++;
+                continue;
+            }
+
+            // Draw all visible instances at once
+            const MeshLod& lod = SelectLod(*model, batch.FirstTransform, batch.InstanceCount);
+            m_DrawList.push_back({ .IndexCount    = lod.IndexCount,
+                                   .InstanceCount = batch.VisibleCount,
+                                   .FirstIndex    = model->GetFirstIndex() + lod.IndexOffset,
+                                   .VertexOffset  = model->GetVertexOffset(),
+                                   .FirstInstance = batch.FirstInstance,
+                                   .Format        = model->GetIndexFormat() });
+
+            CountDraw(*model, lod, batch.VisibleCount);
+        }
+
+        // Single draws only need their transform pushed, they get culled here since no instance stream holds them
+        const Math::Frustum frustum(m_GlobalUniformData.Projection * m_GlobalUniformData.View);
+        for (const SingleDraw& draw : m_SingleDraws)
+        {
+            const Scope<VulkanModel>* resource = m_Models.Get(draw.Model);
+            if (resource == nullptr || (*resource)->GetPipeline() != pipelineHandle)
+            {
+                continue;
+            }
+
+            const VulkanModel* model = resource->get();
+
+            if (!frustum.IntersectsSphere(glm::vec3(draw.Sphere), draw.Sphere.w))
+            {
+                m_RenderStats.Culled++;
+                continue;
+            }
+
+            if (!m_UploadBatcher->IsComplete(model->GetUploadTicket()))
+            {
+                m_RenderStats.PendingUploads++;
+                continue;
+            }
+
+            const f32      surface = glm::distance(glm::vec3(draw.Sphere), m_CameraPosition) - draw.Sphere.w;
+            const MeshLod& lod     = SelectLod(*model, surface);
+            m_DrawList.push_back({ .IndexCount    = lod.IndexCount,
+                                   .InstanceCount = 1,
+                                   .FirstIndex    = model->GetFirstIndex() + lod.IndexOffset,
+                                   .VertexOffset  = model->GetVertexOffset(),
+                                   .FirstInstance = m_IdentityInstance,
+                                   .Format        = model->GetIndexFormat(),
+                                   .Transform     = &draw.Transform });
+
+            CountDraw(*model, lod, 1);
+            m_RenderStats.Visible++;
         }
+
+        // Grouping the index formats keeps every partition at no more than two index buffer binds
+        std::stable_sort(m_DrawList.begin(),
+                         m_DrawList.end(),
+                         [](const DrawCommand& a, const DrawCommand& b) { return a.Format < b.Format; });
     }
 
-    void VulkanRenderer::RenderUI(vk::CommandBuffer cmdBuffer, const Core::FrameTiming& frameTiming)
+    void VulkanRenderer::CountDraw(const VulkanModel& model, const MeshLod& lod, u32 instanceCount)
+    {
+        m_RenderStats.DrawCalls++;
+        m_RenderStats.Models++;
+        m_RenderStats.Instances += instanceCount;
+        m_RenderStats.Vertices += model.GetVerticeCount() * instanceCount;
+        m_RenderStats.Indices += lod.IndexCount * instanceCount;
+        m_RenderStats.LodSaved += (model.GetLods().front().IndexCount - lod.IndexCount) * instanceCount;
+        m_RenderStats.IndexBytes += (u64)lod.IndexCount * instanceCount * GetIndexSize(model.GetIndexFormat());
+
+        if (model.GetIndexFormat() == IndexFormat::eUint16)
+        {
+            m_RenderStats.Uint16Models++;
+        }
+        else
+        {
+            m_RenderStats.Uint32Models++;
+        }
+    }
+
+    u32 VulkanRenderer::RecordDraws(vk::CommandBuffer            cmdBuffer,
+                                    const VulkanPipeline&        pipeline,
+                                    std::span<const DrawCommand> draws) const
+    {
+        std::optional<IndexFormat> boundIndexFormat;
+        const glm::mat4*           pushedTransform = nullptr; // BindSceneState pushed the identity
+        u32                        binds           = 0;
+
+        for (const DrawCommand& draw : draws)
+        {
+            if (boundIndexFormat != draw.Format)
+            {
+                m_GeometryArena->BindIndexBuffer(cmdBuffer, draw.Format);
+                boundIndexFormat = draw.Format;
+                binds++;
+            }
+
+            if (pushedTransform != draw.Transform)
+            {
+                const glm::mat4 transform = draw.Transform ? *draw.Transform : glm::mat4(1.0f);
+                PushDrawConstants(cmdBuffer, pipeline.GetLayout(), transform);
+                pushedTransform = draw.Transform;
+            }
+
+            cmdBuffer.drawIndexed(
+                draw.IndexCount, draw.InstanceCount, draw.FirstIndex, draw.VertexOffset, draw.FirstInstance);
+        }
+
+        return binds;
+    }
+
+    vk::CommandBuffer VulkanRenderer::RecordUI(const Core::FrameTiming& frameTiming)
     {
         m_ImGuiLayer->BeginFrame();
 
-        m_ProfilerPanel->Render(frameTiming, m_RenderStats);
+        m_ProfilerPanel->Render(
+            frameTiming, m_RenderStats, m_GpuProfiler->GetTimings(), m_GpuProfiler->GetPipelineStatistics());
+
+        // ImGui sets its own viewport and scissor
+        const SwapchainProperties& properties = m_Swapchain->GetProperties();
+        const GpuScope             scope      = m_GpuProfiler->CreateScope("UI");
+        const GpuScope             statistics = m_GpuProfiler->CreateStatisticsScope("UI");
+        return m_CommandRecorder->Record({ .Color = properties.SurfaceFormat.format, .Depth = properties.DepthFormat },
+                                         1,
+                                         [this, scope, statistics](vk::CommandBuffer cmdBuffer, u32)
+                                         {
+                                             m_GpuProfiler->Begin(cmdBuffer, scope);
+                                             m_GpuProfiler->BeginStatistics(cmdBuffer, statistics);
+                                             m_ImGuiLayer->RenderFrame(cmdBuffer);
+                                             m_GpuProfiler->EndStatistics(cmdBuffer, statistics);
+                                             m_GpuProfiler->End(cmdBuffer, scope);
+                                         })
+            .front();
+    }
+
+    const MeshLod& VulkanRenderer::SelectLod(const VulkanModel& model, u32 firstTransform, u32 instanceCount) const
+    {
+        // All visible instances share one draw, so the closest bounding sphere decides the level for all of them
+        f32 surface = std::numeric_limits<f32>::max();
+        for (u32 i = firstTransform; i < firstTransform + instanceCount; i++)
+        {
+            if (Math::BoundingSpheres::IsVisible(m_InstanceVisibility, i))
+            {
+                const glm::vec4 sphere          = m_InstanceBounds.Get(i);
+                const f32       surfaceDistance = glm::distance(glm::vec3(sphere), m_CameraPosition) - sphere.w;
+                surface                         = std::min(surface, surfaceDistance);
+            }
+        }
+
+        return SelectLod(model, surface);
+    }
+
+    const MeshLod& VulkanRenderer::SelectLod(const VulkanModel& model, f32 surfaceDistance) const
+    {
+        const std::vector<MeshLod>& lods     = model.GetLods();
+        const f32                   distance = std::max(surfaceDistance, m_CameraNear);
+
+        // Coarsest level whose error stays below the threshold once projected onto the screen
+        for (size_t i = lods.size() - 1; i > 0; i--)
+        {
+            if (lods[i].Error * m_LodScale / distance <= LOD_ERROR_THRESHOLD)
+            {
+                return lods[i];
+            }
+        }
+
+        return lods.front();
+    }
 
-        m_ImGuiLayer->RenderFrame(cmdBuffer);
+    VulkanShader* VulkanRenderer::GetShader(ShaderHandle shader)
+    {
+        Scope<VulkanShader>* resource = m_Shaders.Get(shader);
+        ASSERT(resource != nullptr, "Shader handle '{}' is stale or invalid!", shader.Index);
+        return resource->get();
+    }
+
+    VulkanModel* VulkanRenderer::GetModel(ModelHandle model)
+    {
+        Scope<VulkanModel>* resource = m_Models.Get(model);
+        ASSERT(resource != nullptr, "Model handle '{}' is stale or invalid!", model.Index);
+        return resource->get();
+    }
+
+    VulkanPipeline* VulkanRenderer::GetPipeline(PipelineHandle pipeline)
+    {
+        Scope<VulkanPipeline>* resource = m_Pipelines.Get(pipeline);
+        ASSERT(resource != nullptr, "Pipeline handle '{}' is stale or invalid!", pipeline.Index);
+        return resource->get();
     }
 }
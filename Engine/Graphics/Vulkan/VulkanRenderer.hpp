@@ -1,20 +1,39 @@
 #pragma once
 
+#include "Core/ResourcePool.hpp"
 #include "Core/Timer.hpp"
 
 #include "Graphics/UI/ImGuiLayer.hpp"
 #include "Graphics/UI/ProfilerPanel.hpp"
 
+#include "Graphics/Vulkan/VulkanCommandRecorder.hpp"
 #include "Graphics/Vulkan/VulkanContext.hpp"
+#include "Graphics/Vulkan/VulkanFrameAllocator.hpp"
+#include "Graphics/Vulkan/VulkanGeometryArena.hpp"
 #include "Graphics/Vulkan/VulkanGlobalUniforms.hpp"
 #include "Graphics/Vulkan/VulkanGlobals.hpp"
+#include "Graphics/Vulkan/VulkanGpuCulling.hpp"
+#include "Graphics/Vulkan/VulkanGpuProfiler.hpp"
 #include "Graphics/Vulkan/VulkanModel.hpp"
 #include "Graphics/Vulkan/VulkanPipeline.hpp"
 #include "Graphics/Vulkan/VulkanRendererStructs.hpp"
 #include "Graphics/Vulkan/VulkanShader.hpp"
+#include "Graphics/Vulkan/VulkanUploadBatcher.hpp"
+
+#include "Math/BoundingSpheres.hpp"
+
+#include "Platform/FileWatcher.hpp"
+
+#include <array>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace Engine::Graphics
 {
+    using PipelineReadyCallback = std::function<void(PipelineHandle pipeline)>;
+
     class VulkanRenderer
     {
     public:
@@ -24,22 +43,124 @@ namespace Engine::Graphics
         VulkanRenderer(const VulkanRenderer&)            = delete;
         VulkanRenderer& operator=(const VulkanRenderer&) = delete;
 
-        [[nodiscard]] u32 LoadShader(vk::ShaderStageFlagBits stage, const std::filesystem::path& path);
-        [[nodiscard]] u32 CreateModel(const Mesh* mesh);
-        [[nodiscard]] u32 CreatePipeline(u32 vertexID, u32 fragmentID);
+        // Compiles the GLSL source unless the shader cache has it already. The source keeps being watched, edits
+        // recompile the shader and rebuild the pipelines using it (the old ones keep drawing until that finished).
+        [[nodiscard]] ShaderHandle LoadShader(vk::ShaderStageFlagBits      stage,
+                                              const std::filesystem::path& path,
+                                              std::vector<std::string>     defines = {});
+        [[nodiscard]] ModelHandle  CreateModel(const MeshView& mesh, VertexFormat format = VertexFormat::eFull);
+
+        // Returns right away, the pipeline compiles in the background and draws assigned to it get skipped until it's
+        // ready. 'onReady' gets called on the main thread by the first BeginFrame after the compilation finished.
+        [[nodiscard]] PipelineHandle CreatePipeline(ShaderHandle          vertex,
+                                                    ShaderHandle          fragment,
+                                                    VertexFormat          format  = VertexFormat::eFull,
+                                                    PipelineReadyCallback onReady = {});
+
+        [[nodiscard]] b8 IsPipelineReady(PipelineHandle pipeline);
+        void             WaitForPipeline(PipelineHandle pipeline);
+
+        // Handles become stale right away, the resources get released once no frame in flight uses them anymore
+        void DestroyShader(ShaderHandle shader);
+        void DestroyModel(ModelHandle model);
+        void DestroyPipeline(PipelineHandle pipeline);
+
+        void AssignModelToPipeline(ModelHandle model, PipelineHandle pipeline);
+
+        // Draws the model once per transform in the current frame, every call becomes a single instanced draw of the
+        // instances inside the view frustum. The transforms get copied right away, so only call it between a valid
+        // BeginFrame and DrawFrame.
+        void DrawInstances(ModelHandle model, std::span<const glm::mat4> transforms);
+
+        // Draws the model once with its transform in push constants, so nothing gets written into any buffer. Meant
+        // for single objects, many copies of a model are cheaper through DrawInstances. These draws are never GPU
+        // culled, they get frustum culled on the CPU instead. Only call it between a valid BeginFrame and DrawFrame.
+        void DrawModel(ModelHandle model, const glm::mat4& transform);
 
-        void AssignModelToPipeline(u32 modelID, u32 pipelineID);
+        // Switches to GPU-driven submission: every instance gets frustum culled and LOD selected by the compute
+        // shader, the survivors are drawn with one indirect call per index format. While the depth pre-pass runs they
+        // also get occlusion culled against a depth pyramid, which the second compute shader reduces the pre-pass
+        // depth into. Both shaders can be destroyed after.
+        void EnableGpuCulling(ShaderHandle cullShader, ShaderHandle pyramidShader);
 
-        [[nodiscard]] RenderPacket BeginFrame(u32 pipelineID);
+        // Lays down the scene's depth with the position only vertex shader first, so the main pass only shades the
+        // closest fragment of every pixel (eEqual depth test). All graphics pipelines get rebuilt with a pre-pass
+        // variant and keep drawing without one until that finished. The shader has to outlive the pre-pass, shader
+        // edits rebuild the pipelines again.
+        void EnableDepthPrepass(ShaderHandle depthShader);
+
+        [[nodiscard]] RenderPacket BeginFrame(PipelineHandle pipeline);
         void                       DrawFrame(RenderPacket renderPacket, const Core::FrameTiming& frameTiming);
 
         void WaitForDevice();
 
     private:
-        void SetDynamicStates(vk::CommandBuffer cmdBuffer, vk::Extent2D extent);
-        void UpdateGlobalUniforms(vk::Extent2D extent, u32 frameIndex, const Core::FrameTiming& frameTiming);
-        void RenderScene(vk::CommandBuffer cmdBuffer, u32 pipelineID, u32 frameIndex);
-        void RenderUI(vk::CommandBuffer cmdBuffer, const Core::FrameTiming& frameTiming);
+        // Draw of an instance batch or a single model, resolved on the main thread so partitions can be recorded
+        // without touching any renderer state
+        struct DrawCommand
+        {
+            u32              IndexCount    = 0;
+            u32              InstanceCount = 0;
+            u32              FirstIndex    = 0;
+            i32              VertexOffset  = 0;
+            u32              FirstInstance = 0;
+            IndexFormat      Format        = IndexFormat::eUint32;
+            const glm::mat4* Transform     = nullptr; // Pushed before the draw, identity if not set
+        };
+
+        void SetDynamicStates(vk::CommandBuffer cmdBuffer, vk::Extent2D extent) const;
+        void UpdatePendingPipelines();
+        void WaitForPipelineCompilations();
+        void ReloadChangedShaders();
+        void StreamInstances();
+        void CullScene(vk::CommandBuffer cmdBuffer, PipelineHandle pipelineHandle, u32 globalsOffset, b8 occlusion);
+        void BuildDrawList(PipelineHandle pipelineHandle);
+        void BindSceneState(vk::CommandBuffer     cmdBuffer,
+                            const VulkanPipeline& pipeline,
+                            ScenePass             pass,
+                            u32                   globalsOffset,
+                            vk::Extent2D          extent) const;
+
+        // Returns the number of indirect draws
+        [[nodiscard]] u32 DrawGpuCulled(vk::CommandBuffer cmdBuffer, std::span<const CullingPhase> phases) const;
+
+        void CountDraw(const VulkanModel& model, const MeshLod& lod, u32 instanceCount);
+
+        // Returns the number of index buffer binds
+        [[nodiscard]] u32 RecordDraws(vk::CommandBuffer            cmdBuffer,
+                                      const VulkanPipeline&        pipeline,
+                                      std::span<const DrawCommand> draws) const;
+
+        // Records and executes the depth-only scopes, with occlusion culling the late culling pass runs in between
+        void RenderDepthPrepass(const SwapchainFrame& frame,
+                                PipelineHandle        pipelineHandle,
+                                u32                   globalsOffset,
+                                b8                    occlusion);
+
+        // Secondary command buffers for the rendering scope of a pass, the draw list gets split across the job system.
+        // The draw list belongs to the early phase, GPU culled objects get drawn for every given phase.
+        [[nodiscard]] std::vector<vk::CommandBuffer> RecordScene(PipelineHandle                pipelineHandle,
+                                                                 ScenePass                     pass,
+                                                                 std::span<const CullingPhase> phases,
+                                                                 u32                           globalsOffset,
+                                                                 vk::Extent2D                  extent);
+        [[nodiscard]] vk::CommandBuffer              RecordUI(const Core::FrameTiming& frameTiming);
+
+        [[nodiscard]] Scope<VulkanPipeline> BuildPipeline(ShaderHandle vertex,
+                                                          ShaderHandle fragment,
+                                                          VertexFormat format);
+
+        // The replacement takes over the handle once it finished compiling
+        void RebuildPipeline(PipelineHandle pipeline, ShaderHandle vertex, ShaderHandle fragment, VertexFormat format);
+
+        [[nodiscard]] u32            UpdateGlobalUniforms(vk::Extent2D extent);
+        [[nodiscard]] const MeshLod& SelectLod(const VulkanModel& model, u32 firstTransform, u32 instanceCount) const;
+        [[nodiscard]] const MeshLod& SelectLod(const VulkanModel& model, f32 surfaceDistance) const;
+
+        // Assert on stale handles
+        [[nodiscard]] VulkanShader*   GetShader(ShaderHandle shader);
+        [[nodiscard]] VulkanModel*    GetModel(ModelHandle model);
+        [[nodiscard]] VulkanPipeline* GetPipeline(PipelineHandle pipeline);
 
         // Vulkan context, UI and swapchain shortcut for quick access
         Scope<VulkanContext> m_Context;
@@ -48,17 +169,107 @@ namespace Engine::Graphics
         VulkanSwapchain*     m_Swapchain = nullptr;
 
         // Uniform stuff
+        Scope<VulkanFrameAllocator> m_FrameAllocator;       // Backs the global uniforms
         Scope<VulkanGlobalUniforms> m_VulkanGlobalUniforms; // Should live longer than the pipeline
         GlobalUniformData           m_GlobalUniformData;
 
+        // Camera state needed to project simplification errors onto the screen
+        glm::vec3 m_CameraPosition = glm::vec3(0.0f);
+        f32       m_CameraNear     = 0.0f;
+        f32       m_LodScale       = 0.0f; // Pixels per model space unit at distance 1
+
+        // Batches all uploads into one transfer submission per frame (should outlive the geometry arena)
+        Scope<VulkanUploadBatcher> m_UploadBatcher;
+
+        // Shared vertex and index buffers of all models (should outlive the models)
+        Scope<VulkanGeometryArena> m_GeometryArena;
+
+        // Per-thread command pools for the secondary command buffers of the rendering scope
+        Scope<VulkanCommandRecorder> m_CommandRecorder;
+
+        // Timestamps of the passes, shown by the profiler panel
+        Scope<VulkanGpuProfiler> m_GpuProfiler;
+
+        // Only exists while GPU-driven submission is enabled
+        Scope<VulkanGpuCulling> m_GpuCulling;
+
+        // Invalid while the depth pre-pass is disabled, the pre-pass only runs once the scene pipeline has its variant
+        ShaderHandle m_DepthShader;
+        b8           m_DepthPrepassActive = false; // For the frame being recorded
+
         // Shader, Models, Pipelines
-        std::array<Scope<VulkanShader>, MAX_SHADER_COUNT>     m_Shaders;
-        std::array<Scope<VulkanModel>, MAX_MODEL_COUNT>       m_Models;
-        std::array<Scope<VulkanPipeline>, MAX_PIPELINE_COUNT> m_Pipelines;
+        Core::ResourcePool<Scope<VulkanShader>, VulkanShader>     m_Shaders;
+        Core::ResourcePool<Scope<VulkanModel>, VulkanModel>       m_Models;
+        Core::ResourcePool<Scope<VulkanPipeline>, VulkanPipeline> m_Pipelines;
+
+        // Destroyed resources wait here until the frame slot they were destroyed in comes around again, models also
+        // until their uploads completed
+        struct DeletionQueue
+        {
+            std::vector<Scope<VulkanShader>>   Shaders;
+            std::vector<Scope<VulkanModel>>    Models;
+            std::vector<Scope<VulkanPipeline>> Pipelines;
+        };
+
+        std::array<DeletionQueue, FRAMES_IN_FLIGHT> m_DeletionQueues;
+        u32                                         m_FrameIndex = 0;
+
+        // Pipelines still compiling whose creator wants to know when they're done
+        struct PendingPipeline
+        {
+            PipelineHandle        Pipeline;
+            PipelineReadyCallback OnReady;
+        };
+
+        std::vector<PendingPipeline> m_PendingPipelines;
+
+        // Shaders of every pipeline, so shader edits know which pipelines to rebuild
+        struct PipelineSource
+        {
+            PipelineHandle Pipeline;
+            ShaderHandle   Vertex;
+            ShaderHandle   Fragment;
+            VertexFormat   Format = VertexFormat::eFull;
+        };
+
+        // Rebuilt pipeline which takes over the handle once it finished compiling
+        struct ReloadingPipeline
+        {
+            PipelineHandle        Pipeline;
+            Scope<VulkanPipeline> Replacement;
+        };
+
+        std::vector<PipelineSource>    m_PipelineSources;
+        std::vector<ReloadingPipeline> m_ReloadingPipelines;
+        Scope<Platform::FileWatcher>   m_ShaderWatcher; // Sources of all loaded shaders
+
+        // Instances submitted for the current frame, their transforms get streamed into the frame allocator once the
+        // camera is known and (without GPU culling) only the ones inside the frustum make it
+        struct InstanceBatch
+        {
+            ModelHandle Model;
+            u32         FirstTransform = 0; // Index into m_InstanceTransforms and m_InstanceBounds
+            u32         InstanceCount  = 0;
+            u32         FirstInstance  = 0; // Instance index of the first streamed transform in the frame allocator
+            u32         VisibleCount   = 0; // Streamed transforms
+        };
+
+        std::vector<InstanceBatch> m_InstanceBatches;
+        std::vector<glm::mat4>     m_InstanceTransforms; // Dequantization already folded in
+        Math::BoundingSpheres      m_InstanceBounds;     // World space bounding sphere of every instance
+        std::vector<u8>            m_InstanceVisibility; // One mask per group of m_InstanceBounds
+
+        // Single models of the current frame, they all share one identity transform in the instance stream
+        struct SingleDraw
+        {
+            ModelHandle Model;
+            glm::mat4   Transform = glm::mat4(1.0f); // Dequantization already folded in
+            glm::vec4   Sphere    = glm::vec4(0.0f); // World space bounding sphere
+        };
 
-        u32 m_ShaderIndex   = 0;
-        u32 m_ModelIndex    = 0;
-        u32 m_PipelineIndex = 0;
+        std::vector<SingleDraw>  m_SingleDraws;
+        u32                      m_IdentityInstance = 0;
+        std::vector<DrawCommand> m_DrawList; // Draws of the current frame, sorted by index format
 
         RenderStats m_RenderStats;
     };
@@ -1,24 +1,80 @@
 #pragma once
 
+#include "Core/ResourcePool.hpp"
+
 #include "Graphics/Vulkan/VulkanSwapchainStructs.hpp"
 
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace Engine::Graphics
 {
+    class VulkanShader;
+    class VulkanModel;
+    class VulkanPipeline;
+
+    // Renderer resources are referenced through generational handles, which stay detectable after destruction
+    using ShaderHandle   = Core::Handle<VulkanShader>;
+    using ModelHandle    = Core::Handle<VulkanModel>;
+    using PipelineHandle = Core::Handle<VulkanPipeline>;
+
     struct RenderPacket
     {
         std::optional<SwapchainFrame> Frame;
-        u32                           PipelineID = 0;
+        PipelineHandle                Pipeline;
 
         [[nodiscard]] bool IsValid() const { return Frame.has_value(); }
     };
 
     struct RenderStats
     {
-        u32 DrawCalls = 0;
-        u32 Models    = 0;
-        u32 Vertices  = 0;
-        u32 Indices   = 0;
+        u32 DrawCalls          = 0;
+        u32 PrepassDraws       = 0; // Depth-only draws recorded by the depth pre-pass, not part of the draw calls
+        u32 BufferBinds        = 0; // Vertex and index buffer binds
+        u32 Models             = 0;
+        u32 Instances          = 0; // Instances drawn by all instanced draws
+        u32 Visible            = 0; // Instances inside the view frustum (CPU culling)
+        u32 Culled             = 0; // Instances outside the view frustum, never streamed or drawn (CPU culling)
+        u32 Vertices           = 0;
+        u32 Indices            = 0;
+        u32 LodSaved           = 0; // Indices skipped by drawing coarser levels of detail
+        u32 Uint16Models       = 0; // Models drawn with 16-bit indices
+        u32 Uint32Models       = 0; // Models drawn with 32-bit indices
+        u64 IndexBytes         = 0; // Index data fetched by all draws
+        u32 PendingUploads     = 0; // Models skipped because their geometry upload didn't complete yet
+        u32 CompilingPipelines = 0; // Pipelines still compiling in the background, their draws get skipped
+        u64 FrameBytes         = 0; // Uniform and storage data allocated from the frame allocator
+        u32 GpuObjects         = 0; // Objects handed to GPU culling (vertex and index stats only cover CPU draws)
+        u32 GpuVisible         = 0; // Objects which survived GPU culling, read back FRAMES_IN_FLIGHT frames late
+        u32 GpuOccluded        = 0; // Objects inside the frustum skipped by occlusion culling, read back just as late
+    };
+
+    // GPU time of a named scope, scopes recorded several times a frame add up
+    struct GpuPassTiming
+    {
+        std::string Name;
+        f64         Milliseconds = 0.0;
+    };
+
+    // Timestamps of a whole frame, read back FRAMES_IN_FLIGHT frames late
+    struct GpuTimings
+    {
+        std::vector<GpuPassTiming> Passes;                  // In the order they were first recorded
+        f64                        FrameMilliseconds = 0.0; // First to last command of the frame
+
+        [[nodiscard]] bool IsValid() const { return FrameMilliseconds > 0.0; }
+    };
+
+    // Pipeline statistics of a named pass, read back FRAMES_IN_FLIGHT frames late
+    struct GpuPassStatistics
+    {
+        std::string Name;
+        u64         InputVertices       = 0; // Fetched by the input assembly
+        u64         InputPrimitives     = 0;
+        u64         VertexInvocations   = 0; // Below the input vertices when shaded vertices got reused
+        u64         ClippingInvocations = 0; // Primitives entering the clipping stage
+        u64         ClippingPrimitives  = 0; // Primitives leaving it
+        u64         FragmentInvocations = 0;
     };
 }
@@ -1,7 +1,6 @@
 #include "VulkanShader.hpp"
 
 #include "Core/Types.hpp"
-#include "Core/Utility.hpp"
 
 #include "Debug/Log.hpp"
 
@@ -11,13 +10,11 @@ namespace Engine::Graphics
 {
     // ----- Public -----
 
-    VulkanShader::VulkanShader(const vk::Device&            device,
-                               vk::ShaderStageFlagBits      stage,
-                               const std::filesystem::path& path)
-        : m_Device(device), m_Stage(stage), m_StageString(vk::to_string(m_Stage))
+    VulkanShader::VulkanShader(const vk::Device& device, const ShaderSource& source, std::span<const u32> code)
+        : m_Device(device), m_Source(source), m_Reflection(ShaderReflection::Reflect(code, source.Stage)),
+          m_StageString(vk::to_string(m_Source.Stage))
     {
-        std::vector<char> code = Core::Utility::ReadFileAsBytes(path);
-        CreateShaderModule(std::move(code));
+        CreateShaderModule(code);
     }
 
     VulkanShader::~VulkanShader()
@@ -28,16 +25,16 @@ namespace Engine::Graphics
 
     [[nodiscard]] vk::PipelineShaderStageCreateInfo VulkanShader::GetPipelineShaderStageCreateInfo() const
     {
-        return { .stage = m_Stage, .module = m_Module, .pName = "main" };
+        return { .stage = m_Source.Stage, .module = m_Module, .pName = "main" };
     }
 
     // ----- Private -----
 
-    void VulkanShader::CreateShaderModule(std::vector<char>&& code)
+    void VulkanShader::CreateShaderModule(std::span<const u32> code)
     {
-        const vk::ShaderModuleCreateInfo shaderCreateInfo{ .codeSize = code.size(), .pCode = (u32*)code.data() };
+        const vk::ShaderModuleCreateInfo shaderCreateInfo{ .codeSize = code.size_bytes(), .pCode = code.data() };
 
         VK_VERIFY(m_Device.createShaderModule(&shaderCreateInfo, nullptr, &m_Module));
-        LOG_INFO("Created shader module ({}) ...", m_StageString);
+        LOG_INFO("Created shader module '{}' ... ({})", m_Source.Path.string(), m_StageString);
     }
 }
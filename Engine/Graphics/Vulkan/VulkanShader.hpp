@@ -1,28 +1,37 @@
 #pragma once
 
+#include "Graphics/Import/ShaderCache.hpp"
+
+#include "Graphics/Resources/ShaderReflection.hpp"
+
 #include <vulkan/vulkan.hpp>
 
-#include <filesystem>
+#include <span>
 
 namespace Engine::Graphics
 {
+    // Shader module created from SPIR-V, keeps its source around so it can be recompiled when the source changes.
+    // The resource interface gets reflected from the code, pipeline layouts get built from it.
     class VulkanShader
     {
     public:
-        VulkanShader(const vk::Device& device, vk::ShaderStageFlagBits stage, const std::filesystem::path& path);
+        VulkanShader(const vk::Device& device, const ShaderSource& source, std::span<const u32> code);
         ~VulkanShader();
 
         VulkanShader(const VulkanShader&)            = delete;
         VulkanShader& operator=(const VulkanShader&) = delete;
 
         [[nodiscard]] vk::PipelineShaderStageCreateInfo GetPipelineShaderStageCreateInfo() const;
+        [[nodiscard]] const ShaderSource&               GetSource() const { return m_Source; }
+        [[nodiscard]] const ShaderReflection&           GetReflection() const { return m_Reflection; }
 
     private:
-        void CreateShaderModule(std::vector<char>&& code);
+        void CreateShaderModule(std::span<const u32> code);
 
-        vk::Device              m_Device = nullptr;
-        vk::ShaderModule        m_Module = nullptr;
-        vk::ShaderStageFlagBits m_Stage;
-        std::string             m_StageString;
+        vk::Device       m_Device = nullptr;
+        vk::ShaderModule m_Module = nullptr;
+        ShaderSource     m_Source;
+        ShaderReflection m_Reflection;
+        std::string      m_StageString;
     };
 }
@@ -7,6 +7,8 @@
 
 #include "Platform/Window.hpp"
 
+#include <array>
+
 namespace
 {
     // ----- Internal -----
@@ -39,6 +41,9 @@ namespace
         // Save current transform
         properties.Transform = swapchainSupport.Capabilities.currentTransform;
 
+        // Depth image format, stays the same across recreations
+        properties.DepthFormat = Engine::Graphics::VulkanSwapchainUtils::ChooseDepthFormat(physicalDevice->GetHandle());
+
         return properties;
     }
 }
@@ -51,10 +56,11 @@ namespace Engine::Graphics
         : m_Device(device), m_Surface(surface)
     {
         m_Properties = GetSwapchainProperties(device->GetPhysicalDevice());
-        CreateCommandPools();
+        CreateCommandPool();
         InitializeFrames();
         CreateSwapchain();
         CreateImages();
+        CreateDepthImage();
     }
 
     VulkanSwapchain::~VulkanSwapchain()
@@ -62,6 +68,7 @@ namespace Engine::Graphics
         LOG_INFO("VulkanSwapchain::Destructor() ...");
 
         DestroyImages();
+        DestroyDepthImage();
 
         // Destroy sync objects
         for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++)
@@ -70,46 +77,13 @@ namespace Engine::Graphics
             m_Device->GetHandle().destroyFence(m_FrameResources.at(i).InFlight);
         }
 
-        // Destroy command pools
+        // Destroy command pool
         m_Device->GetHandle().destroyCommandPool(m_GraphicsCommandPool);
-        m_Device->GetHandle().destroyCommandPool(m_TransferCommandPool);
 
         // Destroy swapchain
         m_Device->GetHandle().destroySwapchainKHR(m_CurrentSwapchain);
     }
 
-    vk::CommandBuffer VulkanSwapchain::CreateTransferCommandBuffer()
-    {
-        // Allocate command buffer
-        const vk::CommandBufferAllocateInfo allocateInfo{ .commandPool        = m_TransferCommandPool,
-                                                          .level              = vk::CommandBufferLevel::ePrimary,
-                                                          .commandBufferCount = 1 };
-        auto [res, commandBuffer] = m_Device->GetHandle().allocateCommandBuffers(allocateInfo);
-        VK_VERIFY(res);
-        ASSERT(!commandBuffer.empty(), "Allocated command buffer vector was empty!");
-
-        // Begin command buffer recording
-        const vk::CommandBufferBeginInfo beginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
-        VK_VERIFY(commandBuffer.at(0).begin(&beginInfo));
-
-        return commandBuffer.at(0);
-    }
-
-    void VulkanSwapchain::SubmitTransferCommandBuffer(vk::CommandBuffer commandBuffer)
-    {
-        // End command buffer recording
-        VK_VERIFY(commandBuffer.end());
-
-        // Immediately submit recorded commands
-        const vk::SubmitInfo submitInfo{ .commandBufferCount = 1, .pCommandBuffers = &commandBuffer };
-        const vk::Queue      transferQueue = m_Device->GetTransferQueue();
-        VK_VERIFY(transferQueue.submit(1, &submitInfo, nullptr));
-        VK_VERIFY(transferQueue.waitIdle());
-
-        // Clean up command buffer
-        m_Device->GetHandle().freeCommandBuffers(m_TransferCommandPool, 1, &commandBuffer);
-    }
-
     [[nodiscard]] std::optional<SwapchainFrame> VulkanSwapchain::BeginFrame()
     {
         // Get current frame resources
@@ -146,16 +120,72 @@ namespace Engine::Graphics
                                .Extent     = m_Properties.Extent };
     }
 
-    void VulkanSwapchain::BeginRendering(const SwapchainFrame& frame, glm::vec4 clearColor)
+    void VulkanSwapchain::BeginRecording(const SwapchainFrame& frame)
+    {
+        // Start command buffer recording
+        const vk::CommandBufferBeginInfo cmdBeginInfo{};
+        VK_VERIFY(frame.Resources->CommandBuffer.begin(&cmdBeginInfo));
+    }
+
+    void VulkanSwapchain::EndRecording(const SwapchainFrame& frame)
+    {
+        // End command buffer recording
+        VK_VERIFY(frame.Resources->CommandBuffer.end());
+    }
+
+    void VulkanSwapchain::BeginDepthPrepass(const SwapchainFrame& frame,
+                                            vk::RenderingFlags    renderingFlags,
+                                            vk::AttachmentLoadOp  depthLoadOp)
+    {
+        const vk::CommandBuffer cmdBuffer = frame.Resources->CommandBuffer;
+
+        // Loading continues an earlier pre-pass of this frame, which left the image ready for rendering
+        if (depthLoadOp == vk::AttachmentLoadOp::eClear)
+        {
+            DiscardDepthImage(cmdBuffer);
+        }
+
+        const vk::RenderingAttachmentInfo depthAttachment{ .imageView   = m_DepthView,
+                                                           .imageLayout = vk::ImageLayout::eDepthAttachmentOptimal,
+                                                           .loadOp      = depthLoadOp,
+                                                           .storeOp     = vk::AttachmentStoreOp::eStore,
+                                                           .clearValue  = { .depthStencil = { .depth = 1.0f } } };
+
+        const vk::RenderingInfo renderingInfo{ .flags      = renderingFlags,
+                                               .renderArea = { .offset = { .x = 0, .y = 0 }, .extent = frame.Extent },
+                                               .layerCount = 1,
+                                               .colorAttachmentCount = 0,
+                                               .pDepthAttachment     = &depthAttachment };
+
+        cmdBuffer.beginRendering(&renderingInfo);
+    }
+
+    void VulkanSwapchain::EndDepthPrepass(const SwapchainFrame& frame)
+    {
+        const vk::CommandBuffer cmdBuffer = frame.Resources->CommandBuffer;
+        cmdBuffer.endRendering();
+
+        // The main pass tests against the finished depth
+        VulkanSwapchainUtils::TransitionImageLayout(cmdBuffer,
+                                                    m_DepthImage.Image,
+                                                    vk::ImageLayout::eDepthAttachmentOptimal,
+                                                    vk::ImageLayout::eDepthAttachmentOptimal,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentRead,
+                                                    vk::PipelineStageFlagBits2::eLateFragmentTests,
+                                                    vk::PipelineStageFlagBits2::eEarlyFragmentTests,
+                                                    vk::ImageAspectFlagBits::eDepth);
+    }
+
+    void VulkanSwapchain::BeginRendering(const SwapchainFrame& frame,
+                                         glm::vec4             clearColor,
+                                         vk::RenderingFlags    renderingFlags,
+                                         vk::AttachmentLoadOp  depthLoadOp)
     {
         // Grab shortcut handles to current frame data
         const vk::CommandBuffer cmdBuffer = frame.Resources->CommandBuffer;
         const SwapchainImage    image     = m_Images.at(frame.ImageIndex);
 
-        // Start command buffer recording
-        const vk::CommandBufferBeginInfo cmdBeginInfo{};
-        VK_VERIFY(cmdBuffer.begin(&cmdBeginInfo));
-
         // Transition image layout from undefined to color
         VulkanSwapchainUtils::TransitionImageLayout(cmdBuffer,
                                                     image.Image,
@@ -164,7 +194,14 @@ namespace Engine::Graphics
                                                     vk::AccessFlagBits2::eNone,
                                                     vk::AccessFlagBits2::eColorAttachmentWrite,
                                                     vk::PipelineStageFlagBits2::eTopOfPipe,
-                                                    vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+                                                    vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                                    vk::ImageAspectFlagBits::eColor);
+
+        // A pre-pass already transitioned and filled the depth image
+        if (depthLoadOp == vk::AttachmentLoadOp::eClear)
+        {
+            DiscardDepthImage(cmdBuffer);
+        }
 
         // Set up clear value
         const vk::ClearValue clearValue{ .color = { { { clearColor.x, clearColor.y, clearColor.z, clearColor.a } } } };
@@ -176,11 +213,20 @@ namespace Engine::Graphics
                                                            .storeOp     = vk::AttachmentStoreOp::eStore,
                                                            .clearValue  = clearValue };
 
+        // Nothing reads the depth after the frame
+        const vk::RenderingAttachmentInfo depthAttachment{ .imageView   = m_DepthView,
+                                                           .imageLayout = vk::ImageLayout::eDepthAttachmentOptimal,
+                                                           .loadOp      = depthLoadOp,
+                                                           .storeOp     = vk::AttachmentStoreOp::eDontCare,
+                                                           .clearValue  = { .depthStencil = { .depth = 1.0f } } };
+
         // Begin rendering
-        const vk::RenderingInfo renderingInfo{ .renderArea = { .offset = { .x = 0, .y = 0 }, .extent = frame.Extent },
+        const vk::RenderingInfo renderingInfo{ .flags      = renderingFlags,
+                                               .renderArea = { .offset = { .x = 0, .y = 0 }, .extent = frame.Extent },
                                                .layerCount = 1,
                                                .colorAttachmentCount = GLOBAL_COLOR_ATTACHMENT_COUNT,
-                                               .pColorAttachments    = &colorAttachment };
+                                               .pColorAttachments    = &colorAttachment,
+                                               .pDepthAttachment     = &depthAttachment };
 
         cmdBuffer.beginRendering(&renderingInfo);
     }
@@ -202,25 +248,37 @@ namespace Engine::Graphics
                                                     vk::AccessFlagBits2::eColorAttachmentWrite,
                                                     vk::AccessFlagBits2::eNone,
                                                     vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-                                                    vk::PipelineStageFlagBits2::eBottomOfPipe);
-
-        // End command buffer recording
-        VK_VERIFY(cmdBuffer.end());
+                                                    vk::PipelineStageFlagBits2::eBottomOfPipe,
+                                                    vk::ImageAspectFlagBits::eColor);
     }
 
-    void VulkanSwapchain::SubmitAndPresent(const SwapchainFrame& frame)
+    void VulkanSwapchain::SubmitAndPresent(const SwapchainFrame& frame, const std::optional<TimelineWait>& timelineWait)
     {
         // Grab shortcut handles to current frame data
         const vk::CommandBuffer cmdBuffer = frame.Resources->CommandBuffer;
         const SwapchainImage    image     = m_Images.at(frame.ImageIndex);
 
-        const vk::PipelineStageFlags waitStage{ vk::PipelineStageFlagBits::eColorAttachmentOutput };
+        // Always wait for the acquired image, optionally for a timeline value too (the value of binary ones is ignored)
+        const u32 waitCount = timelineWait ? 2 : 1;
+
+        const std::array<vk::Semaphore, 2> waitSemaphores = {
+            frame.Resources->ImageAvailable, timelineWait ? timelineWait->Semaphore : nullptr
+        };
+        const std::array<vk::PipelineStageFlags, 2> waitStages = {
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            timelineWait ? timelineWait->Stage : vk::PipelineStageFlags{}
+        };
+        const std::array<u64, 2> waitValues = { 0, timelineWait ? timelineWait->Value : 0 };
+
+        const vk::TimelineSemaphoreSubmitInfo timelineInfo{ .waitSemaphoreValueCount = waitCount,
+                                                            .pWaitSemaphoreValues    = waitValues.data() };
 
         // Create submit info
         const vk::SubmitInfo submitInfo{
-            .waitSemaphoreCount   = 1,
-            .pWaitSemaphores      = &frame.Resources->ImageAvailable, // On which semaphore to wait
-            .pWaitDstStageMask    = &waitStage,
+            .pNext                = &timelineInfo,
+            .waitSemaphoreCount   = waitCount,
+            .pWaitSemaphores      = waitSemaphores.data(), // On which semaphores to wait
+            .pWaitDstStageMask    = waitStages.data(),
             .commandBufferCount   = 1,
             .pCommandBuffers      = &cmdBuffer,
             .signalSemaphoreCount = 1,
@@ -312,6 +370,9 @@ namespace Engine::Graphics
         m_Properties = GetSwapchainProperties(m_Device->GetPhysicalDevice());
         CreateSwapchain();
         CreateImages();
+
+        DestroyDepthImage();
+        CreateDepthImage();
     }
 
     void VulkanSwapchain::CreateImages()
@@ -349,30 +410,65 @@ namespace Engine::Graphics
         LOG_INFO("Created {} swapchain image view(s) with render-finished semaphore(s) ...", m_Images.size());
     }
 
-    void VulkanSwapchain::CreateCommandPools()
+    void VulkanSwapchain::CreateDepthImage()
     {
-        // Create graphics pool
-        {
-            const vk::CommandPoolCreateInfo graphicsPoolInfo{ .flags =
-                                                                  vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-                                                              .queueFamilyIndex = m_Device->GetGraphicsQueueFamily() };
-            auto [res, pool] = m_Device->GetHandle().createCommandPool(graphicsPoolInfo);
-            VK_VERIFY(res);
-            m_GraphicsCommandPool = pool;
-        }
+        const ImageSpecification spec{ .Extent          = m_Properties.Extent,
+                                       .Format          = m_Properties.DepthFormat,
+                                       .ImageUsageFlags = vk::ImageUsageFlagBits::eDepthStencilAttachment
+                                                          | vk::ImageUsageFlagBits::eSampled,
+                                       .MemoryUsage     = MemoryUsage::eAutoPreferDevice };
+        m_DepthImage = VulkanAllocator::AllocateImage(spec);
+
+        const vk::ImageViewCreateInfo viewCreateInfo = { .image            = m_DepthImage.Image,
+                                                         .viewType         = vk::ImageViewType::e2D,
+                                                         .format           = m_Properties.DepthFormat,
+                                                         .subresourceRange = { .aspectMask =
+                                                                                   vk::ImageAspectFlagBits::eDepth,
+                                                                               .baseMipLevel   = 0,
+                                                                               .levelCount     = 1,
+                                                                               .baseArrayLayer = 0,
+                                                                               .layerCount     = 1 } };
+        VK_VERIFY(m_Device->GetHandle().createImageView(&viewCreateInfo, nullptr, &m_DepthView));
+
+        LOG_INFO("Created depth image ... ({}x{}, {})",
+                 m_Properties.Extent.width,
+                 m_Properties.Extent.height,
+                 vk::to_string(m_Properties.DepthFormat));
+    }
 
-        // Create transfer pool
-        {
-            const vk::CommandPoolCreateInfo transferPoolInfo{
-                .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-                .queueFamilyIndex = m_Device->GetTransferQueueFamily()
-            };
-            auto [res, pool] = m_Device->GetHandle().createCommandPool(transferPoolInfo);
-            VK_VERIFY(res);
-            m_TransferCommandPool = pool;
-        }
+    void VulkanSwapchain::DestroyDepthImage()
+    {
+        m_Device->GetHandle().destroyImageView(m_DepthView);
+        VulkanAllocator::DestroyImage(m_DepthImage);
+
+        m_DepthView  = nullptr;
+        m_DepthImage = {};
+    }
+
+    void VulkanSwapchain::DiscardDepthImage(vk::CommandBuffer cmdBuffer) const
+    {
+        // Waits for the depth tests of earlier frames, which share the image
+        VulkanSwapchainUtils::TransitionImageLayout(cmdBuffer,
+                                                    m_DepthImage.Image,
+                                                    vk::ImageLayout::eUndefined,
+                                                    vk::ImageLayout::eDepthAttachmentOptimal,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentRead
+                                                        | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                                                    vk::PipelineStageFlagBits2::eLateFragmentTests,
+                                                    vk::PipelineStageFlagBits2::eEarlyFragmentTests
+                                                        | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                                                    vk::ImageAspectFlagBits::eDepth);
+    }
+
+    void VulkanSwapchain::CreateCommandPool()
+    {
+        // Transfer command buffers are owned by the upload batcher
+        const vk::CommandPoolCreateInfo graphicsPoolInfo{ .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                          .queueFamilyIndex = m_Device->GetGraphicsQueueFamily() };
+        VK_VERIFY(m_Device->GetHandle().createCommandPool(&graphicsPoolInfo, nullptr, &m_GraphicsCommandPool));
 
-        LOG_INFO("Created command pools for graphics and transfer ...");
+        LOG_INFO("Created command pool for graphics ...");
     }
 
     void VulkanSwapchain::InitializeFrames()
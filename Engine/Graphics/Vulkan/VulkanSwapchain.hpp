@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
 #include "Graphics/Vulkan/VulkanDevice.hpp"
 #include "Graphics/Vulkan/VulkanGlobals.hpp"
 #include "Graphics/Vulkan/VulkanSwapchainStructs.hpp"
@@ -10,6 +11,8 @@
 
 namespace Engine::Graphics
 {
+    // Besides the presentable images the swapchain owns the depth image all frames render into. It gets recreated
+    // along with them, frames in flight share it since every frame clears it first.
     class VulkanSwapchain
     {
     public:
@@ -24,21 +27,42 @@ namespace Engine::Graphics
 
         [[nodiscard]] u32 GetImageCount() const { return m_Images.size(); }
 
-        [[nodiscard]] vk::CommandBuffer CreateTransferCommandBuffer();
-        void                            SubmitTransferCommandBuffer(vk::CommandBuffer commandBuffer);
+        // Recreated along with the swapchain, compare the view to notice
+        [[nodiscard]] vk::Image     GetDepthImage() const { return m_DepthImage.Image; }
+        [[nodiscard]] vk::ImageView GetDepthView() const { return m_DepthView; }
 
         [[nodiscard]] std::optional<SwapchainFrame> BeginFrame();
 
-        void BeginRendering(const SwapchainFrame& frame, glm::vec4 clearColor = { 1.0f, 1.0f, 1.0f, 1.0f });
+        // Work outside of the rendering scope (e.g. compute passes) goes between these and the rendering calls
+        void BeginRecording(const SwapchainFrame& frame);
+        void EndRecording(const SwapchainFrame& frame);
+
+        // Depth only rendering scope which clears the depth image (or adds to it with eLoad), a following
+        // BeginRendering can load it
+        void BeginDepthPrepass(const SwapchainFrame& frame,
+                               vk::RenderingFlags    renderingFlags = {},
+                               vk::AttachmentLoadOp  depthLoadOp    = vk::AttachmentLoadOp::eClear);
+        void EndDepthPrepass(const SwapchainFrame& frame);
+
+        // Pass eContentsSecondaryCommandBuffers if the scope only executes secondary command buffers and eLoad to keep
+        // the depth of a pre-pass
+        void BeginRendering(const SwapchainFrame& frame,
+                            glm::vec4             clearColor     = { 1.0f, 1.0f, 1.0f, 1.0f },
+                            vk::RenderingFlags    renderingFlags = {},
+                            vk::AttachmentLoadOp  depthLoadOp    = vk::AttachmentLoadOp::eClear);
         void EndRendering(const SwapchainFrame& frame);
-        void SubmitAndPresent(const SwapchainFrame& frame);
+        void SubmitAndPresent(const SwapchainFrame&              frame,
+                              const std::optional<TimelineWait>& timelineWait = std::nullopt);
 
     private:
         void CreateSwapchain();
         void RecreateSwapchain();
         void CreateImages();
         void DestroyImages();
-        void CreateCommandPools();
+        void CreateDepthImage();
+        void DestroyDepthImage();
+        void DiscardDepthImage(vk::CommandBuffer cmdBuffer) const; // Ready for rendering, old contents get dropped
+        void CreateCommandPool();
         void InitializeFrames();
         void AdvanceFrameCount();
 
@@ -54,11 +78,14 @@ namespace Engine::Graphics
 
         // Command pools
         vk::CommandPool m_GraphicsCommandPool;
-        vk::CommandPool m_TransferCommandPool;
 
         // Swapchain images
         std::vector<SwapchainImage> m_Images;
 
+        // Depth attachment matching the swapchain extent
+        ImageAllocation m_DepthImage = {};
+        vk::ImageView   m_DepthView  = nullptr;
+
         // Frames
         std::array<VulkanFrameResources, FRAMES_IN_FLIGHT> m_FrameResources;
 
@@ -27,6 +27,7 @@ namespace Engine::Graphics
                                                           .colorSpace = vk::ColorSpaceKHR::eSrgbNonlinear };
         vk::PresentModeKHR              PresentMode   = vk::PresentModeKHR::eFifo;
         vk::SurfaceTransformFlagBitsKHR Transform     = vk::SurfaceTransformFlagBitsKHR::eIdentity;
+        vk::Format                      DepthFormat   = vk::Format::eUndefined;
 
         u32 MinImageCount = 0;
     };
@@ -60,6 +61,14 @@ namespace Engine::Graphics
         vk::Fence InFlight = nullptr;
     };
 
+    // Additional wait of a frame submission on a timeline semaphore, e.g. for uploads from the transfer queue
+    struct TimelineWait
+    {
+        vk::Semaphore          Semaphore = nullptr;
+        u64                    Value     = 0;
+        vk::PipelineStageFlags Stage     = vk::PipelineStageFlagBits::eVertexInput;
+    };
+
     // Transient frame context returned after acquiring a swapchain image.
     // Combines the current frame-in-flight resources with the acquired image index.
     // Valid only for the frame in which it was returned.
@@ -4,6 +4,8 @@
 
 #include "Platform/Window.hpp"
 
+#include <array>
+
 namespace Engine::Graphics
 {
     vk::Extent2D VulkanSwapchainUtils::ChooseExtent(vk::SurfaceCapabilitiesKHR capabilities)
@@ -57,6 +59,29 @@ namespace Engine::Graphics
         return vk::PresentModeKHR::eFifo;
     }
 
+    vk::Format VulkanSwapchainUtils::ChooseDepthFormat(const vk::PhysicalDevice& physicalDevice)
+    {
+        // Depth only formats, no stencil aspect to take care of. D16 is guaranteed to support depth attachments and
+        // sampling (the depth pyramid reads the depth image).
+        constexpr vk::FormatFeatureFlags features =
+            vk::FormatFeatureFlagBits::eDepthStencilAttachment | vk::FormatFeatureFlagBits::eSampledImage;
+
+        constexpr std::array<vk::Format, 3> candidates = { vk::Format::eD32Sfloat,
+                                                           vk::Format::eX8D24UnormPack32,
+                                                           vk::Format::eD16Unorm };
+
+        for (const vk::Format format : candidates)
+        {
+            const vk::FormatProperties properties = physicalDevice.getFormatProperties(format);
+            if ((properties.optimalTilingFeatures & features) == features)
+            {
+                return format;
+            }
+        }
+
+        return vk::Format::eD16Unorm;
+    }
+
     // Copied from Khronos 'hello_triangle_1_3.cpp' example
     void VulkanSwapchainUtils::TransitionImageLayout(vk::CommandBuffer       cmd,
                                                      vk::Image               image,
@@ -65,7 +90,8 @@ namespace Engine::Graphics
                                                      vk::AccessFlags2        srcAccessMask,
                                                      vk::AccessFlags2        dstAccessMask,
                                                      vk::PipelineStageFlags2 srcStage,
-                                                     vk::PipelineStageFlags2 dstStage)
+                                                     vk::PipelineStageFlags2 dstStage,
+                                                     vk::ImageAspectFlags    aspectMask)
     {
         // Initialize the VkImageMemoryBarrier2 structure
         const vk::ImageMemoryBarrier2 imageMemoryBarrier
@@ -90,11 +116,11 @@ namespace Engine::Graphics
             // Define the subresource range (which parts of the image are affected)
             .subresourceRange =
             {
-                .aspectMask     = vk::ImageAspectFlagBits::eColor, // Affects the color aspect of the image
-                .baseMipLevel   = 0,                               // Start at mip level 0
-                .levelCount     = 1,                               // Number of mip levels affected
-                .baseArrayLayer = 0,                               // Start at array layer 0
-                .layerCount     = 1                                // Number of array layers affected
+                .aspectMask     = aspectMask, // Color or depth aspect of the image
+                .baseMipLevel   = 0,          // Start at mip level 0
+                .levelCount     = 1,          // Number of mip levels affected
+                .baseArrayLayer = 0,          // Start at array layer 0
+                .layerCount     = 1           // Number of array layers affected
             }
         };
 
@@ -12,6 +12,7 @@ namespace Engine::Graphics
         static vk::Extent2D         ChooseExtent(vk::SurfaceCapabilitiesKHR capabilities);
         static vk::SurfaceFormatKHR ChooseSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& surfaceFormats);
         static vk::PresentModeKHR   ChoosePresentMode(const std::vector<vk::PresentModeKHR>& presentModes);
+        static vk::Format           ChooseDepthFormat(const vk::PhysicalDevice& physicalDevice);
         static void                 TransitionImageLayout(vk::CommandBuffer       cmd,
                                                           vk::Image               image,
                                                           vk::ImageLayout         oldLayout,
@@ -19,6 +20,7 @@ namespace Engine::Graphics
                                                           vk::AccessFlags2        srcAccessMask,
                                                           vk::AccessFlags2        dstAccessMask,
                                                           vk::PipelineStageFlags2 srcStage,
-                                                          vk::PipelineStageFlags2 dstStage);
+                                                          vk::PipelineStageFlags2 dstStage,
+                                                          vk::ImageAspectFlags    aspectMask);
     };
 }
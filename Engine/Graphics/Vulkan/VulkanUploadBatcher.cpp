@@ -0,0 +1,267 @@
+#include "VulkanUploadBatcher.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#include "Graphics/Vulkan/VulkanAssert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+    // ----- Internal -----
+
+    // Buffer copies don't require any alignment, this just keeps the staging writes friendly to memcpy
+    constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+}
+
+namespace Engine::Graphics
+{
+    // ----- Public -----
+
+    VulkanUploadBatcher::VulkanUploadBatcher(const VulkanDevice* device, vk::DeviceSize stagingCapacity)
+        : m_Device(device), m_StagingRing(stagingCapacity)
+    {
+        // Create persistently mapped staging ring
+        const BufferSpecification stagingSpec{ .Size               = stagingCapacity,
+                                               .BufferUsageFlags   = vk::BufferUsageFlagBits::eTransferSrc,
+                                               .MemoryUsage        = MemoryUsage::eCPUOnly,
+                                               .MemoryFlags        = vk::MemoryPropertyFlagBits::eHostVisible
+                                                                     | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                               .PersistentlyMapped = true };
+        m_StagingBufferAlloc = VulkanAllocator::AllocateBuffer(stagingSpec);
+        m_StagingData        = (u8*)m_StagingBufferAlloc.MappedData;
+
+        // Create transfer pool
+        const vk::CommandPoolCreateInfo poolInfo{
+            .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+            .queueFamilyIndex = m_Device->GetTransferQueueFamily()
+        };
+        VK_VERIFY(m_Device->GetHandle().createCommandPool(&poolInfo, nullptr, &m_CommandPool));
+
+        // Create timeline semaphore, every submission signals the next value
+        const vk::SemaphoreTypeCreateInfo typeInfo{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+        const vk::SemaphoreCreateInfo     semaphoreInfo{ .pNext = &typeInfo };
+        VK_VERIFY(m_Device->GetHandle().createSemaphore(&semaphoreInfo, nullptr, &m_Timeline));
+
+        LOG_INFO("Created upload batcher ... (Staging ring: {})", Core::Utility::BytesToString(stagingCapacity));
+    }
+
+    VulkanUploadBatcher::~VulkanUploadBatcher()
+    {
+        LOG_INFO("VulkanUploadBatcher::Destructor() ...");
+
+        if (!m_PendingCopies.empty())
+        {
+            LOG_WARN("Dropping {} upload(s) which never got flushed ...", m_PendingCopies.size());
+        }
+
+        // Staging memory and command buffers might still be in use
+        WaitForValue(m_SubmittedValue);
+
+        for (const auto& batch : m_InFlightBatches)
+        {
+            m_FreeCommandBuffers.push_back(batch.CommandBuffer);
+        }
+
+        if (!m_FreeCommandBuffers.empty())
+        {
+            m_Device->GetHandle().freeCommandBuffers(
+                m_CommandPool, (u32)m_FreeCommandBuffers.size(), m_FreeCommandBuffers.data());
+        }
+
+        m_Device->GetHandle().destroyCommandPool(m_CommandPool);
+        m_Device->GetHandle().destroySemaphore(m_Timeline);
+
+        VulkanAllocator::DestroyBuffer(m_StagingBufferAlloc);
+    }
+
+    UploadTicket VulkanUploadBatcher::Upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, std::span<const u8> data)
+    {
+        ASSERT(!data.empty(), "Can't upload empty data!");
+
+        // Data larger than the ring gets split up, every chunk is its own copy region
+        for (vk::DeviceSize offset = 0; offset < data.size();)
+        {
+            const vk::DeviceSize        size    = std::min(data.size() - offset, m_StagingRing.GetCapacity());
+            const Core::RangeAllocation staging = AllocateStaging(size);
+
+            std::memcpy(m_StagingData + staging.Offset, data.data() + offset, size);
+            m_PendingCopies.push_back(
+                { .DstBuffer = dstBuffer,
+                  .Region    = { .srcOffset = staging.Offset, .dstOffset = dstOffset + offset, .size = size } });
+
+            offset += size;
+        }
+
+        // Copies get signaled by the next submission
+        return { .Value = m_SubmittedValue + 1 };
+    }
+
+    void VulkanUploadBatcher::Flush()
+    {
+        Reclaim();
+
+        if (m_PendingCopies.empty())
+        {
+            return;
+        }
+
+        // Group the copies by destination, so every buffer only needs a single copy command
+        std::stable_sort(m_PendingCopies.begin(),
+                         m_PendingCopies.end(),
+                         [](const PendingCopy& a, const PendingCopy& b)
+                         { return std::less<VkBuffer>{}((VkBuffer)a.DstBuffer, (VkBuffer)b.DstBuffer); });
+
+        std::vector<vk::BufferCopy> regions;
+        regions.reserve(m_PendingCopies.size());
+
+        const vk::CommandBuffer          commandBuffer = AcquireCommandBuffer();
+        const vk::CommandBufferBeginInfo beginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
+        VK_VERIFY(commandBuffer.begin(&beginInfo));
+
+        u32 copyCommands = 0;
+        for (size_t begin = 0; begin < m_PendingCopies.size();)
+        {
+            const vk::Buffer dstBuffer = m_PendingCopies[begin].DstBuffer;
+
+            regions.clear();
+            size_t end = begin;
+            while (end < m_PendingCopies.size() && m_PendingCopies[end].DstBuffer == dstBuffer)
+            {
+                regions.push_back(m_PendingCopies[end].Region);
+                end++;
+            }
+
+            commandBuffer.copyBuffer(m_StagingBufferAlloc.Buffer, dstBuffer, (u32)regions.size(), regions.data());
+            copyCommands++;
+            begin = end;
+        }
+
+        VK_VERIFY(commandBuffer.end());
+
+        // Submit all copies at once and signal the next timeline value
+        const u64                             signalValue = m_SubmittedValue + 1;
+        const vk::TimelineSemaphoreSubmitInfo timelineInfo{ .signalSemaphoreValueCount = 1,
+                                                            .pSignalSemaphoreValues    = &signalValue };
+        const vk::SubmitInfo                  submitInfo{ .pNext                = &timelineInfo,
+                                                          .commandBufferCount   = 1,
+                                                          .pCommandBuffers      = &commandBuffer,
+                                                          .signalSemaphoreCount = 1,
+                                                          .pSignalSemaphores    = &m_Timeline };
+        VK_VERIFY(m_Device->GetTransferQueue().submit(1, &submitInfo, nullptr));
+
+        m_StagingRing.Close(signalValue);
+        m_InFlightBatches.push_back({ .CommandBuffer = commandBuffer, .Value = signalValue });
+        m_SubmittedValue = signalValue;
+
+        LOG_PERF("Flushed {} upload(s) with {} copy command(s) ... (Staging: {} / {})",
+                 m_PendingCopies.size(),
+                 copyCommands,
+                 Core::Utility::BytesToString(m_StagingRing.GetUsedSize()),
+                 Core::Utility::BytesToString(m_StagingRing.GetCapacity()));
+
+        m_PendingCopies.clear();
+    }
+
+    b8 VulkanUploadBatcher::IsComplete(UploadTicket ticket)
+    {
+        if (ticket.Value <= m_CompletedValue)
+        {
+            return true;
+        }
+
+        if (ticket.Value > m_SubmittedValue)
+        {
+            return false;
+        }
+
+        Reclaim();
+        return ticket.Value <= m_CompletedValue;
+    }
+
+    void VulkanUploadBatcher::Wait(UploadTicket ticket)
+    {
+        if (ticket.Value > m_SubmittedValue)
+        {
+            Flush();
+        }
+
+        WaitForValue(ticket.Value);
+        Reclaim();
+    }
+
+    // ----- Private -----
+
+    Core::RangeAllocation VulkanUploadBatcher::AllocateStaging(vk::DeviceSize size)
+    {
+        Core::RangeAllocation staging = m_StagingRing.Allocate(size, STAGING_ALIGNMENT);
+
+        while (!staging.IsValid())
+        {
+            // Ring is full, submit what got recorded so far and wait for the oldest submission to free its region
+            if (m_StagingRing.GetOpenSize() > 0)
+            {
+                Flush();
+            }
+
+            ASSERT(m_StagingRing.GetPendingRegionCount() > 0, "Staging ring can't fit {} bytes!", size);
+            LOG_PERF("Staging ring is full, waiting for value {} ...", m_StagingRing.GetOldestFence());
+
+            WaitForValue(m_StagingRing.GetOldestFence());
+            Reclaim();
+
+            staging = m_StagingRing.Allocate(size, STAGING_ALIGNMENT);
+        }
+
+        return staging;
+    }
+
+    vk::CommandBuffer VulkanUploadBatcher::AcquireCommandBuffer()
+    {
+        // Command buffers of completed batches get reset implicitly by begin
+        if (!m_FreeCommandBuffers.empty())
+        {
+            const vk::CommandBuffer commandBuffer = m_FreeCommandBuffers.back();
+            m_FreeCommandBuffers.pop_back();
+            return commandBuffer;
+        }
+
+        const vk::CommandBufferAllocateInfo allocateInfo{ .commandPool        = m_CommandPool,
+                                                          .level              = vk::CommandBufferLevel::ePrimary,
+                                                          .commandBufferCount = 1 };
+        vk::CommandBuffer                   commandBuffer;
+        VK_VERIFY(m_Device->GetHandle().allocateCommandBuffers(&allocateInfo, &commandBuffer));
+        return commandBuffer;
+    }
+
+    void VulkanUploadBatcher::WaitForValue(u64 value)
+    {
+        if (value <= m_CompletedValue)
+        {
+            return;
+        }
+
+        const vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1, .pSemaphores = &m_Timeline, .pValues = &value };
+        VK_VERIFY(m_Device->GetHandle().waitSemaphores(&waitInfo, UINT64_MAX));
+    }
+
+    void VulkanUploadBatcher::Reclaim()
+    {
+        auto [res, value] = m_Device->GetHandle().getSemaphoreCounterValue(m_Timeline);
+        VK_VERIFY(res);
+        m_CompletedValue = value;
+
+        // Finished submissions give back their staging region and command buffer
+        m_StagingRing.Release(m_CompletedValue);
+
+        while (!m_InFlightBatches.empty() && m_InFlightBatches.front().Value <= m_CompletedValue)
+        {
+            m_FreeCommandBuffers.push_back(m_InFlightBatches.front().CommandBuffer);
+            m_InFlightBatches.pop_front();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Core/RingAllocator.hpp"
+
+#include "Graphics/Vulkan/VulkanAllocator.hpp"
+#include "Graphics/Vulkan/VulkanDevice.hpp"
+#include "Graphics/Vulkan/VulkanGlobals.hpp"
+
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics
+{
+    // Identifies the transfer submission an upload got recorded into
+    struct UploadTicket
+    {
+        u64 Value = 0; // Timeline value signaled once the copies completed, 0 := nothing to wait for
+    };
+
+    // Stages uploads in a persistently mapped ring buffer and records all copies since the last flush into a single
+    // transfer submission. Every submission signals the next value of one timeline semaphore, which frees its ring
+    // region and command buffer again, so uploading never has to drain the transfer queue.
+    class VulkanUploadBatcher
+    {
+    public:
+        explicit VulkanUploadBatcher(const VulkanDevice* device,
+                                     vk::DeviceSize      stagingCapacity = STAGING_RING_CAPACITY);
+        ~VulkanUploadBatcher();
+
+        VulkanUploadBatcher(const VulkanUploadBatcher&)            = delete;
+        VulkanUploadBatcher& operator=(const VulkanUploadBatcher&) = delete;
+
+        // Copies the data into the staging ring right away, the copy into the destination gets submitted by the
+        // next flush. Blocks only if the ring is full and the oldest submission didn't finish yet.
+        [[nodiscard]] UploadTicket Upload(vk::Buffer dstBuffer, vk::DeviceSize dstOffset, std::span<const u8> data);
+
+        // Submits all recorded copies at once
+        void Flush();
+
+        // Non-blocking, tickets of copies which didn't get flushed yet are never complete
+        [[nodiscard]] b8 IsComplete(UploadTicket ticket);
+        void             Wait(UploadTicket ticket);
+
+        // Waiting on the last completed value orders a submission after all uploads reported as complete
+        [[nodiscard]] vk::Semaphore GetTimeline() const { return m_Timeline; }
+        [[nodiscard]] u64           GetCompletedValue() const { return m_CompletedValue; }
+        [[nodiscard]] u64           GetSubmittedValue() const { return m_SubmittedValue; }
+
+    private:
+        struct PendingCopy
+        {
+            vk::Buffer     DstBuffer;
+            vk::BufferCopy Region;
+        };
+
+        struct InFlightBatch
+        {
+            vk::CommandBuffer CommandBuffer;
+            u64               Value = 0;
+        };
+
+        [[nodiscard]] Core::RangeAllocation AllocateStaging(vk::DeviceSize size);
+        [[nodiscard]] vk::CommandBuffer     AcquireCommandBuffer();
+
+        void WaitForValue(u64 value);
+        void Reclaim();
+
+        const VulkanDevice* m_Device = nullptr;
+
+        // Staging memory stays mapped for the lifetime of the batcher
+        BufferAllocation    m_StagingBufferAlloc = {};
+        u8*                 m_StagingData        = nullptr;
+        Core::RingAllocator m_StagingRing;
+
+        vk::CommandPool                m_CommandPool;
+        std::vector<vk::CommandBuffer> m_FreeCommandBuffers;
+        std::deque<InFlightBatch>      m_InFlightBatches;
+        std::vector<PendingCopy>       m_PendingCopies;
+
+        vk::Semaphore m_Timeline;
+        u64           m_SubmittedValue = 0;
+        u64           m_CompletedValue = 0;
+    };
+}
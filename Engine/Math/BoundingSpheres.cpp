@@ -0,0 +1,261 @@
+#include "BoundingSpheres.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <atomic>
+#include <bit>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace Engine::Math
+{
+    // ----- Internal -----
+
+    namespace
+    {
+        // Padding spheres are behind every plane, no matter where it is
+        constexpr f32 PADDING_RADIUS = -std::numeric_limits<f32>::max();
+
+        struct SphereArrays
+        {
+            const f32* X;
+            const f32* Y;
+            const f32* Z;
+            const f32* Radius;
+        };
+
+        // A sphere is visible unless it is completely behind one of the planes, same as Frustum::IntersectsSphere.
+        // The plane distance is summed up in the same order as glm::dot, so all paths agree bit for bit.
+        u32 CullGroupsScalar(const Frustum& frustum, const SphereArrays& spheres, u32 firstGroup, std::span<u8> masks)
+        {
+            u32 visibleCount = 0;
+
+            for (u32 group = 0; group < masks.size(); group++)
+            {
+                const u32 base = (firstGroup + group) * BoundingSpheres::GROUP_SIZE;
+                u32       mask = 0;
+
+                for (u32 lane = 0; lane < BoundingSpheres::GROUP_SIZE; lane++)
+                {
+                    const glm::vec3 center(spheres.X[base + lane], spheres.Y[base + lane], spheres.Z[base + lane]);
+                    mask |= (u32)frustum.IntersectsSphere(center, spheres.Radius[base + lane]) << lane;
+                }
+
+                masks[group] = (u8)mask;
+                visibleCount += std::popcount(mask);
+            }
+
+            return visibleCount;
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        // Plane components broadcast to all lanes
+        struct PlaneLanes4
+        {
+            __m128 X;
+            __m128 Y;
+            __m128 Z;
+            __m128 W;
+        };
+
+        struct PlaneLanes8
+        {
+            __m256 X;
+            __m256 Y;
+            __m256 Z;
+            __m256 W;
+        };
+
+        // Two 4-wide halves per group, SSE2 is part of every x86-64 CPU
+        __attribute__((target("sse2"))) u32
+        CullGroupsSse(const Frustum& frustum, const SphereArrays& spheres, u32 firstGroup, std::span<u8> masks)
+        {
+            PlaneLanes4 planes[Frustum::PLANE_COUNT];
+            for (u32 i = 0; i < Frustum::PLANE_COUNT; i++)
+            {
+                const glm::vec4& plane = frustum.GetPlanes()[i];
+                planes[i] = { _mm_set1_ps(plane.x), _mm_set1_ps(plane.y), _mm_set1_ps(plane.z), _mm_set1_ps(plane.w) };
+            }
+
+            u32 visibleCount = 0;
+
+            for (u32 group = 0; group < masks.size(); group++)
+            {
+                u32 mask = 0;
+
+                for (u32 half = 0; half < 2; half++)
+                {
+                    const u32    base    = (firstGroup + group) * BoundingSpheres::GROUP_SIZE + half * 4;
+                    const __m128 x       = _mm_loadu_ps(spheres.X + base);
+                    const __m128 y       = _mm_loadu_ps(spheres.Y + base);
+                    const __m128 z       = _mm_loadu_ps(spheres.Z + base);
+                    const __m128 negated = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.Radius + base));
+
+                    __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                    for (const PlaneLanes4& plane : planes)
+                    {
+                        const __m128 distance = _mm_add_ps(
+                            _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.X, x), _mm_mul_ps(plane.Y, y)),
+                                       _mm_mul_ps(plane.Z, z)),
+                            plane.W);
+
+                        visible = _mm_and_ps(visible, _mm_cmpnlt_ps(distance, negated));
+                    }
+
+                    mask |= (u32)_mm_movemask_ps(visible) << (half * 4);
+                }
+
+                masks[group] = (u8)mask;
+                visibleCount += std::popcount(mask);
+            }
+
+            return visibleCount;
+        }
+
+        // Whole group per iteration, compiled for AVX2 without requiring it from the rest of the engine
+        __attribute__((target("avx2"))) u32
+        CullGroupsAvx2(const Frustum& frustum, const SphereArrays& spheres, u32 firstGroup, std::span<u8> masks)
+        {
+            PlaneLanes8 planes[Frustum::PLANE_COUNT];
+            for (u32 i = 0; i < Frustum::PLANE_COUNT; i++)
+            {
+                const glm::vec4& plane = frustum.GetPlanes()[i];
+                planes[i]              = {
+                    _mm256_set1_ps(plane.x), _mm256_set1_ps(plane.y), _mm256_set1_ps(plane.z), _mm256_set1_ps(plane.w)
+                };
+            }
+
+            u32 visibleCount = 0;
+
+            for (u32 group = 0; group < masks.size(); group++)
+            {
+                const u32    base    = (firstGroup + group) * BoundingSpheres::GROUP_SIZE;
+                const __m256 x       = _mm256_loadu_ps(spheres.X + base);
+                const __m256 y       = _mm256_loadu_ps(spheres.Y + base);
+                const __m256 z       = _mm256_loadu_ps(spheres.Z + base);
+                const __m256 negated = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.Radius + base));
+
+                __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (const PlaneLanes8& plane : planes)
+                {
+                    const __m256 distance = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane.X, x), _mm256_mul_ps(plane.Y, y)),
+                                      _mm256_mul_ps(plane.Z, z)),
+                        plane.W);
+
+                    visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negated, _CMP_NLT_UQ));
+                }
+
+                const u32 mask = (u32)_mm256_movemask_ps(visible);
+                masks[group]   = (u8)mask;
+                visibleCount += std::popcount(mask);
+            }
+
+            return visibleCount;
+        }
+#endif
+
+        using CullGroupsFn = u32 (*)(const Frustum&, const SphereArrays&, u32, std::span<u8>);
+
+        // Picks the widest instruction set the CPU supports
+        CullGroupsFn SelectCullGroups()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return CullGroupsAvx2;
+            }
+
+            if (__builtin_cpu_supports("sse2"))
+            {
+                return CullGroupsSse;
+            }
+#endif
+            return CullGroupsScalar;
+        }
+    }
+
+    // ----- Public -----
+
+    void BoundingSpheres::Clear()
+    {
+        m_CentersX.clear();
+        m_CentersY.clear();
+        m_CentersZ.clear();
+        m_Radii.clear();
+        m_Size = 0;
+    }
+
+    void BoundingSpheres::Reserve(u32 count)
+    {
+        const u32 padded = ((count + GROUP_SIZE - 1) / GROUP_SIZE) * GROUP_SIZE;
+
+        m_CentersX.reserve(padded);
+        m_CentersY.reserve(padded);
+        m_CentersZ.reserve(padded);
+        m_Radii.reserve(padded);
+    }
+
+    u32 BoundingSpheres::Add(const glm::vec3& center, f32 radius)
+    {
+        // Start a new group, padding gets overwritten by the following spheres
+        if (m_Size % GROUP_SIZE == 0)
+        {
+            m_CentersX.resize(m_Size + GROUP_SIZE, 0.0f);
+            m_CentersY.resize(m_Size + GROUP_SIZE, 0.0f);
+            m_CentersZ.resize(m_Size + GROUP_SIZE, 0.0f);
+            m_Radii.resize(m_Size + GROUP_SIZE, PADDING_RADIUS);
+        }
+
+        m_CentersX[m_Size] = center.x;
+        m_CentersY[m_Size] = center.y;
+        m_CentersZ[m_Size] = center.z;
+        m_Radii[m_Size]    = radius;
+
+        return m_Size++;
+    }
+
+    u32 BoundingSpheres::Cull(const Frustum& frustum, std::vector<u8>& visibility) const
+    {
+        visibility.resize(GetGroupCount());
+
+        if (GetGroupCount() < PARALLEL_MIN_GROUPS)
+        {
+            return CullGroups(frustum, 0, visibility);
+        }
+
+        // Ranges write disjoint masks, only the count is shared
+        std::atomic<u32> visibleCount = 0;
+        Core::JobSystem::ParallelFor(0,
+                                     GetGroupCount(),
+                                     PARALLEL_GRAIN,
+                                     [&](u64 begin, u64 end)
+                                     {
+                                         const std::span<u8> masks = std::span(visibility).subspan(begin, end - begin);
+                                         visibleCount.fetch_add(CullGroups(frustum, (u32)begin, masks),
+                                                                std::memory_order_relaxed);
+                                     });
+
+        return visibleCount.load(std::memory_order_relaxed);
+    }
+
+    u32 BoundingSpheres::CullGroups(const Frustum& frustum, u32 firstGroup, std::span<u8> visibility) const
+    {
+        ASSERT(firstGroup + visibility.size() <= GetGroupCount(), "Tried to cull groups past the last sphere!");
+
+        const SphereArrays spheres{ .X      = m_CentersX.data(),
+                                    .Y      = m_CentersY.data(),
+                                    .Z      = m_CentersZ.data(),
+                                    .Radius = m_Radii.data() };
+
+        static const CullGroupsFn cullGroups = SelectCullGroups();
+        return cullGroups(frustum, spheres, firstGroup, visibility);
+    }
+}
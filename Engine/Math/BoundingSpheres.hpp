@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include "Math/Frustum.hpp"
+
+#include "Vendor/glm/glm.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Engine::Math
+{
+    // Bounding spheres stored as structure of arrays, so SIMD code loads the same component of a whole group of
+    // spheres at once. The arrays are padded to full groups with spheres which never intersect anything.
+    class BoundingSpheres
+    {
+    public:
+        // Spheres classified per iteration and per visibility mask
+        static constexpr u32 GROUP_SIZE = 8;
+
+        // Sets with more groups get culled across the job system
+        static constexpr u32 PARALLEL_MIN_GROUPS = 1024;
+        static constexpr u32 PARALLEL_GRAIN      = 256;
+
+        void Clear();
+        void Reserve(u32 count);
+
+        // Returns the index of the sphere
+        u32 Add(const glm::vec3& center, f32 radius);
+
+        // Writes one mask per group into 'visibility', bit i of a mask is set if sphere i of the group intersects the
+        // frustum. Returns the number of visible spheres.
+        u32 Cull(const Frustum& frustum, std::vector<u8>& visibility) const;
+
+        // Culls the groups [firstGroup, firstGroup + visibility.size()) on the calling thread
+        u32 CullGroups(const Frustum& frustum, u32 firstGroup, std::span<u8> visibility) const;
+
+        [[nodiscard]] static b8 IsVisible(std::span<const u8> visibility, u32 index)
+        {
+            return (visibility[index / GROUP_SIZE] >> (index % GROUP_SIZE)) & 1;
+        }
+
+        // xyz: center, w: radius
+        [[nodiscard]] glm::vec4 Get(u32 index) const
+        {
+            return { m_CentersX[index], m_CentersY[index], m_CentersZ[index], m_Radii[index] };
+        }
+
+        [[nodiscard]] u32 GetSize() const { return m_Size; }
+        [[nodiscard]] u32 GetGroupCount() const { return (u32)m_Radii.size() / GROUP_SIZE; }
+        [[nodiscard]] b8  IsEmpty() const { return m_Size == 0; }
+
+    private:
+        std::vector<f32> m_CentersX;
+        std::vector<f32> m_CentersY;
+        std::vector<f32> m_CentersZ;
+        std::vector<f32> m_Radii;
+
+        u32 m_Size = 0;
+    };
+}
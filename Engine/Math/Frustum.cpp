@@ -0,0 +1,42 @@
+#include "Frustum.hpp"
+
+namespace Engine::Math
+{
+    // ----- Public -----
+
+    Frustum::Frustum(const glm::mat4& viewProjection)
+    {
+        // Rows of the matrix (glm stores columns)
+        const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        // Clip space bounds are -w <= x, y <= w and 0 <= z <= w
+        m_Planes[eLeft]   = row3 + row0;
+        m_Planes[eRight]  = row3 - row0;
+        m_Planes[eBottom] = row3 + row1;
+        m_Planes[eTop]    = row3 - row1;
+        m_Planes[eNear]   = row2;
+        m_Planes[eFar]    = row3 - row2;
+
+        // Normalize, so plane distances are in world units and can be compared against radii
+        for (glm::vec4& plane : m_Planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    b8 Frustum::IntersectsSphere(const glm::vec3& center, f32 radius) const
+    {
+        for (const glm::vec4& plane : m_Planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include "Vendor/glm/glm.hpp"
+
+#include <array>
+
+namespace Engine::Math
+{
+    // View frustum as six planes (xyz: normal pointing inwards, w: distance), extracted from a view projection
+    // matrix with Vulkan's [0, 1] depth range. Points p inside the frustum satisfy dot(plane.xyz, p) + plane.w >= 0.
+    class Frustum
+    {
+    public:
+        enum Plane : u8
+        {
+            eLeft   = 0,
+            eRight  = 1,
+            eBottom = 2,
+            eTop    = 3,
+            eNear   = 4,
+            eFar    = 5
+        };
+
+        static constexpr u32 PLANE_COUNT = 6;
+
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        // Conservative, spheres close to a corner may pass although they are outside
+        [[nodiscard]] b8 IntersectsSphere(const glm::vec3& center, f32 radius) const;
+
+        [[nodiscard]] const std::array<glm::vec4, PLANE_COUNT>& GetPlanes() const { return m_Planes; }
+
+    private:
+        std::array<glm::vec4, PLANE_COUNT> m_Planes = {};
+    };
+}
@@ -0,0 +1,143 @@
+#include "FileWatcher.hpp"
+
+#include "Debug/Log.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // ----- Internal -----
+
+    using namespace Engine;
+
+    u64 GetModifiedTime(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        const auto      modifiedTime = std::filesystem::last_write_time(path, ec);
+        return ec ? 0 : (u64)modifiedTime.time_since_epoch().count();
+    }
+}
+
+namespace Engine::Platform
+{
+    // ----- Public -----
+
+#ifdef __linux__
+    FileWatcher::FileWatcher()
+    {
+        m_Handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_Handle == -1)
+        {
+            LOG_WARN("Can't create inotify instance, falling back to polling modification times ...");
+        }
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        if (m_Handle != -1)
+        {
+            close(m_Handle);
+        }
+    }
+#else
+    FileWatcher::FileWatcher() = default;
+    FileWatcher::~FileWatcher() = default;
+#endif
+
+    void FileWatcher::Watch(const std::filesystem::path& path)
+    {
+        std::error_code             ec;
+        const std::filesystem::path absolutePath = std::filesystem::absolute(path, ec).lexically_normal();
+
+        if (std::ranges::any_of(m_Files, [&](const WatchedFile& file) { return file.AbsolutePath == absolutePath; }))
+        {
+            return;
+        }
+
+        m_Files.push_back({ .Path = path, .AbsolutePath = absolutePath, .ModifiedTime = GetModifiedTime(path) });
+
+#ifdef __linux__
+        const std::filesystem::path directory = absolutePath.parent_path();
+
+        if (m_Handle == -1
+            || std::ranges::any_of(m_Directories, [&](const WatchedDirectory& dir) { return dir.Path == directory; }))
+        {
+            return;
+        }
+
+        // Closing after a write and moving into the directory cover in-place saves and atomic replaces
+        const i32 handle = inotify_add_watch(m_Handle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (handle == -1)
+        {
+            LOG_WARN("Can't watch directory '{}' ...", directory.string());
+            return;
+        }
+
+        m_Directories.push_back({ .Path = directory, .Handle = handle });
+        LOG_VERBOSE("Watching directory '{}' ...", directory.string());
+#endif
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::Poll()
+    {
+        std::vector<std::filesystem::path> changed;
+
+        // Events only tell that something happened, the modification time decides whether the file really changed
+        const auto checkFile = [&changed](WatchedFile& file)
+        {
+            const u64 modifiedTime = GetModifiedTime(file.Path);
+            if (modifiedTime != 0 && modifiedTime != file.ModifiedTime
+                && std::ranges::find(changed, file.Path) == changed.end())
+            {
+                file.ModifiedTime = modifiedTime;
+                changed.push_back(file.Path);
+            }
+        };
+
+#ifdef __linux__
+        if (m_Handle != -1)
+        {
+            alignas(inotify_event) char buffer[4096];
+
+            for (ssize_t size = read(m_Handle, buffer, sizeof(buffer)); size > 0;
+                 size         = read(m_Handle, buffer, sizeof(buffer)))
+            {
+                for (ssize_t offset = 0; offset < size;)
+                {
+                    const auto* event = (const inotify_event*)(buffer + offset);
+                    offset += (ssize_t)(sizeof(inotify_event) + event->len);
+
+                    const auto directory = std::ranges::find(m_Directories, event->wd, &WatchedDirectory::Handle);
+                    if (directory == m_Directories.end() || event->len == 0)
+                    {
+                        continue;
+                    }
+
+                    const std::filesystem::path absolutePath = directory->Path / event->name;
+                    for (WatchedFile& file : m_Files)
+                    {
+                        if (file.AbsolutePath == absolutePath)
+                        {
+                            checkFile(file);
+                        }
+                    }
+                }
+            }
+
+            return changed;
+        }
+#endif
+
+        for (WatchedFile& file : m_Files)
+        {
+            checkFile(file);
+        }
+
+        return changed;
+    }
+}
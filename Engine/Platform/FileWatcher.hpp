@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace Engine::Platform
+{
+    // Reports modifications of a set of files without blocking. Linux watches the parent directories with inotify,
+    // so editors which save by replacing the file get picked up as well. Other platforms compare modification times.
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&)            = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        // Watching a file twice has no effect
+        void Watch(const std::filesystem::path& path);
+
+        // Files modified since the last call, every file at most once and with the path it was watched by
+        [[nodiscard]] std::vector<std::filesystem::path> Poll();
+
+    private:
+        struct WatchedFile
+        {
+            std::filesystem::path Path;         // As passed to Watch
+            std::filesystem::path AbsolutePath; // Compared against the reported file names
+            u64                   ModifiedTime = 0;
+        };
+
+        struct WatchedDirectory
+        {
+            std::filesystem::path Path;
+            i32                   Handle = -1; // inotify watch descriptor
+        };
+
+        std::vector<WatchedFile>      m_Files;
+        std::vector<WatchedDirectory> m_Directories;
+        i32                           m_Handle = -1; // inotify instance
+    };
+}
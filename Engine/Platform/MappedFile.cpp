@@ -0,0 +1,124 @@
+#include "MappedFile.hpp"
+
+#include "Core/Utility.hpp"
+
+#include "Debug/Log.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine::Platform
+{
+    // ----- Public -----
+
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        Map(path);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Unmap();
+    }
+
+    // ----- Private -----
+
+#ifdef _WIN32
+    void MappedFile::Map(const std::filesystem::path& path)
+    {
+        HANDLE file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                  nullptr);
+        ASSERT(file != INVALID_HANDLE_VALUE, "Can't open file: {}", path.string());
+        m_FileHandle = (i64)(intptr_t)file;
+
+        LARGE_INTEGER size{};
+        ASSERT(GetFileSizeEx(file, &size), "Can't query size of file: {}", path.string());
+        m_Size = (u64)size.QuadPart;
+
+        // Empty files can't be mapped
+        if (m_Size == 0)
+        {
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ASSERT(mapping != nullptr, "Can't create file mapping: {}", path.string());
+        m_MappingHandle = mapping;
+
+        m_Data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ASSERT(m_Data != nullptr, "Can't map file: {}", path.string());
+
+        LOG_VERBOSE("Mapped file '{}' ... ({})", path.string(), Core::Utility::BytesToString(m_Size));
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_Data != nullptr)
+        {
+            UnmapViewOfFile(m_Data);
+        }
+
+        if (m_MappingHandle != nullptr)
+        {
+            CloseHandle((HANDLE)m_MappingHandle);
+        }
+
+        if (m_FileHandle != -1)
+        {
+            CloseHandle((HANDLE)(intptr_t)m_FileHandle);
+        }
+    }
+#else
+    void MappedFile::Map(const std::filesystem::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        ASSERT(fd != -1, "Can't open file: {}", path.string());
+        m_FileHandle = fd;
+
+        struct stat fileStat{};
+        ASSERT(fstat(fd, &fileStat) == 0, "Can't query size of file: {}", path.string());
+        m_Size = (u64)fileStat.st_size;
+
+        // Empty files can't be mapped
+        if (m_Size == 0)
+        {
+            return;
+        }
+
+        void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ASSERT(data != MAP_FAILED, "Can't map file: {}", path.string());
+        m_Data = (const char*)data;
+
+        // The whole file gets read right away (possibly by multiple threads)
+        madvise(data, m_Size, MADV_WILLNEED);
+
+        LOG_VERBOSE("Mapped file '{}' ... ({})", path.string(), Core::Utility::BytesToString(m_Size));
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_Data != nullptr)
+        {
+            munmap((void*)m_Data, m_Size);
+        }
+
+        if (m_FileHandle != -1)
+        {
+            close((int)m_FileHandle);
+        }
+    }
+#endif
+}
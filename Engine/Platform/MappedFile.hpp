@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+#include <filesystem>
+#include <string_view>
+
+namespace Engine::Platform
+{
+    // Read-only memory mapping of a complete file. The mapping stays valid as long as the object lives.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const char*      GetData() const { return m_Data; }
+        [[nodiscard]] u64              GetSize() const { return m_Size; }
+        [[nodiscard]] std::string_view GetView() const { return { m_Data, m_Size }; }
+
+    private:
+        void Map(const std::filesystem::path& path);
+        void Unmap();
+
+        const char* m_Data = nullptr;
+        u64         m_Size = 0;
+
+        // Platform specific handles (file descriptor or file/mapping handles)
+        i64   m_FileHandle    = -1;
+        void* m_MappingHandle = nullptr;
+    };
+}
@@ -0,0 +1,116 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include "Math/BoundingSpheres.hpp"
+
+#include "Vendor/glm/gtc/matrix_transform.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Engine::u32;
+    using Engine::u8;
+    using Engine::Math::BoundingSpheres;
+    using Engine::Math::Frustum;
+
+    // Camera at the origin looking down -Z, 90 degree vertical field of view, near 1 and far 100
+    Frustum MakeFrustum()
+    {
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4       projection = glm::perspectiveRH_ZO(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+        projection[1][1] *= -1; // Same flip as the renderer
+
+        return Frustum(projection * view);
+    }
+
+    // Spheres scattered around the frustum, roughly half of them visible
+    BoundingSpheres MakeRandomSpheres(u32 count)
+    {
+        std::mt19937                          random(1234);
+        std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+        std::uniform_real_distribution<float> radius(0.0f, 10.0f);
+
+        BoundingSpheres spheres;
+        spheres.Reserve(count);
+
+        for (u32 i = 0; i < count; i++)
+        {
+            spheres.Add(glm::vec3(position(random), position(random), position(random) - 60.0f), radius(random));
+        }
+
+        return spheres;
+    }
+
+    void CheckMatchesFrustum(const BoundingSpheres& spheres, const std::vector<u8>& visibility, u32 visibleCount)
+    {
+        const Frustum frustum = MakeFrustum();
+
+        REQUIRE(visibility.size() == spheres.GetGroupCount());
+
+        u32 expectedCount = 0;
+        for (u32 i = 0; i < spheres.GetSize(); i++)
+        {
+            const glm::vec4 sphere   = spheres.Get(i);
+            const bool      expected = frustum.IntersectsSphere(glm::vec3(sphere), sphere.w);
+
+            CHECK(BoundingSpheres::IsVisible(visibility, i) == expected);
+            expectedCount += expected;
+        }
+
+        CHECK(visibleCount == expectedCount);
+    }
+
+    TEST_CASE("BoundingSpheres pads to full groups with spheres that are never visible")
+    {
+        BoundingSpheres spheres;
+        CHECK(spheres.IsEmpty());
+        CHECK(spheres.GetGroupCount() == 0);
+
+        // Three spheres in front of the camera fill one group, the other five lanes are padding
+        for (u32 i = 0; i < 3; i++)
+        {
+            CHECK(spheres.Add(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f) == i);
+        }
+
+        CHECK(spheres.GetSize() == 3);
+        CHECK(spheres.GetGroupCount() == 1);
+
+        std::vector<u8> visibility;
+        CHECK(spheres.Cull(MakeFrustum(), visibility) == 3);
+        CHECK(visibility == std::vector<u8>{ 0b0000'0111 });
+
+        spheres.Clear();
+        CHECK(spheres.IsEmpty());
+        CHECK(spheres.Cull(MakeFrustum(), visibility) == 0);
+        CHECK(visibility.empty());
+    }
+
+    TEST_CASE("BoundingSpheres::Cull agrees with Frustum::IntersectsSphere")
+    {
+        const BoundingSpheres spheres = MakeRandomSpheres(1001);
+
+        std::vector<u8> visibility;
+        const u32       visibleCount = spheres.Cull(MakeFrustum(), visibility);
+
+        CHECK(visibleCount > 0);
+        CHECK(visibleCount < spheres.GetSize());
+        CheckMatchesFrustum(spheres, visibility, visibleCount);
+    }
+
+    TEST_CASE("BoundingSpheres::Cull splits large sets across the job system")
+    {
+        Engine::Core::JobSystem::Init(4);
+
+        const BoundingSpheres spheres = MakeRandomSpheres(BoundingSpheres::PARALLEL_MIN_GROUPS * 8 * 3 + 5);
+
+        std::vector<u8> visibility;
+        const u32       visibleCount = spheres.Cull(MakeFrustum(), visibility);
+
+        Engine::Core::JobSystem::Shutdown();
+
+        CheckMatchesFrustum(spheres, visibility, visibleCount);
+    }
+}
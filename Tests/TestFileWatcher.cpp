@@ -0,0 +1,79 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Platform/FileWatcher.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+    using Engine::Platform::FileWatcher;
+
+    // Fresh directory per test, removed again on destruction
+    struct TempDirectory
+    {
+        std::filesystem::path Path = std::filesystem::temp_directory_path() / "EngineTestsFileWatcher";
+
+        TempDirectory()
+        {
+            std::filesystem::remove_all(Path);
+            std::filesystem::create_directories(Path);
+        }
+
+        ~TempDirectory() { std::filesystem::remove_all(Path); }
+    };
+
+    void WriteFile(const std::filesystem::path& path, const char* content)
+    {
+        std::ofstream(path, std::ios::trunc) << content;
+    }
+
+    // Modification times are only as fine as the file system's clock, so move them forward explicitly
+    void Touch(const std::filesystem::path& path)
+    {
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+    }
+
+    TEST_CASE("FileWatcher reports modified files once and ignores untouched ones")
+    {
+        const TempDirectory directory;
+        const auto          watchedPath = directory.Path / "Watched.glsl";
+        const auto          otherPath   = directory.Path / "Other.glsl";
+        WriteFile(watchedPath, "a");
+        WriteFile(otherPath, "a");
+
+        FileWatcher watcher;
+        watcher.Watch(watchedPath);
+        watcher.Watch(watchedPath);
+        CHECK(watcher.Poll().empty());
+
+        WriteFile(otherPath, "b");
+        Touch(otherPath);
+        CHECK(watcher.Poll().empty());
+
+        WriteFile(watchedPath, "b");
+        WriteFile(watchedPath, "c");
+        Touch(watchedPath);
+        CHECK(watcher.Poll() == std::vector<std::filesystem::path>{ watchedPath });
+        CHECK(watcher.Poll().empty());
+    }
+
+    TEST_CASE("FileWatcher picks up files replaced by a rename")
+    {
+        const TempDirectory directory;
+        const auto          watchedPath = directory.Path / "Watched.glsl";
+        const auto          tempPath    = directory.Path / "Watched.glsl.tmp";
+        WriteFile(watchedPath, "a");
+
+        FileWatcher watcher;
+        watcher.Watch(watchedPath);
+
+        WriteFile(tempPath, "b");
+        Touch(tempPath);
+        std::filesystem::rename(tempPath, watchedPath);
+
+        CHECK(watcher.Poll() == std::vector<std::filesystem::path>{ watchedPath });
+    }
+}
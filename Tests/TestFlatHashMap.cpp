@@ -0,0 +1,147 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/FlatHashMap.hpp"
+#include "Core/Hash.hpp"
+
+#include <array>
+#include <bit>
+#include <unordered_set>
+
+namespace
+{
+    TEST_CASE("HashBytes is deterministic and depends on every byte")
+    {
+        std::array<Engine::u8, 37> bytes{};
+
+        const Engine::u64 reference = Engine::Core::HashBytes(bytes.data(), bytes.size());
+        CHECK(reference == Engine::Core::HashBytes(bytes.data(), bytes.size()));
+
+        for (size_t i = 0; i < bytes.size(); i++)
+        {
+            bytes[i] = 1;
+            CHECK(Engine::Core::HashBytes(bytes.data(), bytes.size()) != reference);
+            bytes[i] = 0;
+        }
+    }
+
+    TEST_CASE("HashBytes distinguishes lengths and small inputs")
+    {
+        const std::array<Engine::u8, 16> bytes{};
+        std::unordered_set<Engine::u64>  hashes;
+
+        for (size_t size = 0; size <= bytes.size(); size++)
+        {
+            hashes.insert(Engine::Core::HashBytes(bytes.data(), size));
+        }
+
+        CHECK(hashes.size() == bytes.size() + 1);
+    }
+
+    TEST_CASE("HashBytes spreads sequential keys across the low bits")
+    {
+        constexpr Engine::u32 KEY_COUNT    = 1 << 16;
+        constexpr Engine::u32 BUCKET_COUNT = 256;
+
+        std::array<Engine::u32, BUCKET_COUNT> buckets{};
+
+        for (Engine::u32 key = 0; key < KEY_COUNT; key++)
+        {
+            buckets[Engine::Core::HashBytes(&key, sizeof(key)) % BUCKET_COUNT]++;
+        }
+
+        // Every bucket should receive roughly KEY_COUNT / BUCKET_COUNT = 256 keys
+        for (const Engine::u32 count : buckets)
+        {
+            CHECK(count > 128);
+            CHECK(count < 384);
+        }
+    }
+
+    TEST_CASE("FlatHashMap::FindOrInsert inserts once and finds afterwards")
+    {
+        Engine::Core::FlatHashMap<Engine::u32, Engine::u32> map;
+
+        const auto first = map.FindOrInsert(7, 42);
+        CHECK(first.Inserted);
+        CHECK(first.Entry == 42);
+
+        const auto second = map.FindOrInsert(7, 13);
+        CHECK_FALSE(second.Inserted);
+        CHECK(second.Entry == 42);
+
+        CHECK(map.GetSize() == 1);
+        CHECK(map.Contains(7));
+        CHECK_FALSE(map.Contains(8));
+    }
+
+    TEST_CASE("FlatHashMap keeps all entries while growing")
+    {
+        Engine::Core::FlatHashMap<Engine::u64, Engine::u64> map;
+
+        for (Engine::u64 i = 0; i < 10000; i++)
+        {
+            CHECK(map.FindOrInsert(i * 31, i).Inserted);
+        }
+
+        CHECK(map.GetSize() == 10000);
+        CHECK(std::has_single_bit(map.GetCapacity()));
+        CHECK(map.GetSize() * 4 <= map.GetCapacity() * 3);
+
+        for (Engine::u64 i = 0; i < 10000; i++)
+        {
+            const Engine::u64* value = map.Find(i * 31);
+            REQUIRE(value != nullptr);
+            CHECK(*value == i);
+        }
+
+        CHECK(map.Find(1) == nullptr);
+    }
+
+    TEST_CASE("FlatHashMap::Reserve avoids rehashing")
+    {
+        Engine::Core::FlatHashMap<Engine::u32, Engine::u32> map(1000);
+        const Engine::u64                                   capacity = map.GetCapacity();
+
+        for (Engine::u32 i = 0; i < 1000; i++)
+        {
+            map.FindOrInsert(i, i);
+        }
+
+        CHECK(map.GetCapacity() == capacity);
+    }
+
+    TEST_CASE("FlatHashMap::Clear removes all entries")
+    {
+        Engine::Core::FlatHashMap<Engine::u32, Engine::u32> map;
+
+        map.FindOrInsert(1, 1);
+        map.FindOrInsert(2, 2);
+        map.Clear();
+
+        CHECK(map.GetSize() == 0);
+        CHECK_FALSE(map.Contains(1));
+        CHECK(map.FindOrInsert(2, 3).Entry == 3);
+    }
+
+    TEST_CASE("FlatHashMap with bitwise equality treats +0.0f and -0.0f as different keys")
+    {
+        using FloatHash  = Engine::Core::BitwiseHash<float>;
+        using FloatEqual = Engine::Core::BitwiseEqual<float>;
+
+        Engine::Core::FlatHashMap<float, Engine::u32, FloatHash, FloatEqual> map;
+
+        CHECK(map.FindOrInsert(0.0f, 0).Inserted);
+        CHECK(map.FindOrInsert(-0.0f, 1).Inserted);
+        CHECK(map.GetSize() == 2);
+    }
+
+    TEST_CASE("FlatHashMap defaults to equality consistent with its hash")
+    {
+        Engine::Core::FlatHashMap<float, Engine::u32> map;
+
+        CHECK(map.FindOrInsert(0.0f, 0).Inserted);
+        CHECK(map.FindOrInsert(-0.0f, 1).Inserted);
+        CHECK(map.FindOrInsert(0.0f, 2).Entry == 0);
+        CHECK(map.GetSize() == 2);
+    }
+}
@@ -0,0 +1,67 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Math/Frustum.hpp"
+
+#include "Vendor/glm/gtc/matrix_transform.hpp"
+
+namespace
+{
+    using Engine::Math::Frustum;
+
+    // Camera at the origin looking down -Z, 90 degree vertical field of view, near 1 and far 100
+    Frustum MakeFrustum()
+    {
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4       projection = glm::perspectiveRH_ZO(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+        projection[1][1] *= -1; // Same flip as the renderer
+
+        return Frustum(projection * view);
+    }
+
+    TEST_CASE("Frustum planes are normalized and point inwards")
+    {
+        const Frustum frustum = MakeFrustum();
+
+        for (const glm::vec4& plane : frustum.GetPlanes())
+        {
+            CHECK(glm::length(glm::vec3(plane)) == doctest::Approx(1.0f));
+
+            // A point in the middle of the frustum is on the inner side of every plane
+            CHECK(glm::dot(glm::vec3(plane), glm::vec3(0.0f, 0.0f, -50.0f)) + plane.w > 0.0f);
+        }
+
+        CHECK(frustum.GetPlanes()[Frustum::eNear].w == doctest::Approx(-1.0f));
+        CHECK(frustum.GetPlanes()[Frustum::eFar].w == doctest::Approx(100.0f));
+    }
+
+    TEST_CASE("Frustum accepts spheres inside and touching it")
+    {
+        const Frustum frustum = MakeFrustum();
+
+        CHECK(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f));
+        CHECK(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, -10.0f), 0.0f));
+
+        // Center behind the camera, but the radius reaches past the near plane
+        CHECK(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, 1.0f), 2.5f));
+
+        // Center beyond the far plane, but the radius reaches back into the frustum
+        CHECK(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, -101.0f), 2.0f));
+
+        // At z = -10 the frustum spans [-10, 10] on both axes
+        CHECK(frustum.IntersectsSphere(glm::vec3(11.0f, 0.0f, -10.0f), 1.0f));
+        CHECK(frustum.IntersectsSphere(glm::vec3(0.0f, -11.0f, -10.0f), 1.0f));
+    }
+
+    TEST_CASE("Frustum rejects spheres outside of any plane")
+    {
+        const Frustum frustum = MakeFrustum();
+
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, 5.0f), 1.0f));     // Behind the camera
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, -0.5f), 0.25f));   // In front of the near plane
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(0.0f, 0.0f, -110.0f), 5.0f));  // Beyond the far plane
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(-20.0f, 0.0f, -10.0f), 5.0f)); // Left
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(20.0f, 0.0f, -10.0f), 5.0f));  // Right
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(0.0f, -20.0f, -10.0f), 5.0f)); // Bottom
+        CHECK_FALSE(frustum.IntersectsSphere(glm::vec3(0.0f, 20.0f, -10.0f), 5.0f));  // Top
+    }
+}
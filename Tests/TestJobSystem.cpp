@@ -0,0 +1,168 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    TEST_CASE("JobSystem::Execute runs jobs inline without initialization")
+    {
+        Engine::u32 value = 0;
+
+        Engine::Core::JobSystem::Execute([&value] { value = 42; });
+
+        CHECK(value == 42);
+        CHECK(Engine::Core::JobSystem::GetWorkerCount() == 1);
+    }
+
+    TEST_CASE("JobSystem::Execute decrements counter once all jobs finished")
+    {
+        Engine::Core::JobSystem::Init(4);
+
+        std::atomic<Engine::u32> value = 0;
+        Engine::Core::JobCounter counter;
+
+        for (Engine::u32 i = 0; i < 1000; i++)
+        {
+            Engine::Core::JobSystem::Execute([&value] { value.fetch_add(1); }, &counter);
+        }
+
+        Engine::Core::JobSystem::Wait(counter);
+
+        CHECK(counter.IsDone());
+        CHECK(value.load() == 1000);
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::Execute completes jobs without another worker")
+    {
+        Engine::Core::JobSystem::Init(1);
+
+        Engine::u32              value = 0;
+        Engine::Core::JobCounter counter;
+
+        Engine::Core::JobSystem::Execute([&value] { value = 42; }, &counter);
+
+        CHECK(counter.IsDone());
+        CHECK(value == 42);
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::ExecuteBackground runs jobs off the calling thread")
+    {
+        Engine::Core::JobSystem::Init(1);
+
+        std::thread::id          jobThread;
+        Engine::Core::JobCounter counter;
+
+        Engine::Core::JobSystem::ExecuteBackground([&jobThread] { jobThread = std::this_thread::get_id(); },
+                                                   &counter);
+        Engine::Core::JobSystem::Wait(counter);
+
+        CHECK(counter.IsDone());
+        CHECK(jobThread != std::thread::id());
+        CHECK(jobThread != std::this_thread::get_id());
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::Execute respects job dependencies")
+    {
+        Engine::Core::JobSystem::Init(4);
+
+        std::vector<Engine::u32> values(256, 0);
+        Engine::Core::JobCounter firstStage;
+        Engine::Core::JobCounter secondStage;
+        std::atomic<bool>        orderViolated = false;
+
+        for (Engine::u32 i = 0; i < values.size(); i++)
+        {
+            Engine::Core::JobSystem::Execute([&values, i] { values[i] = i; }, &firstStage);
+        }
+
+        for (Engine::u32 i = 0; i < values.size(); i++)
+        {
+            Engine::Core::JobSystem::Execute(
+                [&values, &orderViolated, i]
+                {
+                    if (values[i] != i)
+                    {
+                        orderViolated = true;
+                    }
+                },
+                &secondStage,
+                &firstStage);
+        }
+
+        Engine::Core::JobSystem::Wait(secondStage);
+
+        CHECK_FALSE(orderViolated.load());
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::ParallelFor visits every index exactly once")
+    {
+        Engine::Core::JobSystem::Init(4);
+
+        std::vector<Engine::u32> visits(10007, 0);
+
+        Engine::Core::JobSystem::ParallelFor(0,
+                                             visits.size(),
+                                             64,
+                                             [&visits](Engine::u64 begin, Engine::u64 end)
+                                             {
+                                                 for (Engine::u64 i = begin; i < end; i++)
+                                                 {
+                                                     visits[i]++;
+                                                 }
+                                             });
+
+        CHECK(std::accumulate(visits.begin(), visits.end(), 0u) == visits.size());
+        CHECK(std::all_of(visits.begin(), visits.end(), [](Engine::u32 count) { return count == 1; }));
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::ParallelFor supports nested loops")
+    {
+        Engine::Core::JobSystem::Init(4);
+
+        std::atomic<Engine::u64> sum = 0;
+
+        Engine::Core::JobSystem::ParallelFor(0,
+                                             16,
+                                             1,
+                                             [&sum](Engine::u64 outerBegin, Engine::u64 outerEnd)
+                                             {
+                                                 for (Engine::u64 i = outerBegin; i < outerEnd; i++)
+                                                 {
+                                                     Engine::Core::JobSystem::ParallelFor(
+                                                         0,
+                                                         100,
+                                                         10,
+                                                         [&sum](Engine::u64 begin, Engine::u64 end)
+                                                         { sum.fetch_add(end - begin); });
+                                                 }
+                                             });
+
+        CHECK(sum.load() == 1600);
+
+        Engine::Core::JobSystem::Shutdown();
+    }
+
+    TEST_CASE("JobSystem::ParallelFor handles empty ranges")
+    {
+        Engine::u32 calls = 0;
+
+        Engine::Core::JobSystem::ParallelFor(5, 5, 1, [&calls](Engine::u64, Engine::u64) { calls++; });
+
+        CHECK(calls == 0);
+    }
+}
@@ -0,0 +1,95 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/FlatHashMap.hpp"
+
+#include "Graphics/Resources/Mesh.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using namespace Engine::Graphics;
+
+    TEST_CASE("GetIndexFormat picks 16-bit indices while every vertex is addressable")
+    {
+        static_assert(GetIndexFormat(0) == IndexFormat::eUint16);
+        static_assert(GetIndexFormat(65536) == IndexFormat::eUint16);
+        static_assert(GetIndexFormat(65537) == IndexFormat::eUint32);
+
+        CHECK(GetIndexSize(IndexFormat::eUint16) == 2);
+        CHECK(GetIndexSize(IndexFormat::eUint32) == 4);
+    }
+
+    TEST_CASE("NarrowIndices keeps the values up to the largest 16-bit index")
+    {
+        const std::vector<Engine::u32> indices = { 0, 1, 65535, 42 };
+        const std::vector<Engine::u16> narrow  = NarrowIndices(indices);
+
+        CHECK(narrow == std::vector<Engine::u16>{ 0, 1, 65535, 42 });
+    }
+
+    TEST_CASE("Mesh::GetView exposes 32-bit indices as raw bytes")
+    {
+        Mesh mesh;
+        mesh.Vertices.resize(3);
+        mesh.Indices = { 2, 1, 0 };
+
+        const MeshView view = mesh.GetView();
+
+        CHECK(view.IndexEncoding == IndexFormat::eUint32);
+        CHECK(view.GetIndexCount() == 3);
+        CHECK(view.GetIndiceSize() == 12);
+
+        Engine::u32 last = 0;
+        std::memcpy(&last, view.Indices.data() + 8, sizeof(last));
+        CHECK(last == 0);
+
+        std::memcpy(&last, view.Indices.data(), sizeof(last));
+        CHECK(last == 2);
+    }
+
+    TEST_CASE("Mesh::ComputeBounds centers the sphere on the bounding box")
+    {
+        Mesh mesh;
+        CHECK(mesh.ComputeBounds().Radius == 0.0f);
+
+        mesh.Vertices.resize(3);
+        mesh.Vertices[0].Position = glm::vec3(-1.0f, 0.0f, 2.0f);
+        mesh.Vertices[1].Position = glm::vec3(3.0f, 2.0f, 2.0f);
+        mesh.Vertices[2].Position = glm::vec3(1.0f, 4.0f, 0.0f);
+
+        const MeshBounds bounds = mesh.ComputeBounds();
+
+        CHECK(bounds.Min == glm::vec3(-1.0f, 0.0f, 0.0f));
+        CHECK(bounds.Max == glm::vec3(3.0f, 4.0f, 2.0f));
+        CHECK(bounds.Center == glm::vec3(1.0f, 2.0f, 1.0f));
+        CHECK(bounds.Radius == doctest::Approx(3.0f));
+
+        // Every vertex lies inside the sphere
+        for (const Vertex& vertex : mesh.Vertices)
+        {
+            CHECK(glm::distance(vertex.Position, bounds.Center) <= bounds.Radius + 1e-5f);
+        }
+    }
+
+    TEST_CASE("CanonicalizeVertex merges vertices which only differ in the sign of a zero")
+    {
+        const Vertex positive{ .Position = glm::vec3(0.0f, 1.0f, 0.0f),
+                               .Color    = glm::vec3(0.0f),
+                               .TexCoord = glm::vec2(0.0f, 0.5f) };
+        const Vertex negative{ .Position = glm::vec3(-0.0f, 1.0f, 0.0f),
+                               .Color    = glm::vec3(0.0f, -0.0f, 0.0f),
+                               .TexCoord = glm::vec2(-0.0f, 0.5f) };
+
+        REQUIRE(positive == negative);
+        CHECK_FALSE(VertexEqual{}(positive, negative));
+
+        Engine::Core::FlatHashMap<Vertex, Engine::u32, VertexHash, VertexEqual> uniqueVertices;
+        CHECK(uniqueVertices.FindOrInsert(CanonicalizeVertex(positive), 0).Inserted);
+        CHECK(uniqueVertices.FindOrInsert(CanonicalizeVertex(negative), 1).Entry == 0);
+        CHECK(uniqueVertices.GetSize() == 1);
+        CHECK_FALSE(std::signbit(CanonicalizeVertex(negative).Position.x));
+    }
+}
@@ -0,0 +1,156 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Graphics/Resources/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+    using Engine::u32;
+    using Engine::Graphics::Mesh;
+    using Engine::Graphics::MeshOptimizer;
+
+    // Regular grid of quads with rows of triangles in scanline order (poor vertex cache locality)
+    Mesh CreateGrid(u32 size)
+    {
+        Mesh mesh;
+
+        for (u32 y = 0; y <= size; y++)
+        {
+            for (u32 x = 0; x <= size; x++)
+            {
+                mesh.Vertices.push_back({ .Position = { (float)x, (float)y, 0.0f },
+                                          .Color    = { 1.0f, 1.0f, 1.0f },
+                                          .TexCoord = { (float)x / (float)size, (float)y / (float)size } });
+            }
+        }
+
+        for (u32 y = 0; y < size; y++)
+        {
+            for (u32 x = 0; x < size; x++)
+            {
+                const u32 a = (y * (size + 1)) + x;
+                const u32 b = a + 1;
+                const u32 c = a + size + 1;
+                const u32 d = c + 1;
+
+                mesh.Indices.insert(mesh.Indices.end(), { a, b, d, a, d, c });
+            }
+        }
+
+        return mesh;
+    }
+
+    // Triangles as sorted position triplets, independent of triangle order, rotation and vertex order
+    std::vector<std::array<float, 9>> GetTriangles(const Mesh& mesh)
+    {
+        std::vector<std::array<float, 9>> triangles;
+
+        for (size_t i = 0; i < mesh.Indices.size(); i += 3)
+        {
+            std::array<std::array<float, 3>, 3> corners{};
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                const auto& position = mesh.Vertices[mesh.Indices[i + corner]].Position;
+                corners[corner]      = { position.x, position.y, position.z };
+            }
+
+            // Rotate the smallest corner to the front to keep the winding intact
+            const auto minCorner = std::min_element(corners.begin(), corners.end());
+            std::rotate(corners.begin(), minCorner, corners.end());
+
+            triangles.push_back({ corners[0][0], corners[0][1], corners[0][2],
+                                  corners[1][0], corners[1][1], corners[1][2],
+                                  corners[2][0], corners[2][1], corners[2][2] });
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    TEST_CASE("MeshOptimizer::AnalyzeVertexCache counts misses of a FIFO cache")
+    {
+        const std::vector<u32> indices = { 0, 1, 2, 2, 1, 3, 0, 4, 5 };
+
+        const auto stats = MeshOptimizer::AnalyzeVertexCache(indices, 16);
+        CHECK(stats.TriangleCount == 3);
+        CHECK(stats.VertexCount == 6);
+        CHECK(stats.TransformedVertices == 6);
+        CHECK(stats.GetACMR() == doctest::Approx(2.0f));
+        CHECK(stats.GetATVR() == doctest::Approx(1.0f));
+
+        // Cache of 3 entries evicts vertex 0 before it's used again
+        const auto smallCache = MeshOptimizer::AnalyzeVertexCache(indices, 3);
+        CHECK(smallCache.TransformedVertices == 7);
+    }
+
+    TEST_CASE("MeshOptimizer::OptimizeVertexCache keeps all triangles and lowers the ACMR")
+    {
+        Mesh       mesh     = CreateGrid(64);
+        const auto original = GetTriangles(mesh);
+        const auto before   = MeshOptimizer::AnalyzeVertexCache(mesh.Indices);
+
+        MeshOptimizer::OptimizeVertexCache(mesh);
+
+        const auto after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices);
+        CHECK(GetTriangles(mesh) == original);
+        CHECK(after.GetACMR() < before.GetACMR());
+        CHECK(after.GetACMR() < 0.8f);
+    }
+
+    TEST_CASE("MeshOptimizer::OptimizeOverdraw keeps all triangles and most of the cache efficiency")
+    {
+        Mesh mesh = CreateGrid(64);
+        MeshOptimizer::OptimizeVertexCache(mesh);
+
+        const auto original = GetTriangles(mesh);
+        const auto before   = MeshOptimizer::AnalyzeVertexCache(mesh.Indices);
+
+        MeshOptimizer::OptimizeOverdraw(mesh);
+
+        const auto after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices);
+        CHECK(GetTriangles(mesh) == original);
+        CHECK(after.GetACMR() <= before.GetACMR() * MeshOptimizer::DEFAULT_OVERDRAW_THRESHOLD * 1.1f);
+    }
+
+    TEST_CASE("MeshOptimizer::OptimizeVertexFetch orders vertices by first use and drops unused ones")
+    {
+        Mesh mesh;
+        mesh.Vertices.resize(5);
+        for (u32 i = 0; i < mesh.Vertices.size(); i++)
+        {
+            mesh.Vertices[i].Position = { (float)i, 0.0f, 0.0f };
+        }
+        mesh.Indices = { 4, 2, 0, 0, 2, 3 };
+
+        MeshOptimizer::OptimizeVertexFetch(mesh);
+
+        REQUIRE(mesh.Vertices.size() == 4);
+        CHECK(mesh.Indices == std::vector<u32>{ 0, 1, 2, 2, 1, 3 });
+        CHECK(mesh.Vertices[0].Position.x == 4.0f);
+        CHECK(mesh.Vertices[1].Position.x == 2.0f);
+        CHECK(mesh.Vertices[2].Position.x == 0.0f);
+        CHECK(mesh.Vertices[3].Position.x == 3.0f);
+    }
+
+    TEST_CASE("MeshOptimizer::Optimize produces an equivalent mesh")
+    {
+        Mesh       mesh     = CreateGrid(32);
+        const auto original = GetTriangles(mesh);
+
+        MeshOptimizer::Optimize(mesh);
+
+        CHECK(GetTriangles(mesh) == original);
+        CHECK(mesh.Vertices.size() == 33 * 33);
+
+        // First-use order: every index is at most one larger than all previous ones
+        u32 next = 0;
+        for (const u32 index : mesh.Indices)
+        {
+            CHECK(index <= next);
+            next = std::max(next, index + 1);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Graphics/Resources/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace
+{
+    using Engine::f32;
+    using Engine::u32;
+    using Engine::Graphics::Mesh;
+    using Engine::Graphics::MeshSimplifier;
+
+    // Flat grid in the xy-plane with counter-clockwise triangles facing +z
+    Mesh CreateGrid(u32 size)
+    {
+        Mesh mesh;
+
+        for (u32 y = 0; y <= size; y++)
+        {
+            for (u32 x = 0; x <= size; x++)
+            {
+                mesh.Vertices.push_back({ .Position = { (f32)x, (f32)y, 0.0f },
+                                          .Color    = { 1.0f, 1.0f, 1.0f },
+                                          .TexCoord = { (f32)x / (f32)size, (f32)y / (f32)size } });
+            }
+        }
+
+        for (u32 y = 0; y < size; y++)
+        {
+            for (u32 x = 0; x < size; x++)
+            {
+                const u32 a = (y * (size + 1)) + x;
+                const u32 b = a + 1;
+                const u32 c = a + size + 1;
+                const u32 d = c + 1;
+
+                mesh.Indices.insert(mesh.Indices.end(), { a, b, d, a, d, c });
+            }
+        }
+
+        return mesh;
+    }
+
+    // Closed unit sphere with a single vertex at each pole
+    Mesh CreateSphere(u32 segments, u32 rings)
+    {
+        Mesh mesh;
+        mesh.Vertices.push_back({ .Position = { 0.0f, 0.0f, 1.0f }, .Color = {}, .TexCoord = {} });
+
+        for (u32 ring = 1; ring < rings; ring++)
+        {
+            const f32 theta = std::numbers::pi_v<f32> * (f32)ring / (f32)rings;
+
+            for (u32 segment = 0; segment < segments; segment++)
+            {
+                const f32 phi = 2.0f * std::numbers::pi_v<f32> * (f32)segment / (f32)segments;
+                mesh.Vertices.push_back({ .Position = { std::sin(theta) * std::cos(phi),
+                                                        std::sin(theta) * std::sin(phi),
+                                                        std::cos(theta) },
+                                          .Color    = {},
+                                          .TexCoord = {} });
+            }
+        }
+
+        mesh.Vertices.push_back({ .Position = { 0.0f, 0.0f, -1.0f }, .Color = {}, .TexCoord = {} });
+
+        const u32  south      = mesh.Vertices.size() - 1;
+        const auto ringVertex = [segments](u32 ring, u32 segment)
+        { return 1 + (ring * segments) + (segment % segments); };
+
+        for (u32 segment = 0; segment < segments; segment++)
+        {
+            mesh.Indices.insert(mesh.Indices.end(), { 0, ringVertex(0, segment), ringVertex(0, segment + 1) });
+            mesh.Indices.insert(mesh.Indices.end(),
+                                { south, ringVertex(rings - 2, segment + 1), ringVertex(rings - 2, segment) });
+        }
+
+        for (u32 ring = 0; ring + 2 < rings; ring++)
+        {
+            for (u32 segment = 0; segment < segments; segment++)
+            {
+                const u32 a = ringVertex(ring, segment);
+                const u32 b = ringVertex(ring, segment + 1);
+                const u32 c = ringVertex(ring + 1, segment);
+                const u32 d = ringVertex(ring + 1, segment + 1);
+
+                mesh.Indices.insert(mesh.Indices.end(), { a, c, d, a, d, b });
+            }
+        }
+
+        return mesh;
+    }
+
+    glm::vec3 GetNormal(const Mesh& mesh, const std::vector<u32>& indices, size_t triangle)
+    {
+        const glm::vec3& a = mesh.Vertices[indices[(triangle * 3) + 0]].Position;
+        const glm::vec3& b = mesh.Vertices[indices[(triangle * 3) + 1]].Position;
+        const glm::vec3& c = mesh.Vertices[indices[(triangle * 3) + 2]].Position;
+
+        return glm::cross(b - a, c - a);
+    }
+
+    TEST_CASE("MeshSimplifier::Simplify reduces a flat grid without error or flipped triangles")
+    {
+        const Mesh mesh   = CreateGrid(32);
+        const auto result = MeshSimplifier::Simplify(mesh.Vertices, mesh.Indices, mesh.Indices.size() / 4);
+
+        REQUIRE(!result.Indices.empty());
+        CHECK(result.Indices.size() <= mesh.Indices.size() / 4);
+        CHECK(result.Indices.size() % 3 == 0);
+        CHECK(result.Error == doctest::Approx(0.0f));
+
+        for (size_t triangle = 0; triangle < result.Indices.size() / 3; triangle++)
+        {
+            CHECK(GetNormal(mesh, result.Indices, triangle).z > 0.0f);
+        }
+
+        // Boundary constraints keep the corners of the grid in place
+        for (const u32 corner : { 0u, 32u, 33u * 32u, (33u * 33u) - 1 })
+        {
+            CHECK(std::find(result.Indices.begin(), result.Indices.end(), corner) != result.Indices.end());
+        }
+    }
+
+    TEST_CASE("MeshSimplifier::Simplify stops at the error limit")
+    {
+        const Mesh mesh = CreateSphere(32, 16);
+
+        const auto limited = MeshSimplifier::Simplify(mesh.Vertices, mesh.Indices, 0, 1e-4f);
+        CHECK(limited.Indices.size() == mesh.Indices.size());
+
+        const auto unlimited = MeshSimplifier::Simplify(mesh.Vertices, mesh.Indices, mesh.Indices.size() / 2);
+        CHECK(unlimited.Indices.size() <= mesh.Indices.size() / 2);
+        CHECK(unlimited.Error > 1e-4f);
+        CHECK(unlimited.Error < 0.1f);
+    }
+
+    TEST_CASE("MeshSimplifier::GenerateLods appends a chain of coarser levels")
+    {
+        Mesh      mesh       = CreateSphere(64, 32);
+        const u32 indexCount = mesh.Indices.size();
+
+        MeshSimplifier::GenerateLods(mesh);
+
+        REQUIRE(mesh.Lods.size() == MeshSimplifier::DEFAULT_LOD_RATIOS.size() + 1);
+        CHECK(mesh.Lods[0].IndexOffset == 0);
+        CHECK(mesh.Lods[0].IndexCount == indexCount);
+        CHECK(mesh.Lods[0].Error == 0.0f);
+
+        for (size_t i = 1; i < mesh.Lods.size(); i++)
+        {
+            const auto& lod      = mesh.Lods[i];
+            const auto& previous = mesh.Lods[i - 1];
+
+            CHECK(lod.IndexOffset == previous.IndexOffset + previous.IndexCount);
+            CHECK(lod.IndexCount < previous.IndexCount);
+            CHECK((f32)lod.IndexCount <= (f32)indexCount * MeshSimplifier::DEFAULT_LOD_RATIOS[i - 1] + 3.0f);
+            CHECK(lod.Error >= previous.Error);
+        }
+
+        const auto& last = mesh.Lods.back();
+        CHECK(mesh.Indices.size() == last.IndexOffset + last.IndexCount);
+        CHECK(std::all_of(mesh.Indices.begin(),
+                          mesh.Indices.end(),
+                          [&mesh](u32 index) { return index < mesh.Vertices.size(); }));
+
+        // The coarsest level still has to look like a sphere
+        for (u32 i = last.IndexOffset; i < last.IndexOffset + last.IndexCount; i++)
+        {
+            CHECK(glm::length(mesh.Vertices[mesh.Indices[i]].Position) == doctest::Approx(1.0f));
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/RangeAllocator.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Engine::u64;
+    using Engine::Core::RangeAllocation;
+    using Engine::Core::RangeAllocator;
+
+    TEST_CASE("RangeAllocator hands out consecutive ranges until it's full")
+    {
+        RangeAllocator allocator(100);
+
+        const RangeAllocation first  = allocator.Allocate(40);
+        const RangeAllocation second = allocator.Allocate(60);
+
+        CHECK(first.Offset == 0);
+        CHECK(second.Offset == 40);
+        CHECK(allocator.GetUsedSize() == 100);
+        CHECK_FALSE(allocator.Allocate(1).IsValid());
+    }
+
+    TEST_CASE("RangeAllocator respects non power of two alignments")
+    {
+        RangeAllocator allocator(1000);
+
+        CHECK(allocator.Allocate(5).Offset == 0);
+
+        const RangeAllocation aligned = allocator.Allocate(24, 24);
+        CHECK(aligned.Offset == 24);
+
+        // The gap in front of the aligned range stays usable
+        CHECK(allocator.Allocate(19).Offset == 5);
+    }
+
+    TEST_CASE("RangeAllocator falls back to a range that fits any alignment")
+    {
+        RangeAllocator allocator(100);
+
+        const RangeAllocation a = allocator.Allocate(3);
+        const RangeAllocation b = allocator.Allocate(11);
+        const RangeAllocation c = allocator.Allocate(10);
+        const RangeAllocation d = allocator.Allocate(20);
+        const RangeAllocation e = allocator.Allocate(56);
+
+        allocator.Free(b);
+        allocator.Free(d);
+
+        // The best fit at offset 3 runs out of space once its start is aligned to 8
+        CHECK(allocator.Allocate(10, 8).Offset == d.Offset);
+        CHECK(a.IsValid());
+        CHECK(c.IsValid());
+        CHECK(e.IsValid());
+    }
+
+    TEST_CASE("RangeAllocator picks the best fitting free range")
+    {
+        RangeAllocator allocator(100);
+
+        const RangeAllocation a = allocator.Allocate(30);
+        const RangeAllocation b = allocator.Allocate(10);
+        const RangeAllocation c = allocator.Allocate(10);
+        const RangeAllocation d = allocator.Allocate(10);
+
+        allocator.Free(a);
+        allocator.Free(c);
+
+        CHECK(allocator.Allocate(10).Offset == c.Offset);
+        CHECK(allocator.Allocate(20).Offset == a.Offset);
+        CHECK(b.IsValid());
+        CHECK(d.IsValid());
+    }
+
+    TEST_CASE("RangeAllocator merges neighboring free ranges")
+    {
+        RangeAllocator allocator(300);
+
+        const RangeAllocation a = allocator.Allocate(100);
+        const RangeAllocation b = allocator.Allocate(100);
+        const RangeAllocation c = allocator.Allocate(100);
+
+        allocator.Free(a);
+        allocator.Free(c);
+        CHECK(allocator.GetFreeRangeCount() == 2);
+
+        allocator.Free(b);
+        CHECK(allocator.GetFreeRangeCount() == 1);
+        CHECK(allocator.GetLargestFreeRange() == 300);
+        CHECK(allocator.GetUsedSize() == 0);
+    }
+
+    TEST_CASE("RangeAllocator never overlaps ranges under random allocations")
+    {
+        constexpr u64 CAPACITY = 1 << 16;
+
+        RangeAllocator               allocator(CAPACITY);
+        std::vector<RangeAllocation> live;
+        std::mt19937                 random(1234);
+
+        for (int i = 0; i < 5000; i++)
+        {
+            if (!live.empty() && random() % 3 == 0)
+            {
+                const size_t index = random() % live.size();
+                allocator.Free(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+                continue;
+            }
+
+            const u64             alignment  = 1 + (random() % 32);
+            const RangeAllocation allocation = allocator.Allocate(1 + (random() % 512), alignment);
+
+            if (allocation.IsValid())
+            {
+                CHECK(allocation.Offset % alignment == 0);
+                CHECK(allocation.Offset + allocation.Size <= CAPACITY);
+                live.push_back(allocation);
+            }
+        }
+
+        std::vector<bool> used(CAPACITY, false);
+        u64               usedSize = 0;
+
+        for (const auto& allocation : live)
+        {
+            for (u64 offset = allocation.Offset; offset < allocation.Offset + allocation.Size; offset++)
+            {
+                REQUIRE_FALSE(used[offset]);
+                used[offset] = true;
+            }
+            usedSize += allocation.Size;
+        }
+
+        CHECK(allocator.GetUsedSize() == usedSize);
+
+        for (const auto& allocation : live)
+        {
+            allocator.Free(allocation);
+        }
+
+        CHECK(allocator.GetFreeRangeCount() == 1);
+        CHECK(allocator.GetLargestFreeRange() == CAPACITY);
+    }
+}
@@ -0,0 +1,126 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/ResourcePool.hpp"
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Engine::u32;
+    using Engine::Core::Handle;
+    using Engine::Core::ResourcePool;
+
+    TEST_CASE("ResourcePool looks up created resources by handle")
+    {
+        ResourcePool<int> pool;
+
+        const Handle<int> a = pool.Create(10);
+        const Handle<int> b = pool.Create(20);
+
+        REQUIRE(pool.Get(a) != nullptr);
+        REQUIRE(pool.Get(b) != nullptr);
+        CHECK(*pool.Get(a) == 10);
+        CHECK(*pool.Get(b) == 20);
+        CHECK(pool.GetSize() == 2);
+        CHECK(pool.Get(Handle<int>{}) == nullptr);
+    }
+
+    TEST_CASE("ResourcePool detects stale handles after a slot got reused")
+    {
+        ResourcePool<int> pool;
+
+        const Handle<int> stale = pool.Create(1);
+        CHECK(pool.Remove(stale) == 1);
+
+        const Handle<int> reused = pool.Create(2);
+
+        CHECK(reused.Index == stale.Index);
+        CHECK(reused.Generation != stale.Generation);
+        CHECK_FALSE(pool.Contains(stale));
+        CHECK(pool.Get(stale) == nullptr);
+        CHECK(*pool.Get(reused) == 2);
+        CHECK(pool.GetSlotCount() == 1);
+    }
+
+    TEST_CASE("ResourcePool keeps resources dense when removing from the middle")
+    {
+        ResourcePool<int> pool;
+
+        const Handle<int> a = pool.Create(1);
+        const Handle<int> b = pool.Create(2);
+        const Handle<int> c = pool.Create(3);
+
+        CHECK(pool.Remove(a) == 1);
+
+        // The last resource moved into the gap, its handle still resolves
+        CHECK(*pool.Get(c) == 3);
+        CHECK(*pool.Get(b) == 2);
+        CHECK(pool.GetHandle(0) == c);
+
+        int sum = 0;
+        for (const int value : pool)
+        {
+            sum += value;
+        }
+        CHECK(sum == 5);
+    }
+
+    TEST_CASE("ResourcePool stores move-only resources")
+    {
+        ResourcePool<std::unique_ptr<int>> pool;
+
+        const auto first  = pool.Create(std::make_unique<int>(42));
+        const auto second = pool.Create(std::make_unique<int>(7));
+
+        std::unique_ptr<int> removed = pool.Remove(first);
+        CHECK(*removed == 42);
+        CHECK(**pool.Get(second) == 7);
+        CHECK(pool.GetSize() == 1);
+    }
+
+    TEST_CASE("ResourcePool matches a reference map under random creates and removes")
+    {
+        ResourcePool<u32>            pool;
+        std::vector<Handle<u32>>     live;
+        std::vector<Handle<u32>>     dead;
+        std::unordered_map<u32, u32> expected; // Slot index -> value
+        std::mt19937                 random(1234);
+
+        for (u32 i = 0; i < 20000; i++)
+        {
+            if (!live.empty() && random() % 2 == 0)
+            {
+                const size_t index  = random() % live.size();
+                const auto   handle = live[index];
+
+                REQUIRE(pool.Remove(handle) == expected[handle.Index]);
+                expected.erase(handle.Index);
+
+                dead.push_back(handle);
+                live[index] = live.back();
+                live.pop_back();
+                continue;
+            }
+
+            const Handle<u32> handle = pool.Create(i);
+            expected[handle.Index]   = i;
+            live.push_back(handle);
+        }
+
+        CHECK(pool.GetSize() == live.size());
+
+        for (const auto& handle : live)
+        {
+            REQUIRE(pool.Get(handle) != nullptr);
+            CHECK(*pool.Get(handle) == expected[handle.Index]);
+        }
+
+        for (const auto& handle : dead)
+        {
+            CHECK_FALSE(pool.Contains(handle));
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Core/RingAllocator.hpp"
+
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Engine::u64;
+    using Engine::Core::RangeAllocation;
+    using Engine::Core::RingAllocator;
+
+    TEST_CASE("RingAllocator hands out consecutive ranges until it's full")
+    {
+        RingAllocator ring(100);
+
+        CHECK(ring.Allocate(40).Offset == 0);
+        CHECK(ring.Allocate(60).Offset == 40);
+        CHECK(ring.GetUsedSize() == 100);
+        CHECK_FALSE(ring.Allocate(1).IsValid());
+    }
+
+    TEST_CASE("RingAllocator only releases regions whose fence completed")
+    {
+        RingAllocator ring(100);
+
+        CHECK(ring.Allocate(50).IsValid());
+        ring.Close(1);
+        CHECK(ring.Allocate(50).IsValid());
+        ring.Close(2);
+
+        CHECK(ring.GetPendingRegionCount() == 2);
+        CHECK(ring.GetOldestFence() == 1);
+
+        ring.Release(1);
+        CHECK(ring.GetUsedSize() == 50);
+        CHECK(ring.Allocate(50).Offset == 0);
+
+        // Open allocations stay in use no matter which fence completed
+        ring.Release(2);
+        CHECK(ring.GetUsedSize() == 50);
+        CHECK(ring.GetOpenSize() == 50);
+    }
+
+    TEST_CASE("RingAllocator wraps around and counts the skipped tail as used")
+    {
+        RingAllocator ring(100);
+
+        CHECK(ring.Allocate(40).IsValid());
+        ring.Close(1);
+        CHECK(ring.Allocate(40).IsValid());
+        ring.Close(2);
+        ring.Release(1);
+
+        // Doesn't fit in front of the end anymore
+        const RangeAllocation wrapped = ring.Allocate(30);
+        CHECK(wrapped.Offset == 0);
+        CHECK(ring.GetUsedSize() == 40 + 20 + 30);
+
+        // The tail blocks the space behind the wrapped allocation
+        CHECK_FALSE(ring.Allocate(20).IsValid());
+
+        ring.Close(3);
+        ring.Release(3);
+        CHECK(ring.GetUsedSize() == 0);
+        CHECK(ring.Allocate(100).Offset == 0);
+    }
+
+    TEST_CASE("RingAllocator respects alignments")
+    {
+        RingAllocator ring(256);
+
+        CHECK(ring.Allocate(3).Offset == 0);
+        CHECK(ring.Allocate(8, 16).Offset == 16);
+        CHECK(ring.Allocate(1, 12).Offset == 24);
+        CHECK(ring.GetUsedSize() == 25);
+    }
+
+    TEST_CASE("RingAllocator never overlaps live ranges under random allocations")
+    {
+        constexpr u64 CAPACITY = 4096;
+
+        RingAllocator                            ring(CAPACITY);
+        std::deque<std::vector<RangeAllocation>> closed;
+        std::vector<RangeAllocation>             open;
+        std::mt19937                             random(1234);
+        u64                                      fence = 0;
+
+        const auto hasOverlaps = [&]()
+        {
+            std::vector<bool> used(CAPACITY, false);
+            bool              overlaps = false;
+
+            const auto mark = [&](const RangeAllocation& allocation)
+            {
+                for (u64 offset = allocation.Offset; offset < allocation.Offset + allocation.Size; offset++)
+                {
+                    overlaps |= used[offset];
+                    used[offset] = true;
+                }
+            };
+
+            for (const auto& region : closed)
+            {
+                for (const auto& allocation : region)
+                {
+                    mark(allocation);
+                }
+            }
+
+            for (const auto& allocation : open)
+            {
+                mark(allocation);
+            }
+
+            return overlaps;
+        };
+
+        for (int i = 0; i < 5000; i++)
+        {
+            const u64             alignment  = 1 + (random() % 16);
+            const RangeAllocation allocation = ring.Allocate(1 + (random() % 300), alignment);
+
+            if (allocation.IsValid())
+            {
+                CHECK(allocation.Offset % alignment == 0);
+                CHECK(allocation.Offset + allocation.Size <= CAPACITY);
+                open.push_back(allocation);
+            }
+
+            // Submit every few allocations and let the oldest submissions finish in order
+            if (random() % 4 == 0 || !allocation.IsValid())
+            {
+                ring.Close(++fence);
+                if (!open.empty())
+                {
+                    closed.push_back(std::move(open));
+                    open.clear();
+                }
+            }
+
+            if (!closed.empty() && random() % 3 == 0)
+            {
+                ring.Release(ring.GetOldestFence());
+                closed.pop_front();
+            }
+
+            REQUIRE_FALSE(hasOverlaps());
+        }
+
+        ring.Close(++fence);
+        ring.Release(fence);
+        CHECK(ring.GetUsedSize() == 0);
+        CHECK(ring.GetPendingRegionCount() == 0);
+    }
+}
@@ -0,0 +1,153 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Graphics/Resources/ShaderReflection.hpp"
+
+#include <initializer_list>
+#include <vector>
+
+namespace
+{
+    using Engine::u16;
+    using Engine::u32;
+    using Engine::Graphics::ShaderReflection;
+
+    // Assembles SPIR-V by hand, ids have to stay below the bound in the header
+    struct SpirvBuilder
+    {
+        std::vector<u32> Code = { 0x07230203, 0x00010000, 0, 64, 0 };
+
+        void Op(u16 opcode, std::initializer_list<u32> operands)
+        {
+            Code.push_back(((u32)(operands.size() + 1) << 16) | opcode);
+            Code.insert(Code.end(), operands);
+        }
+    };
+
+    // Equivalent of:
+    //   layout(set = 0, binding = 0) uniform Globals { mat4 view; mat4 proj; };
+    //   layout(set = 0, binding = 1) buffer Objects { vec4 objects[]; };
+    //   layout(set = 1, binding = 2) uniform sampler2D textures[4];
+    //   layout(push_constant) uniform Constants { vec4 color; uint index; };
+    std::vector<u32> MakeShader()
+    {
+        SpirvBuilder spirv;
+
+        // Decorations
+        spirv.Op(71, { 4, 2 });            // Globals: Block
+        spirv.Op(72, { 4, 0, 35, 0 });     // Globals.view: Offset 0
+        spirv.Op(72, { 4, 0, 7, 16 });     // Globals.view: MatrixStride 16
+        spirv.Op(72, { 4, 1, 35, 64 });    // Globals.proj: Offset 64
+        spirv.Op(72, { 4, 1, 7, 16 });     // Globals.proj: MatrixStride 16
+        spirv.Op(71, { 6, 34, 0 });        // globals: DescriptorSet 0
+        spirv.Op(71, { 6, 33, 0 });        // globals: Binding 0
+        spirv.Op(71, { 13, 34, 1 });       // textures: DescriptorSet 1
+        spirv.Op(71, { 13, 33, 2 });       // textures: Binding 2
+        spirv.Op(72, { 14, 0, 35, 0 });    // Constants.color: Offset 0
+        spirv.Op(72, { 14, 1, 35, 16 });   // Constants.index: Offset 16
+        spirv.Op(71, { 17, 6, 16 });       // vec4[]: ArrayStride 16
+        spirv.Op(72, { 18, 0, 35, 0 });    // Objects.objects: Offset 0
+        spirv.Op(71, { 20, 34, 0 });       // objects: DescriptorSet 0
+        spirv.Op(71, { 20, 33, 1 });       // objects: Binding 1
+
+        // Types and variables
+        spirv.Op(22, { 1, 32 });                    // float
+        spirv.Op(23, { 2, 1, 4 });                  // vec4
+        spirv.Op(24, { 3, 2, 4 });                  // mat4
+        spirv.Op(30, { 4, 3, 3 });                  // struct Globals
+        spirv.Op(32, { 5, 2, 4 });                  // Uniform pointer to Globals
+        spirv.Op(59, { 5, 6, 2 });                  // globals
+        spirv.Op(25, { 7, 1, 1, 0, 0, 0, 1, 0 });   // 2D sampled image
+        spirv.Op(27, { 8, 7 });                     // sampler2D
+        spirv.Op(21, { 9, 32, 0 });                 // uint
+        spirv.Op(43, { 9, 10, 4 });                 // 4u
+        spirv.Op(28, { 11, 8, 10 });                // sampler2D[4]
+        spirv.Op(32, { 12, 0, 11 });                // UniformConstant pointer to sampler2D[4]
+        spirv.Op(59, { 12, 13, 0 });                // textures
+        spirv.Op(30, { 14, 2, 9 });                 // struct Constants
+        spirv.Op(32, { 15, 9, 14 });                // PushConstant pointer to Constants
+        spirv.Op(59, { 15, 16, 9 });                // constants
+        spirv.Op(29, { 17, 2 });                    // vec4[]
+        spirv.Op(30, { 18, 17 });                   // struct Objects
+        spirv.Op(32, { 19, 12, 18 });               // StorageBuffer pointer to Objects
+        spirv.Op(59, { 19, 20, 12 });               // objects
+
+        return spirv.Code;
+    }
+
+    TEST_CASE("ShaderReflection::Reflect finds descriptor sets, arrays and push constants")
+    {
+        const ShaderReflection reflection = ShaderReflection::Reflect(MakeShader(), vk::ShaderStageFlagBits::eVertex);
+
+        REQUIRE(reflection.Sets.size() == 2);
+        REQUIRE(reflection.Sets[0].size() == 2);
+        REQUIRE(reflection.Sets[1].size() == 1);
+
+        CHECK(reflection.Sets[0][0].binding == 0);
+        CHECK(reflection.Sets[0][0].descriptorType == vk::DescriptorType::eUniformBuffer);
+        CHECK(reflection.Sets[0][0].descriptorCount == 1);
+        CHECK(reflection.Sets[0][0].stageFlags == vk::ShaderStageFlags(vk::ShaderStageFlagBits::eVertex));
+
+        CHECK(reflection.Sets[0][1].binding == 1);
+        CHECK(reflection.Sets[0][1].descriptorType == vk::DescriptorType::eStorageBuffer);
+
+        CHECK(reflection.Sets[1][0].binding == 2);
+        CHECK(reflection.Sets[1][0].descriptorType == vk::DescriptorType::eCombinedImageSampler);
+        CHECK(reflection.Sets[1][0].descriptorCount == 4);
+
+        REQUIRE(reflection.PushConstantRanges.size() == 1);
+        CHECK(reflection.PushConstantRanges[0].offset == 0);
+        CHECK(reflection.PushConstantRanges[0].size == 20);
+    }
+
+    TEST_CASE("ShaderReflection::Merge combines the stages of shared bindings and push constants")
+    {
+        ShaderReflection reflection = ShaderReflection::Reflect(MakeShader(), vk::ShaderStageFlagBits::eVertex);
+        reflection.Merge(ShaderReflection::Reflect(MakeShader(), vk::ShaderStageFlagBits::eFragment));
+
+        const vk::ShaderStageFlags bothStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+        REQUIRE(reflection.Sets.size() == 2);
+        CHECK(reflection.Sets[0].size() == 2);
+        CHECK(reflection.Sets[0][0].stageFlags == bothStages);
+        CHECK(reflection.Sets[1][0].stageFlags == bothStages);
+
+        REQUIRE(reflection.PushConstantRanges.size() == 1);
+        CHECK(reflection.PushConstantRanges[0].stageFlags == bothStages);
+    }
+
+    TEST_CASE("ShaderReflection::MakeDynamic only turns existing buffers dynamic")
+    {
+        ShaderReflection reflection = ShaderReflection::Reflect(MakeShader(), vk::ShaderStageFlagBits::eVertex);
+
+        reflection.MakeDynamic(0, 0);
+        reflection.MakeDynamic(0, 1);
+        reflection.MakeDynamic(1, 2);
+        reflection.MakeDynamic(5, 0);
+
+        CHECK(reflection.FindBinding(0, 0)->descriptorType == vk::DescriptorType::eUniformBufferDynamic);
+        CHECK(reflection.FindBinding(0, 1)->descriptorType == vk::DescriptorType::eStorageBufferDynamic);
+        CHECK(reflection.FindBinding(1, 2)->descriptorType == vk::DescriptorType::eCombinedImageSampler);
+        CHECK(reflection.FindBinding(1, 0) == nullptr);
+        CHECK(reflection.Sets.size() == 2);
+    }
+
+    TEST_CASE("ShaderReflection::Reflect starts push constant ranges at the first member")
+    {
+        // layout(push_constant) uniform Constants { layout(offset = 16) vec4 color; };
+        SpirvBuilder spirv;
+        spirv.Op(72, { 3, 0, 35, 16 });
+        spirv.Op(22, { 1, 32 });
+        spirv.Op(23, { 2, 1, 4 });
+        spirv.Op(30, { 3, 2 });
+        spirv.Op(32, { 4, 9, 3 });
+        spirv.Op(59, { 4, 5, 9 });
+
+        const ShaderReflection reflection =
+            ShaderReflection::Reflect(spirv.Code, vk::ShaderStageFlagBits::eFragment);
+
+        CHECK(reflection.Sets.empty());
+        REQUIRE(reflection.PushConstantRanges.size() == 1);
+        CHECK(reflection.PushConstantRanges[0].offset == 16);
+        CHECK(reflection.PushConstantRanges[0].size == 16);
+    }
+}
@@ -0,0 +1,87 @@
+#include "Vendor/doctest/doctest.hpp"
+
+#include "Graphics/Resources/VertexLayout.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using namespace Engine::Graphics;
+
+    const std::vector<Vertex> VERTICES = {
+        { .Position = { -4.0f, 2.0f, 10.0f }, .Color = { 1.0f, 0.0f, 0.5f }, .TexCoord = { 0.0f, 1.0f } },
+        { .Position = { 6.0f, -3.0f, 0.0f }, .Color = { 0.0f, 1.0f, 0.25f }, .TexCoord = { 2.5f, -1.0f } },
+        { .Position = { 1.0f, 0.5f, 5.0f }, .Color = { 0.2f, 0.4f, 0.6f }, .TexCoord = { 0.5f, 0.5f } }
+    };
+
+    TEST_CASE("VertexLayout generates matching attribute descriptions")
+    {
+        constexpr auto full    = FullVertexLayout::GetAttributeDescriptions();
+        constexpr auto compact = CompactVertexLayout::GetAttributeDescriptions();
+
+        static_assert(FullVertexLayout::GetBindingDescription().stride == 32);
+        static_assert(CompactVertexLayout::GetBindingDescription().stride == 16);
+
+        CHECK(full[0].offset == offsetof(Vertex, Position));
+        CHECK(full[1].offset == offsetof(Vertex, Color));
+        CHECK(full[2].offset == offsetof(Vertex, TexCoord));
+
+        CHECK(compact[0].format == vk::Format::eR16G16B16A16Unorm);
+        CHECK(compact[1].format == vk::Format::eR8G8B8A8Unorm);
+        CHECK(compact[2].format == vk::Format::eR16G16Sfloat);
+        CHECK(compact[1].offset == 8);
+        CHECK(compact[2].offset == 12);
+    }
+
+    TEST_CASE("Full vertex format is bit-identical to Vertex")
+    {
+        const EncodedVertices encoded = EncodeVertices(VertexFormat::eFull, VERTICES);
+
+        REQUIRE(encoded.Data.size() == VERTICES.size() * sizeof(Vertex));
+        CHECK(std::memcmp(encoded.Data.data(), VERTICES.data(), encoded.Data.size()) == 0);
+        CHECK(encoded.Dequantization.Offset == glm::vec4(0.0f));
+        CHECK(encoded.Dequantization.Scale == glm::vec4(1.0f));
+    }
+
+    TEST_CASE("Compact vertex format dequantizes close to the original positions")
+    {
+        const EncodedVertices encoded = EncodeVertices(VertexFormat::eCompact, VERTICES);
+        REQUIRE(encoded.Data.size() == VERTICES.size() * CompactVertexLayout::STRIDE);
+
+        for (size_t i = 0; i < VERTICES.size(); i++)
+        {
+            CompactVertexLayout::Data data{};
+            std::memcpy(&data, encoded.Data.data() + (i * CompactVertexLayout::STRIDE), sizeof(data));
+
+            const glm::vec3 normalized = glm::vec3(data.Position) / 65535.0f;
+            const glm::vec3 position   = glm::vec3(encoded.Dequantization.Offset)
+                                       + (glm::vec3(encoded.Dequantization.Scale) * normalized);
+
+            // Bounding box is at most 10 units wide, so 16 bits give an error below 1e-3
+            CHECK(glm::all(glm::lessThan(glm::abs(position - VERTICES[i].Position), glm::vec3(1e-3f))));
+            CHECK(glm::unpackHalf1x16(data.TexCoord.x) == doctest::Approx(VERTICES[i].TexCoord.x));
+            CHECK(data.Color.a == 255);
+        }
+    }
+
+    TEST_CASE("Half vertex format keeps positions around the bounding box center")
+    {
+        const EncodedVertices encoded = EncodeVertices(VertexFormat::eHalf, VERTICES);
+
+        for (size_t i = 0; i < VERTICES.size(); i++)
+        {
+            HalfVertexLayout::Data data{};
+            std::memcpy(&data, encoded.Data.data() + (i * HalfVertexLayout::STRIDE), sizeof(data));
+
+            const glm::vec3 decoded(glm::unpackHalf1x16(data.Position.x),
+                                    glm::unpackHalf1x16(data.Position.y),
+                                    glm::unpackHalf1x16(data.Position.z));
+            const glm::vec3 position = glm::vec3(encoded.Dequantization.Offset)
+                                     + (glm::vec3(encoded.Dequantization.Scale) * decoded);
+
+            CHECK(glm::all(glm::lessThanEqual(glm::abs(decoded), glm::vec3(1.0f))));
+            CHECK(glm::all(glm::lessThan(glm::abs(position - VERTICES[i].Position), glm::vec3(1e-2f))));
+        }
+    }
+}